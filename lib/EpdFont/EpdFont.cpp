@@ -1,8 +1,45 @@
 #include "EpdFont.h"
 
+#include <HardwareSerial.h>
 #include <Utf8.h>
+#include <miniz.h>
 
 #include <algorithm>
+#include <cstring>
+
+#include "EpdGlyphCache.h"
+
+namespace {
+
+// Italic shear, in pixels of horizontal shift per pixel of height above the baseline
+constexpr int ITALIC_SLANT_NUM = 1;
+constexpr int ITALIC_SLANT_DEN = 4;
+
+// Shift of a glyph row under the italic shear, rounded down so rows below the baseline go left
+int italicShift(const EpdGlyph* glyph, const int row) {
+  const int heightAboveBaseline = glyph->top - 1 - row;
+  const int scaled = heightAboveBaseline * ITALIC_SLANT_NUM;
+  return scaled >= 0 ? scaled / ITALIC_SLANT_DEN : -((-scaled + ITALIC_SLANT_DEN - 1) / ITALIC_SLANT_DEN);
+}
+
+uint8_t readPixel(const uint8_t* bitmap, const bool is2Bit, const int index) {
+  if (is2Bit) {
+    return (bitmap[index >> 2] >> ((3 - (index & 3)) * 2)) & 0x3;
+  }
+  return (bitmap[index >> 3] >> (7 - (index & 7))) & 0x1;
+}
+
+void writePixel(uint8_t* bitmap, const bool is2Bit, const int index, const uint8_t value) {
+  if (is2Bit) {
+    bitmap[index >> 2] |= value << ((3 - (index & 3)) * 2);
+  } else {
+    bitmap[index >> 3] |= value << (7 - (index & 7));
+  }
+}
+
+}  // namespace
+
+EpdFont::~EpdFont() { delete glyphCache; }
 
 void EpdFont::getTextBounds(const char* string, const int startX, const int startY, int* minX, int* minY, int* maxX,
                             int* maxY) const {
@@ -30,11 +67,17 @@ void EpdFont::getTextBounds(const char* string, const int startX, const int star
       continue;
     }
 
-    *minX = std::min(*minX, cursorX + glyph->left);
-    *maxX = std::max(*maxX, cursorX + glyph->left + glyph->width);
+    int left = glyph->left;
+    int width = glyph->width;
+    if (synthesis) {
+      getGlyphBox(glyph, &left, &width);
+    }
+
+    *minX = std::min(*minX, cursorX + left);
+    *maxX = std::max(*maxX, cursorX + left + width);
     *minY = std::min(*minY, cursorY + glyph->top - glyph->height);
     *maxY = std::max(*maxY, cursorY + glyph->top);
-    cursorX += glyph->advanceX;
+    cursorX += getAdvanceX(glyph);
   }
 }
 
@@ -82,3 +125,143 @@ const EpdGlyph* EpdFont::getGlyph(const uint32_t cp) const {
 
   return nullptr;
 }
+
+void EpdFont::getGlyphBox(const EpdGlyph* glyph, int* left, int* width) const {
+  *left = glyph->left;
+  *width = glyph->width;
+  if (glyph->width == 0 || glyph->height == 0) {
+    return;
+  }
+  if (synthesis & SYNTH_ITALIC) {
+    // Top row moves furthest right, bottom row furthest left
+    const int minShift = italicShift(glyph, glyph->height - 1);
+    *left += minShift;
+    *width += italicShift(glyph, 0) - minShift;
+  }
+  if (synthesis & SYNTH_BOLD) {
+    *width += 1;
+  }
+}
+
+bool EpdFont::synthesizeGlyph(const EpdGlyph* glyph, uint8_t* out, const size_t outSize) const {
+  int left, width;
+  getGlyphBox(glyph, &left, &width);
+  const int height = glyph->height;
+  const bool is2Bit = data->is2Bit;
+  const size_t pixels = static_cast<size_t>(width) * height;
+  const size_t bytes = is2Bit ? (pixels + 3) / 4 : (pixels + 7) / 8;
+  if (bytes > outSize) {
+    return false;
+  }
+  memset(out, 0, bytes);
+
+  const uint8_t* bitmap = getGlyphBitmap(glyph);
+  if (!bitmap) {
+    return false;
+  }
+  const bool bold = synthesis & SYNTH_BOLD;
+  const int minShift = (synthesis & SYNTH_ITALIC) ? italicShift(glyph, height - 1) : 0;
+  for (int y = 0; y < height; y++) {
+    const int shift = ((synthesis & SYNTH_ITALIC) ? italicShift(glyph, y) : 0) - minShift;
+    const int srcRow = y * glyph->width;
+    const int dstRow = y * width + shift;
+    uint8_t previous = 0;
+    for (int x = 0; x < glyph->width; x++) {
+      const uint8_t value = readPixel(bitmap, is2Bit, srcRow + x);
+      // Emboldening keeps the darker of each pixel and its left neighbour
+      const uint8_t drawn = bold ? std::max(value, previous) : value;
+      if (drawn) {
+        writePixel(out, is2Bit, dstRow + x, drawn);
+      }
+      previous = value;
+    }
+    if (bold && previous) {
+      writePixel(out, is2Bit, dstRow + glyph->width, previous);
+    }
+  }
+  return true;
+}
+
+bool EpdFont::initGlyphCache() const {
+  const EpdUnicodeInterval& lastInterval = data->intervals[data->intervalCount - 1];
+  const uint32_t glyphCount = lastInterval.offset + (lastInterval.last - lastInterval.first + 1);
+  size_t slotSize = 1;
+  for (uint32_t i = 0; i < glyphCount; i++) {
+    slotSize = std::max<size_t>(slotSize, data->glyph[i].dataLength);
+  }
+
+  size_t blockSize = 1;
+  for (uint32_t i = 0; i < data->groupCount; i++) {
+    blockSize = std::max<size_t>(blockSize, data->groups[i].uncompressedSize);
+  }
+
+  const size_t slotCount = std::max<size_t>(MIN_GLYPH_CACHE_SLOTS, GLYPH_CACHE_BYTES / slotSize);
+  glyphCache = new EpdGlyphCache(slotSize, static_cast<uint16_t>(std::min<size_t>(slotCount, UINT16_MAX - 1)),
+                                 blockSize);
+  if (!glyphCache->isValid()) {
+    Serial.printf("[%lu] [FNT] Failed to allocate glyph cache (%u byte slots)\n", millis(),
+                  static_cast<unsigned>(slotSize));
+    delete glyphCache;
+    glyphCache = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool EpdFont::inflateBlock(const uint32_t blockIndex) const {
+  const EpdGlyphGroup& group = data->groups[blockIndex];
+  tinfl_decompressor* inflator = glyphCache->getInflator();
+  tinfl_init(inflator);
+
+  size_t inBytes = group.compressedSize;
+  size_t outBytes = group.uncompressedSize;
+  const tinfl_status status =
+      tinfl_decompress(inflator, &data->bitmap[group.compressedOffset], &inBytes, glyphCache->getBlock(),
+                       glyphCache->getBlock(), &outBytes, TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF);
+
+  if (status != TINFL_STATUS_DONE || outBytes != group.uncompressedSize) {
+    Serial.printf("[%lu] [FNT] Failed to inflate glyph block %lu (status %d)\n", millis(),
+                  static_cast<unsigned long>(blockIndex), status);
+    glyphCache->blockIndex = EpdGlyphCache::NO_BLOCK;
+    return false;
+  }
+  glyphCache->blockIndex = blockIndex;
+  glyphCache->blockInflates++;
+  return true;
+}
+
+const uint8_t* EpdFont::getGlyphBitmap(const EpdGlyph* glyph) const {
+  if (bitmapSource) {
+    return bitmapSource->getGlyphBitmap(glyph);
+  }
+  if (!data->groups) {
+    return &data->bitmap[glyph->dataOffset];
+  }
+  if (!glyphCache && !initGlyphCache()) {
+    return nullptr;
+  }
+
+  const auto glyphIndex = static_cast<uint32_t>(glyph - data->glyph);
+  if (const uint8_t* cached = glyphCache->find(glyphIndex)) {
+    return cached;
+  }
+
+  // Last block starting at or before the glyph
+  uint32_t low = 0;
+  uint32_t high = data->groupCount;
+  while (high - low > 1) {
+    const uint32_t mid = low + (high - low) / 2;
+    if (data->groups[mid].firstGlyph <= glyphIndex) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+
+  if (glyphCache->blockIndex != low && !inflateBlock(low)) {
+    return nullptr;
+  }
+  uint8_t* slot = glyphCache->insert(glyphIndex);
+  memcpy(slot, glyphCache->getBlock() + glyph->dataOffset, glyph->dataLength);
+  return slot;
+}
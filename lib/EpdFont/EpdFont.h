@@ -1,15 +1,64 @@
 #pragma once
+#include <cstddef>
+
 #include "EpdFontData.h"
 
+class EpdGlyphCache;
+
 class EpdFont {
+  // Inflated glyphs of compressed fonts, allocated on the first bitmap lookup
+  mutable EpdGlyphCache* glyphCache = nullptr;
+
   void getTextBounds(const char* string, int startX, int startY, int* minX, int* minY, int* maxX, int* maxY) const;
+  bool initGlyphCache() const;
+  bool inflateBlock(uint32_t blockIndex) const;
 
  public:
+  // Styles drawn from another face's bitmaps at blit time instead of shipping their own
+  enum Synthesis : uint8_t {
+    SYNTH_NONE = 0,
+    SYNTH_BOLD = 1,    // Every row smeared one pixel to the right
+    SYNTH_ITALIC = 2,  // Rows sheared right by a quarter pixel per pixel above the baseline
+  };
+
+  // RAM budget of the inflated glyph cache of a compressed font
+  static constexpr size_t GLYPH_CACHE_BYTES = 8 * 1024;
+  static constexpr uint16_t MIN_GLYPH_CACHE_SLOTS = 16;
+
+  // Supplies glyph bitmaps of fonts whose bitmaps are not in memory, e.g. fonts loaded from the SD card
+  class BitmapSource {
+   public:
+    // Same contract as getGlyphBitmap
+    virtual const uint8_t* getGlyphBitmap(const EpdGlyph* glyph) = 0;
+
+   protected:
+    ~BitmapSource() = default;
+  };
+
   const EpdFontData* data;
-  explicit EpdFont(const EpdFontData* data) : data(data) {}
-  ~EpdFont() = default;
+  uint8_t synthesis;
+  BitmapSource* bitmapSource = nullptr;
+  explicit EpdFont(const EpdFontData* data, const uint8_t synthesis = SYNTH_NONE) : data(data), synthesis(synthesis) {}
+  EpdFont(const EpdFontData* data, BitmapSource* bitmapSource, const uint8_t synthesis = SYNTH_NONE)
+      : data(data), synthesis(synthesis), bitmapSource(bitmapSource) {}
+  ~EpdFont();
+  EpdFont(const EpdFont&) = delete;
+  EpdFont& operator=(const EpdFont&) = delete;
   void getTextDimensions(const char* string, int* w, int* h) const;
   bool hasPrintableChars(const char* string) const;
 
   const EpdGlyph* getGlyph(uint32_t cp) const;
+  // Packed bitmap of glyph. Compressed fonts inflate it into the glyph cache, the pointer then stays valid until the
+  // next lookup on this font. Returns nullptr if the glyph could not be inflated.
+  const uint8_t* getGlyphBitmap(const EpdGlyph* glyph) const;
+  // Glyph cache counters, nullptr until a compressed font drew its first glyph
+  const EpdGlyphCache* getGlyphCache() const { return glyphCache; }
+
+  // Glyph metrics as drawn by this font, synthesized styles included
+  int getAdvanceX(const EpdGlyph* glyph) const { return glyph->advanceX + ((synthesis & SYNTH_BOLD) ? 1 : 0); }
+  void getGlyphBox(const EpdGlyph* glyph, int* left, int* width) const;
+
+  // Renders the synthesized bitmap of glyph into out, packed like the font's own bitmaps and getGlyphBox wide.
+  // Returns false if it does not fit in outSize bytes.
+  bool synthesizeGlyph(const EpdGlyph* glyph, uint8_t* out, size_t outSize) const;
 };
@@ -22,6 +22,14 @@ typedef struct {
   uint32_t offset;  ///< Index of the first code point into the glyph array
 } EpdUnicodeInterval;
 
+/// Compressed bitmap block: consecutive glyphs deflated together
+typedef struct {
+  uint32_t compressedOffset;  ///< Offset of the raw deflate stream into EpdFont->bitmap
+  uint32_t compressedSize;    ///< Size of the deflate stream
+  uint32_t uncompressedSize;  ///< Size of the inflated block, glyph dataOffsets are relative to its start
+  uint32_t firstGlyph;        ///< Index of the first glyph in the block
+} EpdGlyphGroup;
+
 /// Data stored for FONT AS A WHOLE
 typedef struct {
   const uint8_t* bitmap;                ///< Glyph bitmaps, concatenated
@@ -32,4 +40,6 @@ typedef struct {
   int ascender;                         ///< Maximal height of a glyph above the base line
   int descender;                        ///< Maximal height of a glyph below the base line
   bool is2Bit;
+  const EpdGlyphGroup* groups = nullptr;  ///< Compressed blocks, nullptr when bitmaps are stored uncompressed
+  uint32_t groupCount = 0;                ///< Number of compressed blocks
 } EpdFontData;
@@ -0,0 +1,135 @@
+#include "EpdGlyphCache.h"
+
+#include <miniz.h>
+
+#include <cstdlib>
+
+EpdGlyphCache::EpdGlyphCache(const size_t slotSize, const uint16_t slotCount, const size_t blockSize)
+    : slotSize(slotSize), slotCount(slotCount), blockSize(blockSize) {
+  uint16_t bucketCount = 1;
+  while (bucketCount < slotCount) {
+    bucketCount <<= 1;
+  }
+  bucketMask = bucketCount - 1;
+
+  slots = static_cast<uint8_t*>(malloc(slotSize * slotCount));
+  entries = static_cast<Entry*>(malloc(sizeof(Entry) * slotCount));
+  buckets = static_cast<uint16_t*>(malloc(sizeof(uint16_t) * bucketCount));
+  block = blockSize > 0 ? static_cast<uint8_t*>(malloc(blockSize)) : nullptr;
+  inflator = blockSize > 0 ? static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor))) : nullptr;
+  if (!isValid()) {
+    return;
+  }
+
+  for (uint16_t i = 0; i < bucketCount; i++) {
+    buckets[i] = NONE;
+  }
+  for (uint16_t i = 0; i < slotCount; i++) {
+    entries[i] = {0, NONE, NONE, NONE};
+  }
+}
+
+EpdGlyphCache::~EpdGlyphCache() {
+  free(slots);
+  free(entries);
+  free(buckets);
+  free(block);
+  free(inflator);
+}
+
+void EpdGlyphCache::unlink(const uint16_t slot) {
+  Entry& entry = entries[slot];
+  if (entry.newer != NONE) {
+    entries[entry.newer].older = entry.older;
+  } else {
+    newest = entry.older;
+  }
+  if (entry.older != NONE) {
+    entries[entry.older].newer = entry.newer;
+  } else {
+    oldest = entry.newer;
+  }
+  entry.newer = NONE;
+  entry.older = NONE;
+}
+
+void EpdGlyphCache::pushNewest(const uint16_t slot) {
+  Entry& entry = entries[slot];
+  entry.newer = NONE;
+  entry.older = newest;
+  if (newest != NONE) {
+    entries[newest].newer = slot;
+  }
+  newest = slot;
+  if (oldest == NONE) {
+    oldest = slot;
+  }
+}
+
+void EpdGlyphCache::pushOldest(const uint16_t slot) {
+  Entry& entry = entries[slot];
+  entry.older = NONE;
+  entry.newer = oldest;
+  if (oldest != NONE) {
+    entries[oldest].older = slot;
+  }
+  oldest = slot;
+  if (newest == NONE) {
+    newest = slot;
+  }
+}
+
+void EpdGlyphCache::removeFromBucket(const uint16_t slot) {
+  uint16_t* link = &buckets[entries[slot].key & bucketMask];
+  while (*link != NONE) {
+    if (*link == slot) {
+      *link = entries[slot].bucketNext;
+      return;
+    }
+    link = &entries[*link].bucketNext;
+  }
+}
+
+const uint8_t* EpdGlyphCache::find(const uint32_t key) {
+  for (uint16_t slot = buckets[key & bucketMask]; slot != NONE; slot = entries[slot].bucketNext) {
+    if (entries[slot].key == key) {
+      if (slot != newest) {
+        unlink(slot);
+        pushNewest(slot);
+      }
+      hits++;
+      return slots + slot * slotSize;
+    }
+  }
+  misses++;
+  return nullptr;
+}
+
+uint8_t* EpdGlyphCache::insert(const uint32_t key) {
+  uint16_t slot;
+  if (usedCount < slotCount) {
+    slot = usedCount++;
+  } else {
+    slot = oldest;
+    unlink(slot);
+    removeFromBucket(slot);
+  }
+
+  Entry& entry = entries[slot];
+  entry.key = key;
+  entry.bucketNext = buckets[key & bucketMask];
+  buckets[key & bucketMask] = slot;
+  pushNewest(slot);
+  return slots + slot * slotSize;
+}
+
+void EpdGlyphCache::erase(const uint32_t key) {
+  for (uint16_t slot = buckets[key & bucketMask]; slot != NONE; slot = entries[slot].bucketNext) {
+    if (entries[slot].key == key) {
+      removeFromBucket(slot);
+      unlink(slot);
+      pushOldest(slot);
+      return;
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct tinfl_decompressor_tag;
+
+// Bounded least recently used cache of inflated glyph bitmaps for fonts with compressed bitmap blocks, also used for
+// the bitmap pages of SD card fonts (one page per slot, no block buffer).
+//
+// Every slot has room for the font's largest glyph. Lookups go through a small chained hash table keyed by glyph
+// index (one per codepoint), recency is kept in a doubly linked list over the slots so hits and evictions are O(1).
+// The most recently inflated block is kept as well, glyphs of one block tend to be needed together (a-z, digits).
+// The decompressor state used to inflate blocks (about 11KB) is allocated with the block buffer and reused.
+class EpdGlyphCache {
+ public:
+  static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+
+  EpdGlyphCache(size_t slotSize, uint16_t slotCount, size_t blockSize);
+  ~EpdGlyphCache();
+  EpdGlyphCache(const EpdGlyphCache&) = delete;
+  EpdGlyphCache& operator=(const EpdGlyphCache&) = delete;
+
+  // False if one of the buffers could not be allocated
+  bool isValid() const { return slots && entries && buckets && ((block && inflator) || blockSize == 0); }
+
+  // Cached bitmap for key, or nullptr. A hit makes the entry the most recently used.
+  const uint8_t* find(uint32_t key);
+  // Slot to fill for key, evicting the least recently used entry
+  uint8_t* insert(uint32_t key);
+  // Drops key (e.g. when filling its slot failed), its slot is reused first
+  void erase(uint32_t key);
+
+  // Inflated block buffer (nullptr for a zero blockSize) and the index of the block it holds
+  uint8_t* getBlock() const { return block; }
+  // Decompressor for filling the block buffer, nullptr for a zero blockSize
+  tinfl_decompressor_tag* getInflator() const { return inflator; }
+  size_t getBlockSize() const { return blockSize; }
+  uint32_t blockIndex = NO_BLOCK;
+
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t blockInflates = 0;
+
+ private:
+  static constexpr uint16_t NONE = UINT16_MAX;
+
+  struct Entry {
+    uint32_t key;
+    uint16_t bucketNext;
+    uint16_t newer;
+    uint16_t older;
+  };
+
+  size_t slotSize;
+  uint16_t slotCount;
+  uint16_t bucketMask;
+  uint8_t* slots = nullptr;
+  Entry* entries = nullptr;
+  uint16_t* buckets = nullptr;
+  uint8_t* block = nullptr;
+  size_t blockSize;
+  tinfl_decompressor_tag* inflator = nullptr;
+  uint16_t newest = NONE;
+  uint16_t oldest = NONE;
+  uint16_t usedCount = 0;
+
+  void unlink(uint16_t slot);
+  void pushNewest(uint16_t slot);
+  void pushOldest(uint16_t slot);
+  void removeFromBucket(uint16_t slot);
+};
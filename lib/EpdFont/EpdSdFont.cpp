@@ -0,0 +1,174 @@
+#include "EpdSdFont.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "EpdGlyphCache.h"
+
+namespace {
+constexpr uint32_t FNV_OFFSET = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+// Table records are read this many at a time
+constexpr size_t RECORDS_PER_READ = 64;
+
+uint16_t readU16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t readU32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint32_t hashBytes(uint32_t hash, const uint8_t* bytes, const size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    hash = (hash ^ bytes[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+}  // namespace
+
+EpdSdFont::~EpdSdFont() { close(); }
+
+void EpdSdFont::close() {
+  if (file) {
+    file.close();
+  }
+  delete pageCache;
+  pageCache = nullptr;
+  free(intervals);
+  intervals = nullptr;
+  free(glyphs);
+  glyphs = nullptr;
+  data = {};
+}
+
+bool EpdSdFont::load(const std::string& path) {
+  close();
+  if (!SdMan.openFileForRead("FNT", path, file)) {
+    return false;
+  }
+
+  uint8_t header[HEADER_SIZE];
+  if (file.read(header, HEADER_SIZE) != static_cast<int>(HEADER_SIZE) || memcmp(header, "EPDF", 4) != 0 ||
+      header[4] != VERSION) {
+    Serial.printf("[%lu] [FNT] Not a font container: %s\n", millis(), path.c_str());
+    close();
+    return false;
+  }
+
+  const uint32_t intervalCount = readU32(header + 12);
+  const uint32_t glyphCount = readU32(header + 16);
+  pageSize = readU32(header + 20);
+  pageCount = readU32(header + 24);
+  bitmapOffset = readU32(header + 28);
+  if (intervalCount == 0 || glyphCount == 0 || pageSize == 0 || pageSize > UINT16_MAX || pageCount == 0) {
+    Serial.printf("[%lu] [FNT] Invalid font container header: %s\n", millis(), path.c_str());
+    close();
+    return false;
+  }
+
+  uint32_t hash = hashBytes(FNV_OFFSET, header, HEADER_SIZE);
+  if (!readTables(intervalCount, glyphCount, &hash)) {
+    Serial.printf("[%lu] [FNT] Failed to read font tables: %s\n", millis(), path.c_str());
+    close();
+    return false;
+  }
+
+  const size_t cachedPages = std::max<size_t>(MIN_CACHED_PAGES, PAGE_CACHE_BYTES / pageSize);
+  pageCache = new EpdGlyphCache(pageSize, static_cast<uint16_t>(std::min<size_t>(cachedPages, pageCount)), 0);
+  if (!pageCache->isValid()) {
+    Serial.printf("[%lu] [FNT] Failed to allocate font page cache\n", millis());
+    close();
+    return false;
+  }
+
+  data.bitmap = nullptr;
+  data.glyph = glyphs;
+  data.intervals = intervals;
+  data.intervalCount = intervalCount;
+  data.advanceY = header[6];
+  data.ascender = static_cast<int16_t>(readU16(header + 8));
+  data.descender = static_cast<int16_t>(readU16(header + 10));
+  data.is2Bit = header[5] & 0x1;
+
+  fontId = static_cast<int>(hash);
+
+  Serial.printf("[%lu] [FNT] Loaded %s: %lu glyphs, %lu pages of %lu bytes\n", millis(), path.c_str(),
+                static_cast<unsigned long>(glyphCount), static_cast<unsigned long>(pageCount),
+                static_cast<unsigned long>(pageSize));
+  return true;
+}
+
+bool EpdSdFont::readTables(const uint32_t intervalCount, const uint32_t glyphCount, uint32_t* hash) {
+  intervals = static_cast<EpdUnicodeInterval*>(malloc(sizeof(EpdUnicodeInterval) * intervalCount));
+  glyphs = static_cast<EpdGlyph*>(malloc(sizeof(EpdGlyph) * glyphCount));
+  if (!intervals || !glyphs) {
+    return false;
+  }
+
+  uint8_t records[RECORDS_PER_READ * GLYPH_RECORD_SIZE];
+  for (uint32_t i = 0; i < intervalCount; i += RECORDS_PER_READ) {
+    const uint32_t count = std::min<uint32_t>(RECORDS_PER_READ, intervalCount - i);
+    const int bytes = static_cast<int>(count * INTERVAL_RECORD_SIZE);
+    if (file.read(records, bytes) != bytes) {
+      return false;
+    }
+    *hash = hashBytes(*hash, records, bytes);
+    for (uint32_t r = 0; r < count; r++) {
+      const uint8_t* record = records + r * INTERVAL_RECORD_SIZE;
+      intervals[i + r] = {readU32(record), readU32(record + 4), readU32(record + 8)};
+      if (intervals[i + r].offset + (intervals[i + r].last - intervals[i + r].first) >= glyphCount) {
+        return false;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < glyphCount; i += RECORDS_PER_READ) {
+    const uint32_t count = std::min<uint32_t>(RECORDS_PER_READ, glyphCount - i);
+    const int bytes = static_cast<int>(count * GLYPH_RECORD_SIZE);
+    if (file.read(records, bytes) != bytes) {
+      return false;
+    }
+    *hash = hashBytes(*hash, records, bytes);
+    for (uint32_t r = 0; r < count; r++) {
+      const uint8_t* record = records + r * GLYPH_RECORD_SIZE;
+      EpdGlyph& glyph = glyphs[i + r];
+      glyph.width = record[0];
+      glyph.height = record[1];
+      glyph.advanceX = record[2];
+      glyph.left = static_cast<int16_t>(readU16(record + 4));
+      glyph.top = static_cast<int16_t>(readU16(record + 6));
+      glyph.dataLength = readU16(record + 8);
+      glyph.dataOffset = readU32(record + 12);
+      // A glyph has to sit inside one page, see the layout above
+      const uint32_t firstPage = glyph.dataOffset / pageSize;
+      const uint32_t lastPage = (glyph.dataOffset + glyph.dataLength - 1) / pageSize;
+      if (glyph.dataLength > 0 && (firstPage != lastPage || firstPage >= pageCount)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+const uint8_t* EpdSdFont::getGlyphBitmap(const EpdGlyph* glyph) {
+  if (!pageCache) {
+    return nullptr;
+  }
+
+  const uint32_t page = glyph->dataOffset / pageSize;
+  const uint32_t offsetInPage = glyph->dataOffset % pageSize;
+  if (const uint8_t* cached = pageCache->find(page)) {
+    return cached + offsetInPage;
+  }
+
+  uint8_t* slot = pageCache->insert(page);
+  if (!file.seek(bitmapOffset + static_cast<uint64_t>(page) * pageSize) ||
+      file.read(slot, pageSize) != static_cast<int>(pageSize)) {
+    Serial.printf("[%lu] [FNT] Failed to read font page %lu\n", millis(), static_cast<unsigned long>(page));
+    pageCache->erase(page);
+    return nullptr;
+  }
+  return slot + offsetInPage;
+}
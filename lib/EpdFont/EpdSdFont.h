@@ -0,0 +1,64 @@
+#pragma once
+
+#include <SdFat.h>
+
+#include <string>
+
+#include "EpdFont.h"
+
+class EpdGlyphCache;
+
+// Font loaded from a binary container on the SD card, written by fontconvert.py --binary.
+//
+// The interval and glyph tables are read into RAM once, glyph bitmaps stay on the card and are fetched a page at a
+// time into a small LRU page cache. Glyphs never straddle a page, so a bitmap is always one pointer into a cached page.
+//
+// Container layout, little endian:
+//   header     "EPDF", u8 version, u8 flags (bit 0: 2-bit), u8 advanceY, u8 reserved, i16 ascender, i16 descender,
+//              u32 intervalCount, u32 glyphCount, u32 pageSize, u32 pageCount, u32 bitmapOffset
+//   intervals  intervalCount x (u32 first, u32 last, u32 offset)
+//   glyphs     glyphCount x (u8 width, u8 height, u8 advanceX, u8 reserved, i16 left, i16 top, u16 dataLength,
+//              u16 reserved, u32 dataOffset), dataOffset counted from bitmapOffset
+//   bitmaps    pageCount pages of pageSize bytes at bitmapOffset, the last one padded to a full page
+class EpdSdFont final : public EpdFont::BitmapSource {
+ public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr size_t HEADER_SIZE = 32;
+  static constexpr size_t INTERVAL_RECORD_SIZE = 12;
+  static constexpr size_t GLYPH_RECORD_SIZE = 16;
+  // RAM budget of the bitmap page cache
+  static constexpr size_t PAGE_CACHE_BYTES = 12 * 1024;
+  static constexpr uint16_t MIN_CACHED_PAGES = 4;
+
+  EpdSdFont() = default;
+  ~EpdSdFont();
+  EpdSdFont(const EpdSdFont&) = delete;
+  EpdSdFont& operator=(const EpdSdFont&) = delete;
+
+  // Reads the tables of the container at path and keeps the file open for bitmap pages
+  bool load(const std::string& path);
+  void close();
+  bool isLoaded() const { return glyphs != nullptr; }
+
+  // Valid once loaded, stays at the same address so EpdFonts can be set up before loading
+  const EpdFontData* getData() const { return &data; }
+  // Derived from the tables, so section caches laid out with another font are not reused
+  int getFontId() const { return fontId; }
+  const EpdGlyphCache* getPageCache() const { return pageCache; }
+
+  const uint8_t* getGlyphBitmap(const EpdGlyph* glyph) override;
+
+ private:
+  FsFile file;
+  EpdFontData data = {};
+  EpdUnicodeInterval* intervals = nullptr;
+  EpdGlyph* glyphs = nullptr;
+  EpdGlyphCache* pageCache = nullptr;
+  uint32_t pageSize = 0;
+  uint32_t pageCount = 0;
+  uint32_t bitmapOffset = 0;
+  int fontId = 0;
+
+  // Fills the tables and folds the raw records into hash
+  bool readTables(uint32_t intervalCount, uint32_t glyphCount, uint32_t* hash);
+};
@@ -1,55 +1,59 @@
 #pragma once
 
+#include <builtinFonts/bookerly_12_regular.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/bookerly_16_regular.h>
+#include <builtinFonts/bookerly_18_regular.h>
+#include <builtinFonts/notosans_8_regular.h>
+#include <builtinFonts/notosans_12_regular.h>
+#include <builtinFonts/notosans_14_regular.h>
+#include <builtinFonts/notosans_16_regular.h>
+#include <builtinFonts/notosans_18_regular.h>
+#include <builtinFonts/opendyslexic_10_regular.h>
+#include <builtinFonts/opendyslexic_12_regular.h>
+#include <builtinFonts/opendyslexic_14_regular.h>
+#include <builtinFonts/opendyslexic_8_regular.h>
+#include <builtinFonts/ubuntu_10_bold.h>
+#include <builtinFonts/ubuntu_10_regular.h>
+#include <builtinFonts/ubuntu_12_bold.h>
+#include <builtinFonts/ubuntu_12_regular.h>
+
+// Bold and italic faces, builds with SYNTHESIZE_FONT_STYLES derive them from the regular ones
+#ifndef SYNTHESIZE_FONT_STYLES
 #include <builtinFonts/bookerly_12_bold.h>
 #include <builtinFonts/bookerly_12_bolditalic.h>
 #include <builtinFonts/bookerly_12_italic.h>
-#include <builtinFonts/bookerly_12_regular.h>
 #include <builtinFonts/bookerly_14_bold.h>
 #include <builtinFonts/bookerly_14_bolditalic.h>
 #include <builtinFonts/bookerly_14_italic.h>
-#include <builtinFonts/bookerly_14_regular.h>
 #include <builtinFonts/bookerly_16_bold.h>
 #include <builtinFonts/bookerly_16_bolditalic.h>
 #include <builtinFonts/bookerly_16_italic.h>
-#include <builtinFonts/bookerly_16_regular.h>
 #include <builtinFonts/bookerly_18_bold.h>
 #include <builtinFonts/bookerly_18_bolditalic.h>
 #include <builtinFonts/bookerly_18_italic.h>
-#include <builtinFonts/bookerly_18_regular.h>
-#include <builtinFonts/notosans_8_regular.h>
 #include <builtinFonts/notosans_12_bold.h>
 #include <builtinFonts/notosans_12_bolditalic.h>
 #include <builtinFonts/notosans_12_italic.h>
-#include <builtinFonts/notosans_12_regular.h>
 #include <builtinFonts/notosans_14_bold.h>
 #include <builtinFonts/notosans_14_bolditalic.h>
 #include <builtinFonts/notosans_14_italic.h>
-#include <builtinFonts/notosans_14_regular.h>
 #include <builtinFonts/notosans_16_bold.h>
 #include <builtinFonts/notosans_16_bolditalic.h>
 #include <builtinFonts/notosans_16_italic.h>
-#include <builtinFonts/notosans_16_regular.h>
 #include <builtinFonts/notosans_18_bold.h>
 #include <builtinFonts/notosans_18_bolditalic.h>
 #include <builtinFonts/notosans_18_italic.h>
-#include <builtinFonts/notosans_18_regular.h>
 #include <builtinFonts/opendyslexic_10_bold.h>
 #include <builtinFonts/opendyslexic_10_bolditalic.h>
 #include <builtinFonts/opendyslexic_10_italic.h>
-#include <builtinFonts/opendyslexic_10_regular.h>
 #include <builtinFonts/opendyslexic_12_bold.h>
 #include <builtinFonts/opendyslexic_12_bolditalic.h>
 #include <builtinFonts/opendyslexic_12_italic.h>
-#include <builtinFonts/opendyslexic_12_regular.h>
 #include <builtinFonts/opendyslexic_14_bold.h>
 #include <builtinFonts/opendyslexic_14_bolditalic.h>
 #include <builtinFonts/opendyslexic_14_italic.h>
-#include <builtinFonts/opendyslexic_14_regular.h>
 #include <builtinFonts/opendyslexic_8_bold.h>
 #include <builtinFonts/opendyslexic_8_bolditalic.h>
 #include <builtinFonts/opendyslexic_8_italic.h>
-#include <builtinFonts/opendyslexic_8_regular.h>
-#include <builtinFonts/ubuntu_10_bold.h>
-#include <builtinFonts/ubuntu_10_regular.h>
-#include <builtinFonts/ubuntu_12_bold.h>
-#include <builtinFonts/ubuntu_12_regular.h>
+#endif
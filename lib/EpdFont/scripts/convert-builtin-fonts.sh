@@ -5,6 +5,11 @@ set -e
 cd "$(dirname "$0")"
 
 READER_FONT_STYLES=("Regular" "Italic" "Bold" "BoldItalic")
+# --synthesize-styles: only convert the regular reader faces, for builds with -DSYNTHESIZE_FONT_STYLES which derive
+# bold and italic from them at draw time. Existing variant headers are left alone so font IDs stay the same.
+if [ "$1" == "--synthesize-styles" ]; then
+  READER_FONT_STYLES=("Regular")
+fi
 BOOKERLY_FONT_SIZES=(12 14 16 18)
 NOTOSANS_FONT_SIZES=(12 14 16 18)
 OPENDYSLEXIC_FONT_SIZES=(8 10 12 14)
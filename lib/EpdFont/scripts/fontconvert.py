@@ -5,6 +5,7 @@ import sys
 import re
 import math
 import argparse
+import struct
 from collections import namedtuple
 
 # Originally from https://github.com/vroland/epdiy
@@ -14,6 +15,10 @@ parser.add_argument("name", action="store", help="name of the font.")
 parser.add_argument("size", type=int, help="font size to use.")
 parser.add_argument("fontstack", action="store", nargs='+', help="list of font files, ordered by descending priority.")
 parser.add_argument("--2bit", dest="is2Bit", action="store_true", help="generate 2-bit greyscale bitmap instead of 1-bit black and white.")
+parser.add_argument("--compress", dest="compress", action="store_true", help="deflate glyph bitmaps in blocks of consecutive glyphs, inflated on demand by EpdFont.")
+parser.add_argument("--compress-block-size", dest="compress_block_size", type=int, default=2048, help="maximum uncompressed size of a compressed glyph block in bytes (default 2048).")
+parser.add_argument("--binary", dest="binary", action="store_true", help="write a binary font container for the SD card (see EpdSdFont.h) to stdout instead of a header.")
+parser.add_argument("--page-size", dest="page_size", type=int, default=1024, help="bitmap page size of the binary font container in bytes (default 1024).")
 parser.add_argument("--additional-intervals", dest="additional_intervals", action="append", help="Additional code point intervals to export as min,max. This argument can be repeated.")
 args = parser.parse_args()
 
@@ -263,14 +268,78 @@ for i_start, i_end in intervals:
 # pipe seems to be a good heuristic for the "real" descender
 face = load_glyph(ord('|'))
 
+def write_binary_container():
+    # Glyphs are packed into fixed size pages without straddling a page boundary, so EpdSdFont can read one page per
+    # cache miss. The last page is padded to a full page.
+    page_size = max(args.page_size, max(len(packed) for _, packed in all_glyphs))
+    bitmaps = bytearray()
+    glyph_records = bytearray()
+    for props, packed in all_glyphs:
+        if len(bitmaps) // page_size != (len(bitmaps) + max(len(packed), 1) - 1) // page_size:
+            bitmaps.extend(b"\0" * (page_size - len(bitmaps) % page_size))
+        glyph_records += struct.pack("<BBBxhhHxxI", props.width, props.height, props.advance_x, props.left, props.top,
+                                     len(packed), len(bitmaps))
+        bitmaps.extend(packed)
+    if len(bitmaps) % page_size != 0 or len(bitmaps) == 0:
+        bitmaps.extend(b"\0" * (page_size - len(bitmaps) % page_size))
+
+    interval_records = bytearray()
+    offset = 0
+    for i_start, i_end in intervals:
+        interval_records += struct.pack("<III", i_start, i_end, offset)
+        offset += i_end - i_start + 1
+
+    header_size = 32
+    bitmap_offset = header_size + len(interval_records) + len(glyph_records)
+    header = struct.pack("<4sBBBxhhIIIII", b"EPDF", 1, 1 if is2Bit else 0, norm_ceil(face.size.height),
+                         norm_ceil(face.size.ascender), norm_floor(face.size.descender), len(intervals),
+                         len(all_glyphs), page_size, len(bitmaps) // page_size, bitmap_offset)
+    out = sys.stdout.buffer
+    out.write(header)
+    out.write(interval_records)
+    out.write(glyph_records)
+    out.write(bitmaps)
+    print(f"{font_name}: {len(all_glyphs)} glyphs, {len(bitmaps) // page_size} pages of {page_size} bytes", file=sys.stderr)
+
+if args.binary:
+    if args.compress:
+        sys.exit("--binary and --compress cannot be combined")
+    write_binary_container()
+    sys.exit(0)
+
 glyph_data = []
 glyph_props = []
-for index, glyph in enumerate(all_glyphs):
-    props, packed = glyph
-    glyph_data.extend([b for b in packed])
-    glyph_props.append(props)
+glyph_groups = []
+if args.compress:
+    # Consecutive glyphs are packed into blocks of at most compress_block_size bytes and each block is stored as a raw
+    # deflate stream. Glyph data offsets become relative to the start of their inflated block.
+    def flush_group(first_glyph, block):
+        compressor = zlib.compressobj(9, zlib.DEFLATED, -15)
+        compressed = compressor.compress(bytes(block)) + compressor.flush()
+        glyph_groups.append((len(glyph_data), len(compressed), len(block), first_glyph))
+        glyph_data.extend(compressed)
+
+    block = bytearray()
+    first_glyph = 0
+    for index, glyph in enumerate(all_glyphs):
+        props, packed = glyph
+        if len(block) > 0 and len(block) + len(packed) > args.compress_block_size:
+            flush_group(first_glyph, block)
+            block = bytearray()
+            first_glyph = index
+        glyph_props.append(props._replace(data_offset=len(block)))
+        block.extend(packed)
+    if len(block) > 0 or len(glyph_groups) == 0:
+        flush_group(first_glyph, block)
+    print(f"{font_name}: {total_size} bitmap bytes deflated to {len(glyph_data)} in {len(glyph_groups)} blocks", file=sys.stderr)
+else:
+    for index, glyph in enumerate(all_glyphs):
+        props, packed = glyph
+        glyph_data.extend([b for b in packed])
+        glyph_props.append(props)
 
-print(f"/**\n * generated by fontconvert.py\n * name: {font_name}\n * size: {size}\n * mode: {'2-bit' if is2Bit else '1-bit'}\n */")
+mode = ('2-bit' if is2Bit else '1-bit') + (', compressed' if args.compress else '')
+print(f"/**\n * generated by fontconvert.py\n * name: {font_name}\n * size: {size}\n * mode: {mode}\n */")
 print("#pragma once")
 print("#include \"EpdFontData.h\"\n")
 print(f"static const uint8_t {font_name}Bitmaps[{len(glyph_data)}] = {{")
@@ -290,6 +359,12 @@ for i_start, i_end in intervals:
     offset += i_end - i_start + 1
 print ("};\n");
 
+if args.compress:
+    print(f"static const EpdGlyphGroup {font_name}Groups[] = {{")
+    for compressed_offset, compressed_size, uncompressed_size, first_glyph in glyph_groups:
+        print (f"    {{ 0x{compressed_offset:X}, 0x{compressed_size:X}, 0x{uncompressed_size:X}, 0x{first_glyph:X} }},")
+    print ("};\n");
+
 print(f"static const EpdFontData {font_name} = {{")
 print(f"    {font_name}Bitmaps,")
 print(f"    {font_name}Glyphs,")
@@ -299,4 +374,7 @@ print(f"    {norm_ceil(face.size.height)},")
 print(f"    {norm_ceil(face.size.ascender)},")
 print(f"    {norm_floor(face.size.descender)},")
 print(f"    {'true' if is2Bit else 'false'},")
+if args.compress:
+    print(f"    {font_name}Groups,")
+    print(f"    {len(glyph_groups)},")
 print("};")
@@ -3,14 +3,27 @@
 #include <FsHelpers.h>
 #include <HardwareSerial.h>
 #include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
 #include <SDCardManager.h>
 #include <ZipFile.h>
 
+#include <cstring>
+
 #include "Epub/parsers/ContainerParser.h"
 #include "Epub/parsers/ContentOpfParser.h"
 #include "Epub/parsers/TocNavParser.h"
 #include "Epub/parsers/TocNcxParser.h"
 
+namespace {
+bool hasSuffix(const std::string& value, const char* suffix) {
+  const size_t length = strlen(suffix);
+  return value.length() >= length && value.compare(value.length() - length, length, suffix) == 0;
+}
+
+bool isJpegHref(const std::string& href) { return hasSuffix(href, ".jpg") || hasSuffix(href, ".jpeg"); }
+bool isPngHref(const std::string& href) { return hasSuffix(href, ".png"); }
+}  // namespace
+
 bool Epub::findContentOpfFile(std::string* contentOpfFile) const {
   const auto containerPath = "META-INF/container.xml";
   size_t containerSize;
@@ -77,6 +90,7 @@ bool Epub::parseContentOpf(BookMetadataCache::BookMetadata& bookMetadata) {
   bookMetadata.language = opfParser.language;
   bookMetadata.coverItemHref = opfParser.coverItemHref;
   bookMetadata.textReferenceHref = opfParser.textReferenceHref;
+  bookMetadata.contentBasePath = contentBasePath;
 
   if (!opfParser.tocNcxPath.empty()) {
     tocNcxItem = opfParser.tocNcxPath;
@@ -85,12 +99,14 @@ bool Epub::parseContentOpf(BookMetadataCache::BookMetadata& bookMetadata) {
   if (!opfParser.tocNavPath.empty()) {
     tocNavItem = opfParser.tocNavPath;
   }
+  bookMetadata.tocNcxPath = tocNcxItem;
+  bookMetadata.tocNavPath = tocNavItem;
 
   Serial.printf("[%lu] [EBP] Successfully parsed content.opf\n", millis());
   return true;
 }
 
-bool Epub::parseTocNcxFile() const {
+bool Epub::parseTocNcxFile(BookMetadataCache* cache) const {
   // the ncx file should have been specified in the content.opf file
   if (tocNcxItem.empty()) {
     Serial.printf("[%lu] [EBP] No ncx file specified\n", millis());
@@ -111,7 +127,7 @@ bool Epub::parseTocNcxFile() const {
   }
   const auto ncxSize = tempNcxFile.size();
 
-  TocNcxParser ncxParser(contentBasePath, ncxSize, bookMetadataCache.get());
+  TocNcxParser ncxParser(contentBasePath, ncxSize, cache);
 
   if (!ncxParser.setup()) {
     Serial.printf("[%lu] [EBP] Could not setup toc ncx parser\n", millis());
@@ -147,7 +163,7 @@ bool Epub::parseTocNcxFile() const {
   return true;
 }
 
-bool Epub::parseTocNavFile() const {
+bool Epub::parseTocNavFile(BookMetadataCache* cache) const {
   // the nav file should have been specified in the content.opf file (EPUB 3)
   if (tocNavItem.empty()) {
     Serial.printf("[%lu] [EBP] No nav file specified\n", millis());
@@ -171,7 +187,7 @@ bool Epub::parseTocNavFile() const {
   // Note: We can't use `contentBasePath` here as the nav file may be in a different folder to the content.opf
   // and the HTMLX nav file will have hrefs relative to itself
   const std::string navContentBasePath = tocNavItem.substr(0, tocNavItem.find_last_of('/') + 1);
-  TocNavParser navParser(navContentBasePath, navSize, bookMetadataCache.get());
+  TocNavParser navParser(navContentBasePath, navSize, cache);
 
   if (!navParser.setup()) {
     Serial.printf("[%lu] [EBP] Could not setup toc nav parser\n", millis());
@@ -204,8 +220,42 @@ bool Epub::parseTocNavFile() const {
   return true;
 }
 
+bool Epub::runTocPass(BookMetadataCache* cache) const {
+  // TOC Pass - try EPUB 3 nav first, fall back to NCX
+  if (!cache->beginTocPass()) {
+    Serial.printf("[%lu] [EBP] Could not begin writing toc pass\n", millis());
+    return false;
+  }
+
+  bool tocParsed = false;
+
+  // Try EPUB 3 nav document first (preferred)
+  if (!tocNavItem.empty()) {
+    Serial.printf("[%lu] [EBP] Attempting to parse EPUB 3 nav document\n", millis());
+    tocParsed = parseTocNavFile(cache);
+  }
+
+  // Fall back to NCX if nav parsing failed or wasn't available
+  if (!tocParsed && !tocNcxItem.empty()) {
+    Serial.printf("[%lu] [EBP] Falling back to NCX TOC\n", millis());
+    tocParsed = parseTocNcxFile(cache);
+  }
+
+  if (!tocParsed) {
+    Serial.printf("[%lu] [EBP] Warning: Could not parse any TOC format\n", millis());
+    // Continue anyway - book will work without TOC
+  }
+
+  if (!cache->endTocPass()) {
+    Serial.printf("[%lu] [EBP] Could not end writing toc pass\n", millis());
+    return false;
+  }
+
+  return true;
+}
+
 // load in the meta data for the epub file
-bool Epub::load(const bool buildIfMissing) {
+bool Epub::load(const bool buildIfMissing, const bool deferToc) {
   Serial.printf("[%lu] [EBP] Loading ePub: %s\n", millis(), filepath.c_str());
 
   // Initialize spine/TOC cache
@@ -213,6 +263,15 @@ bool Epub::load(const bool buildIfMissing) {
 
   // Try to load existing cache first
   if (bookMetadataCache->load()) {
+    contentBasePath = bookMetadataCache->coreMetadata.contentBasePath;
+    tocNcxItem = bookMetadataCache->coreMetadata.tocNcxPath;
+    tocNavItem = bookMetadataCache->coreMetadata.tocNavPath;
+
+    // A previous fast-path load never finished its TOC pass, complete it now unless the caller can wait
+    if (bookMetadataCache->isTocPending() && buildIfMissing && !deferToc) {
+      buildDeferredToc();
+    }
+
     Serial.printf("[%lu] [EBP] Loaded ePub: %s\n", millis(), filepath.c_str());
     return true;
   }
@@ -247,33 +306,14 @@ bool Epub::load(const bool buildIfMissing) {
     return false;
   }
 
-  // TOC Pass - try EPUB 3 nav first, fall back to NCX
-  if (!bookMetadataCache->beginTocPass()) {
-    Serial.printf("[%lu] [EBP] Could not begin writing toc pass\n", millis());
-    return false;
-  }
-
-  bool tocParsed = false;
-
-  // Try EPUB 3 nav document first (preferred)
-  if (!tocNavItem.empty()) {
-    Serial.printf("[%lu] [EBP] Attempting to parse EPUB 3 nav document\n", millis());
-    tocParsed = parseTocNavFile();
-  }
-
-  // Fall back to NCX if nav parsing failed or wasn't available
-  if (!tocParsed && !tocNcxItem.empty()) {
-    Serial.printf("[%lu] [EBP] Falling back to NCX TOC\n", millis());
-    tocParsed = parseTocNcxFile();
-  }
-
-  if (!tocParsed) {
-    Serial.printf("[%lu] [EBP] Warning: Could not parse any TOC format\n", millis());
-    // Continue anyway - book will work without TOC
-  }
-
-  if (!bookMetadataCache->endTocPass()) {
-    Serial.printf("[%lu] [EBP] Could not end writing toc pass\n", millis());
+  // In deferred mode the TOC pass is skipped entirely, leaving an empty TOC until buildDeferredToc runs
+  if (deferToc) {
+    Serial.printf("[%lu] [EBP] Deferring TOC pass\n", millis());
+    if (!bookMetadataCache->beginTocPass() || !bookMetadataCache->endTocPass()) {
+      Serial.printf("[%lu] [EBP] Could not create empty toc pass\n", millis());
+      return false;
+    }
+  } else if (!runTocPass(bookMetadataCache.get())) {
     return false;
   }
 
@@ -284,12 +324,13 @@ bool Epub::load(const bool buildIfMissing) {
   }
 
   // Build final book.bin
-  if (!bookMetadataCache->buildBookBin(filepath, bookMetadata)) {
+  if (!bookMetadataCache->buildBookBin(filepath, bookMetadata, deferToc)) {
     Serial.printf("[%lu] [EBP] Could not update mappings and sizes\n", millis());
     return false;
   }
 
-  if (!bookMetadataCache->cleanupTmpFiles()) {
+  // The spine tmp file is still needed to resolve TOC hrefs once the deferred pass runs
+  if (!deferToc && !bookMetadataCache->cleanupTmpFiles()) {
     Serial.printf("[%lu] [EBP] Could not cleanup tmp files - ignoring\n", millis());
   }
 
@@ -304,6 +345,94 @@ bool Epub::load(const bool buildIfMissing) {
   return true;
 }
 
+bool Epub::isTocPending() const {
+  return !deferredTocFailed && bookMetadataCache && bookMetadataCache->isLoaded() &&
+         bookMetadataCache->isTocPending();
+}
+
+// Completes the TOC pass of a book.bin written by a deferred load. The live cache keeps serving spine lookups
+// until the rebuilt book.bin is reloaded in place at the end. A failed pass is not retried until the next open.
+bool Epub::buildDeferredToc() { return !isTocPending() || (prepareDeferredToc() && publishDeferredToc()); }
+
+// Parses the TOC into the tmp files only. Reads the EPUB and leaves the loaded book.bin alone, so the open book stays
+// usable while this runs.
+bool Epub::prepareDeferredToc() {
+  if (!isTocPending()) {
+    return false;
+  }
+
+  Serial.printf("[%lu] [EBP] Building deferred TOC\n", millis());
+  deferredTocCache.reset(new BookMetadataCache(cachePath));
+  if (!deferredTocCache->resumeWrite(bookMetadataCache->getSpineCount())) {
+    Serial.printf("[%lu] [EBP] Could not resume writing cache\n", millis());
+    deferredTocCache.reset();
+    deferredTocFailed = true;
+    return false;
+  }
+
+  if (!runTocPass(deferredTocCache.get()) || !deferredTocCache->endWrite()) {
+    Serial.printf("[%lu] [EBP] Could not write deferred TOC\n", millis());
+    deferredTocCache.reset();
+    deferredTocFailed = true;
+    return false;
+  }
+
+  return true;
+}
+
+// Swaps in the book.bin with TOC. Spine sizes are taken from the loaded cache instead of measuring every spine item
+// in the EPUB again, so this is short enough to run while page turns wait.
+bool Epub::publishDeferredToc() {
+  if (!deferredTocCache) {
+    return false;
+  }
+  const std::unique_ptr<BookMetadataCache> tocCache = std::move(deferredTocCache);
+  deferredTocFailed = true;
+
+  const uint16_t spineCount = bookMetadataCache->getSpineCount();
+  const BookMetadataCache::BookMetadata metadata = bookMetadataCache->coreMetadata;
+  const std::vector<uint32_t> cumulativeSizes = bookMetadataCache->getCumulativeSpineSizes();
+
+  bookMetadataCache->closeBookFile();
+  if (!tocCache->buildBookBin(filepath, metadata, false, &cumulativeSizes)) {
+    Serial.printf("[%lu] [EBP] Could not rebuild book.bin with TOC\n", millis());
+    restoreSpineOnlyCache(spineCount, metadata, cumulativeSizes);
+    return false;
+  }
+
+  if (!bookMetadataCache->load()) {
+    Serial.printf("[%lu] [EBP] Failed to reload cache after deferred TOC\n", millis());
+    restoreSpineOnlyCache(spineCount, metadata, cumulativeSizes);
+    return false;
+  }
+
+  // The spine tmp file is kept until here, a spine-only book.bin can still be written from it on failure
+  if (!tocCache->cleanupTmpFiles()) {
+    Serial.printf("[%lu] [EBP] Could not cleanup tmp files - ignoring\n", millis());
+  }
+  deferredTocFailed = false;
+
+  Serial.printf("[%lu] [EBP] Deferred TOC ready: %d entries\n", millis(), bookMetadataCache->getTocCount());
+  return true;
+}
+
+// Writes the spine-only book.bin again after a failed deferred TOC rebuild and reloads it, so the open book keeps
+// working. If that fails too, book.bin is removed and the next open builds the cache from scratch.
+bool Epub::restoreSpineOnlyCache(const uint16_t spineCount, const BookMetadataCache::BookMetadata& metadata,
+                                 const std::vector<uint32_t>& cumulativeSizes) {
+  BookMetadataCache spineOnlyCache(cachePath);
+  if (spineOnlyCache.resumeWrite(spineCount) && spineOnlyCache.beginTocPass() && spineOnlyCache.endTocPass() &&
+      spineOnlyCache.endWrite() && spineOnlyCache.buildBookBin(filepath, metadata, true, &cumulativeSizes) &&
+      bookMetadataCache->load()) {
+    Serial.printf("[%lu] [EBP] Restored spine-only cache\n", millis());
+    return true;
+  }
+
+  Serial.printf("[%lu] [EBP] Could not restore spine-only cache, removing book.bin\n", millis());
+  SdMan.remove((cachePath + "/book.bin").c_str());
+  return false;
+}
+
 bool Epub::clearCache() const {
   if (!SdMan.exists(cachePath.c_str())) {
     Serial.printf("[%lu] [EPB] Cache does not exist, no action needed\n", millis());
@@ -380,40 +509,43 @@ bool Epub::generateCoverBmp(bool cropped) const {
     return false;
   }
 
-  if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-      coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating BMP from JPG cover image\n", millis());
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
+  const bool isPng = isPngHref(coverImageHref);
+  if (isJpegHref(coverImageHref) || isPng) {
+    const char* format = isPng ? "PNG" : "JPG";
+    Serial.printf("[%lu] [EBP] Generating BMP from %s cover image\n", millis(), format);
+    const auto coverTempPath = getCachePath() + (isPng ? "/.cover.png" : "/.cover.jpg");
 
-    FsFile coverJpg;
-    if (!SdMan.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
+    FsFile coverImage;
+    if (!SdMan.openFileForWrite("EBP", coverTempPath, coverImage)) {
       return false;
     }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
+    readItemContentsToStream(coverImageHref, coverImage, 1024);
+    coverImage.close();
 
-    if (!SdMan.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
+    if (!SdMan.openFileForRead("EBP", coverTempPath, coverImage)) {
       return false;
     }
 
     FsFile coverBmp;
     if (!SdMan.openFileForWrite("EBP", getCoverBmpPath(cropped), coverBmp)) {
-      coverJpg.close();
+      coverImage.close();
       return false;
     }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp);
-    coverJpg.close();
+    const bool success = isPng ? PngToBmpConverter::pngFileToBmpStream(coverImage, coverBmp)
+                               : JpegToBmpConverter::jpegFileToBmpStream(coverImage, coverBmp);
+    coverImage.close();
     coverBmp.close();
-    SdMan.remove(coverJpgTempPath.c_str());
+    SdMan.remove(coverTempPath.c_str());
 
     if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [EBP] Failed to generate BMP from %s cover image\n", millis(), format);
       SdMan.remove(getCoverBmpPath(cropped).c_str());
     }
-    Serial.printf("[%lu] [EBP] Generated BMP from JPG cover image, success: %s\n", millis(), success ? "yes" : "no");
+    Serial.printf("[%lu] [EBP] Generated BMP from %s cover image, success: %s\n", millis(), format,
+                  success ? "yes" : "no");
     return success;
   } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping\n", millis());
+    Serial.printf("[%lu] [EBP] Cover image is not a JPG or PNG, skipping\n", millis());
   }
 
   return false;
@@ -438,46 +570,50 @@ bool Epub::generateThumbBmp() const {
     return false;
   }
 
-  if (coverImageHref.substr(coverImageHref.length() - 4) == ".jpg" ||
-      coverImageHref.substr(coverImageHref.length() - 5) == ".jpeg") {
-    Serial.printf("[%lu] [EBP] Generating thumb BMP from JPG cover image\n", millis());
-    const auto coverJpgTempPath = getCachePath() + "/.cover.jpg";
+  const bool isPng = isPngHref(coverImageHref);
+  if (isJpegHref(coverImageHref) || isPng) {
+    const char* format = isPng ? "PNG" : "JPG";
+    Serial.printf("[%lu] [EBP] Generating thumb BMP from %s cover image\n", millis(), format);
+    const auto coverTempPath = getCachePath() + (isPng ? "/.cover.png" : "/.cover.jpg");
 
-    FsFile coverJpg;
-    if (!SdMan.openFileForWrite("EBP", coverJpgTempPath, coverJpg)) {
+    FsFile coverImage;
+    if (!SdMan.openFileForWrite("EBP", coverTempPath, coverImage)) {
       return false;
     }
-    readItemContentsToStream(coverImageHref, coverJpg, 1024);
-    coverJpg.close();
+    readItemContentsToStream(coverImageHref, coverImage, 1024);
+    coverImage.close();
 
-    if (!SdMan.openFileForRead("EBP", coverJpgTempPath, coverJpg)) {
+    if (!SdMan.openFileForRead("EBP", coverTempPath, coverImage)) {
       return false;
     }
 
     FsFile thumbBmp;
     if (!SdMan.openFileForWrite("EBP", getThumbBmpPath(), thumbBmp)) {
-      coverJpg.close();
+      coverImage.close();
       return false;
     }
     // Use smaller target size for Continue Reading card (half of screen: 240x400)
     // Generate 1-bit BMP for fast home screen rendering (no gray passes needed)
     constexpr int THUMB_TARGET_WIDTH = 240;
     constexpr int THUMB_TARGET_HEIGHT = 400;
-    const bool success = JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(coverJpg, thumbBmp, THUMB_TARGET_WIDTH,
-                                                                             THUMB_TARGET_HEIGHT);
-    coverJpg.close();
+    const bool success =
+        isPng ? PngToBmpConverter::pngFileTo1BitBmpStreamWithSize(coverImage, thumbBmp, THUMB_TARGET_WIDTH,
+                                                                  THUMB_TARGET_HEIGHT)
+              : JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(coverImage, thumbBmp, THUMB_TARGET_WIDTH,
+                                                                    THUMB_TARGET_HEIGHT);
+    coverImage.close();
     thumbBmp.close();
-    SdMan.remove(coverJpgTempPath.c_str());
+    SdMan.remove(coverTempPath.c_str());
 
     if (!success) {
-      Serial.printf("[%lu] [EBP] Failed to generate thumb BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [EBP] Failed to generate thumb BMP from %s cover image\n", millis(), format);
       SdMan.remove(getThumbBmpPath().c_str());
     }
-    Serial.printf("[%lu] [EBP] Generated thumb BMP from JPG cover image, success: %s\n", millis(),
+    Serial.printf("[%lu] [EBP] Generated thumb BMP from %s cover image, success: %s\n", millis(), format,
                   success ? "yes" : "no");
     return success;
   } else {
-    Serial.printf("[%lu] [EBP] Cover image is not a JPG, skipping thumbnail\n", millis());
+    Serial.printf("[%lu] [EBP] Cover image is not a JPG or PNG, skipping thumbnail\n", millis());
   }
 
   return false;
@@ -522,7 +658,19 @@ int Epub::getSpineItemsCount() const {
   return bookMetadataCache->getSpineCount();
 }
 
-size_t Epub::getCumulativeSpineItemSize(const int spineIndex) const { return getSpineItem(spineIndex).cumulativeSize; }
+size_t Epub::getCumulativeSpineItemSize(const int spineIndex) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    return 0;
+  }
+  return bookMetadataCache->getCumulativeSpineSize(spineIndex);
+}
+
+int Epub::getSpineIndexForBookOffset(const size_t offset) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    return 0;
+  }
+  return bookMetadataCache->findSpineIndexForOffset(offset);
+}
 
 BookMetadataCache::SpineEntry Epub::getSpineItem(const int spineIndex) const {
   if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
@@ -581,7 +729,12 @@ int Epub::getSpineIndexForTocIndex(const int tocIndex) const {
   return spineIndex;
 }
 
-int Epub::getTocIndexForSpineIndex(const int spineIndex) const { return getSpineItem(spineIndex).tocIndex; }
+int Epub::getTocIndexForSpineIndex(const int spineIndex) const {
+  if (!bookMetadataCache || !bookMetadataCache->isLoaded()) {
+    return -1;
+  }
+  return bookMetadataCache->getSpineTocIndex(spineIndex);
+}
 
 size_t Epub::getBookSize() const {
   if (!bookMetadataCache || !bookMetadataCache->isLoaded() || bookMetadataCache->getSpineCount() == 0) {
@@ -24,11 +24,18 @@ class Epub {
   std::string cachePath;
   // Spine and TOC cache
   std::unique_ptr<BookMetadataCache> bookMetadataCache;
+  // A deferred TOC pass is tried once per open, after a failure the book carries on without TOC
+  bool deferredTocFailed = false;
+  // TOC written by prepareDeferredToc, waiting for publishDeferredToc
+  std::unique_ptr<BookMetadataCache> deferredTocCache;
 
   bool findContentOpfFile(std::string* contentOpfFile) const;
   bool parseContentOpf(BookMetadataCache::BookMetadata& bookMetadata);
-  bool parseTocNcxFile() const;
-  bool parseTocNavFile() const;
+  bool parseTocNcxFile(BookMetadataCache* cache) const;
+  bool parseTocNavFile(BookMetadataCache* cache) const;
+  bool runTocPass(BookMetadataCache* cache) const;
+  bool restoreSpineOnlyCache(uint16_t spineCount, const BookMetadataCache::BookMetadata& metadata,
+                             const std::vector<uint32_t>& cumulativeSizes);
 
  public:
   explicit Epub(std::string filepath, const std::string& cacheDir) : filepath(std::move(filepath)) {
@@ -37,7 +44,13 @@ class Epub {
   }
   ~Epub() = default;
   std::string& getBasePath() { return contentBasePath; }
-  bool load(bool buildIfMissing = true);
+  // With deferToc set, a fresh cache is written without TOC so the book opens sooner; call buildDeferredToc later
+  bool load(bool buildIfMissing = true, bool deferToc = false);
+  bool isTocPending() const;
+  bool buildDeferredToc();
+  // buildDeferredToc in two steps: the slow TOC parse, then a short swap of book.bin that must not overlap its use
+  bool prepareDeferredToc();
+  bool publishDeferredToc();
   bool clearCache() const;
   void setupCacheDir() const;
   const std::string& getCachePath() const;
@@ -60,6 +73,7 @@ class Epub {
   int getSpineIndexForTocIndex(int tocIndex) const;
   int getTocIndexForSpineIndex(int spineIndex) const;
   size_t getCumulativeSpineItemSize(int spineIndex) const;
+  int getSpineIndexForBookOffset(size_t offset) const;
   int getSpineIndexForTextReference() const;
 
   size_t getBookSize() const;
@@ -4,12 +4,13 @@
 #include <Serialization.h>
 #include <ZipFile.h>
 
+#include <algorithm>
 #include <vector>
 
 #include "FsHelpers.h"
 
 namespace {
-constexpr uint8_t BOOK_CACHE_VERSION = 5;
+constexpr uint8_t BOOK_CACHE_VERSION = 6;
 constexpr char bookBinFile[] = "/book.bin";
 constexpr char tmpSpineBinFile[] = "/spine.bin.tmp";
 constexpr char tmpTocBinFile[] = "/toc.bin.tmp";
@@ -25,6 +26,19 @@ bool BookMetadataCache::beginWrite() {
   return true;
 }
 
+bool BookMetadataCache::resumeWrite(const uint16_t existingSpineCount) {
+  if (!SdMan.exists((cachePath + tmpSpineBinFile).c_str())) {
+    Serial.printf("[%lu] [BMC] Cannot resume write, spine tmp file missing\n", millis());
+    return false;
+  }
+
+  buildMode = true;
+  spineCount = existingSpineCount;
+  tocCount = 0;
+  Serial.printf("[%lu] [BMC] Resuming write mode with %d spine entries\n", millis(), spineCount);
+  return true;
+}
+
 bool BookMetadataCache::beginContentOpfPass() {
   Serial.printf("[%lu] [BMC] Beginning content opf pass\n", millis());
 
@@ -68,7 +82,12 @@ bool BookMetadataCache::endWrite() {
   return true;
 }
 
-bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMetadata& metadata) {
+bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMetadata& metadata, const bool spineOnly,
+                                     const std::vector<uint32_t>* cumulativeSizes) {
+  if (cumulativeSizes && cumulativeSizes->size() != spineCount) {
+    cumulativeSizes = nullptr;
+  }
+
   // Open all three files, writing to meta, reading from spine and toc
   if (!SdMan.openFileForWrite("BMC", cachePath + bookBinFile, bookFile)) {
     return false;
@@ -85,11 +104,12 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     return false;
   }
 
-  constexpr uint32_t headerASize =
-      sizeof(BOOK_CACHE_VERSION) + /* LUT Offset */ sizeof(uint32_t) + sizeof(spineCount) + sizeof(tocCount);
+  constexpr uint32_t headerASize = sizeof(BOOK_CACHE_VERSION) + /* LUT Offset */ sizeof(uint32_t) +
+                                   sizeof(spineCount) + sizeof(tocCount) + /* TOC pending */ sizeof(uint8_t);
   const uint32_t metadataSize = metadata.title.size() + metadata.author.size() + metadata.language.size() +
                                 metadata.coverItemHref.size() + metadata.textReferenceHref.size() +
-                                sizeof(uint32_t) * 5;
+                                metadata.contentBasePath.size() + metadata.tocNcxPath.size() +
+                                metadata.tocNavPath.size() + sizeof(uint32_t) * 8;
   const uint32_t lutSize = sizeof(uint32_t) * spineCount + sizeof(uint32_t) * tocCount;
   const uint32_t lutOffset = headerASize + metadataSize;
 
@@ -98,12 +118,16 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   serialization::writePod(bookFile, lutOffset);
   serialization::writePod(bookFile, spineCount);
   serialization::writePod(bookFile, tocCount);
+  serialization::writePod(bookFile, static_cast<uint8_t>(spineOnly ? 1 : 0));
   // Metadata
   serialization::writeString(bookFile, metadata.title);
   serialization::writeString(bookFile, metadata.author);
   serialization::writeString(bookFile, metadata.language);
   serialization::writeString(bookFile, metadata.coverItemHref);
   serialization::writeString(bookFile, metadata.textReferenceHref);
+  serialization::writeString(bookFile, metadata.contentBasePath);
+  serialization::writeString(bookFile, metadata.tocNcxPath);
+  serialization::writeString(bookFile, metadata.tocNavPath);
 
   // Loop through spine entries, writing LUT positions
   spineFile.seek(0);
@@ -126,7 +150,7 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
 
   ZipFile zip(epubPath);
   // Pre-open zip file to speed up size calculations
-  if (!zip.open()) {
+  if (!cumulativeSizes && !zip.open()) {
     Serial.printf("[%lu] [BMC] Could not open EPUB zip for size calculations\n", millis());
     bookFile.close();
     spineFile.close();
@@ -136,7 +160,7 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   // TODO: For large ZIPs loading the all localHeaderOffsets will crash.
   //       However not having them loaded is extremely slow. Need a better solution here.
   //       Perhaps only a cache of spine items or a better way to speedup lookups?
-  if (!zip.loadAllFileStatSlims()) {
+  if (!cumulativeSizes && !zip.loadAllFileStatSlims()) {
     Serial.printf("[%lu] [BMC] Could not load zip local header offsets for size calculations\n", millis());
     bookFile.close();
     spineFile.close();
@@ -172,7 +196,9 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     // Calculate size for cumulative size
     size_t itemSize = 0;
     const std::string path = FsHelpers::normalisePath(spineEntry.href);
-    if (zip.getInflatedFileSize(path.c_str(), &itemSize)) {
+    if (cumulativeSizes) {
+      spineEntry.cumulativeSize = (*cumulativeSizes)[i];
+    } else if (zip.getInflatedFileSize(path.c_str(), &itemSize)) {
       cumSize += itemSize;
       spineEntry.cumulativeSize = cumSize;
     } else {
@@ -183,7 +209,9 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     writeSpineEntry(bookFile, spineEntry);
   }
   // Close opened zip file
-  zip.close();
+  if (!cumulativeSizes) {
+    zip.close();
+  }
 
   // Loop through toc entries from toc file writing to book.bin
   tocFile.seek(0);
@@ -273,6 +301,12 @@ void BookMetadataCache::createTocEntry(const std::string& title, const std::stri
 /* ============= READING / LOADING FUNCTIONS ================ */
 
 bool BookMetadataCache::load() {
+  // Allow reloading in place after book.bin has been rebuilt
+  if (bookFile) {
+    bookFile.close();
+  }
+  loaded = false;
+
   if (!SdMan.openFileForRead("BMC", cachePath + bookBinFile, bookFile)) {
     return false;
   }
@@ -288,18 +322,97 @@ bool BookMetadataCache::load() {
   serialization::readPod(bookFile, lutOffset);
   serialization::readPod(bookFile, spineCount);
   serialization::readPod(bookFile, tocCount);
+  uint8_t tocPendingFlag;
+  serialization::readPod(bookFile, tocPendingFlag);
+  tocPending = tocPendingFlag != 0;
 
   serialization::readString(bookFile, coreMetadata.title);
   serialization::readString(bookFile, coreMetadata.author);
   serialization::readString(bookFile, coreMetadata.language);
   serialization::readString(bookFile, coreMetadata.coverItemHref);
   serialization::readString(bookFile, coreMetadata.textReferenceHref);
+  serialization::readString(bookFile, coreMetadata.contentBasePath);
+  serialization::readString(bookFile, coreMetadata.tocNcxPath);
+  serialization::readString(bookFile, coreMetadata.tocNavPath);
+
+  if (!loadSpineMetrics()) {
+    Serial.printf("[%lu] [BMC] Could not load spine metrics\n", millis());
+    bookFile.close();
+    return false;
+  }
 
   loaded = true;
-  Serial.printf("[%lu] [BMC] Loaded cache data: %d spine, %d TOC entries\n", millis(), spineCount, tocCount);
+  Serial.printf("[%lu] [BMC] Loaded cache data: %d spine, %d TOC entries%s\n", millis(), spineCount, tocCount,
+                tocPending ? " (TOC pending)" : "");
+  return true;
+}
+
+void BookMetadataCache::closeBookFile() {
+  if (bookFile) {
+    bookFile.close();
+  }
+}
+
+// Spine entries are stored back to back after the LUT, so walk them once and keep only the numeric fields
+bool BookMetadataCache::loadSpineMetrics() {
+  spineCumulativeSizes.clear();
+  spineTocIndexes.clear();
+  if (spineCount == 0) {
+    return true;
+  }
+
+  spineCumulativeSizes.resize(spineCount);
+  spineTocIndexes.resize(spineCount);
+
+  bookFile.seek(lutOffset);
+  uint32_t spineEntryPos;
+  serialization::readPod(bookFile, spineEntryPos);
+  if (!bookFile.seek(spineEntryPos)) {
+    return false;
+  }
+
+  for (int i = 0; i < spineCount; i++) {
+    // Skip the href string without allocating it
+    uint32_t hrefLen;
+    serialization::readPod(bookFile, hrefLen);
+    if (!bookFile.seek(bookFile.position() + hrefLen)) {
+      return false;
+    }
+    size_t cumulativeSize;
+    serialization::readPod(bookFile, cumulativeSize);
+    serialization::readPod(bookFile, spineTocIndexes[i]);
+    spineCumulativeSizes[i] = cumulativeSize;
+  }
+
   return true;
 }
 
+size_t BookMetadataCache::getCumulativeSpineSize(const int index) const {
+  if (index < 0 || index >= static_cast<int>(spineCumulativeSizes.size())) {
+    return 0;
+  }
+  return spineCumulativeSizes[index];
+}
+
+int BookMetadataCache::getSpineTocIndex(const int index) const {
+  if (index < 0 || index >= static_cast<int>(spineTocIndexes.size())) {
+    return -1;
+  }
+  return spineTocIndexes[index];
+}
+
+// Returns the first spine index whose cumulative size reaches `offset`, clamped to the last spine item
+int BookMetadataCache::findSpineIndexForOffset(const size_t offset) const {
+  if (spineCumulativeSizes.empty()) {
+    return 0;
+  }
+  const auto it = std::lower_bound(spineCumulativeSizes.begin(), spineCumulativeSizes.end(), offset);
+  if (it == spineCumulativeSizes.end()) {
+    return static_cast<int>(spineCumulativeSizes.size()) - 1;
+  }
+  return static_cast<int>(it - spineCumulativeSizes.begin());
+}
+
 BookMetadataCache::SpineEntry BookMetadataCache::getSpineEntry(const int index) {
   if (!loaded) {
     Serial.printf("[%lu] [BMC] getSpineEntry called but cache not loaded\n", millis());
@@ -3,6 +3,7 @@
 #include <SDCardManager.h>
 
 #include <string>
+#include <vector>
 
 class BookMetadataCache {
  public:
@@ -12,6 +13,10 @@ class BookMetadataCache {
     std::string language;
     std::string coverItemHref;
     std::string textReferenceHref;
+    // Needed to finish a deferred TOC pass without re-parsing content.opf
+    std::string contentBasePath;
+    std::string tocNcxPath;
+    std::string tocNavPath;
   };
 
   struct SpineEntry {
@@ -42,13 +47,17 @@ class BookMetadataCache {
 
  private:
   std::string cachePath;
-  size_t lutOffset;
+  uint32_t lutOffset;
   uint16_t spineCount;
   uint16_t tocCount;
   bool loaded;
   bool buildMode;
+  bool tocPending;
 
   FsFile bookFile;
+  // Packed spine metrics held in RAM after load() so progress/position math never seeks the SD card
+  std::vector<uint32_t> spineCumulativeSizes;
+  std::vector<int16_t> spineTocIndexes;
   // Temp file handles during build
   FsFile spineFile;
   FsFile tocFile;
@@ -57,16 +66,25 @@ class BookMetadataCache {
   uint32_t writeTocEntry(FsFile& file, const TocEntry& entry) const;
   SpineEntry readSpineEntry(FsFile& file) const;
   TocEntry readTocEntry(FsFile& file) const;
+  bool loadSpineMetrics();
 
  public:
   BookMetadata coreMetadata;
 
   explicit BookMetadataCache(std::string cachePath)
-      : cachePath(std::move(cachePath)), lutOffset(0), spineCount(0), tocCount(0), loaded(false), buildMode(false) {}
+      : cachePath(std::move(cachePath)),
+        lutOffset(0),
+        spineCount(0),
+        tocCount(0),
+        loaded(false),
+        buildMode(false),
+        tocPending(false) {}
   ~BookMetadataCache() = default;
 
   // Building phase (stream to disk immediately)
   bool beginWrite();
+  // Resume building on top of a spine-only book.bin, reusing its spine.bin.tmp
+  bool resumeWrite(uint16_t existingSpineCount);
   bool beginContentOpfPass();
   void createSpineEntry(const std::string& href);
   bool endContentOpfPass();
@@ -77,13 +95,23 @@ class BookMetadataCache {
   bool cleanupTmpFiles() const;
 
   // Post-processing to update mappings and sizes
-  bool buildBookBin(const std::string& epubPath, const BookMetadata& metadata);
+  // With spineOnly set, book.bin is flagged as TOC pending and the TOC pass can be completed later.
+  // cumulativeSizes from an earlier build of the same spine skip reopening the EPUB to measure every item again.
+  bool buildBookBin(const std::string& epubPath, const BookMetadata& metadata, bool spineOnly = false,
+                    const std::vector<uint32_t>* cumulativeSizes = nullptr);
 
   // Reading phase (read mode)
   bool load();
+  // Releases the book.bin handle so it can be rewritten; RAM-resident spine metrics stay valid
+  void closeBookFile();
   SpineEntry getSpineEntry(int index);
   TocEntry getTocEntry(int index);
   int getSpineCount() const { return spineCount; }
   int getTocCount() const { return tocCount; }
+  size_t getCumulativeSpineSize(int index) const;
+  const std::vector<uint32_t>& getCumulativeSpineSizes() const { return spineCumulativeSizes; }
+  int getSpineTocIndex(int index) const;
+  int findSpineIndexForOffset(size_t offset) const;
   bool isLoaded() const { return loaded; }
+  bool isTocPending() const { return tocPending; }
 };
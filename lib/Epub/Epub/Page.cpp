@@ -1,10 +1,11 @@
 #include "Page.h"
 
+#include <GfxRenderer.h>
 #include <HardwareSerial.h>
 #include <Serialization.h>
 
-void PageLine::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) {
-  block->render(renderer, fontId, xPos + xOffset, yPos + yOffset);
+void PageLine::render(GfxRenderer& renderer, const EpdFontFamily& font, const int xOffset, const int yOffset) {
+  block->render(renderer, font, xPos + xOffset, yPos + yOffset);
 }
 
 bool PageLine::serialize(FsFile& file) {
@@ -26,8 +27,14 @@ std::unique_ptr<PageLine> PageLine::deserialize(FsFile& file) {
 }
 
 void Page::render(GfxRenderer& renderer, const int fontId, const int xOffset, const int yOffset) const {
+  // Resolve the font once for the whole page
+  const EpdFontFamily* font = renderer.getFontFamily(fontId);
+  if (!font) {
+    return;
+  }
+
   for (auto& element : elements) {
-    element->render(renderer, fontId, xOffset, yOffset);
+    element->render(renderer, *font, xOffset, yOffset);
   }
 }
 
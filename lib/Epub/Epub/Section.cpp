@@ -8,7 +8,14 @@
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-constexpr uint8_t SECTION_FILE_VERSION = 10;
+constexpr uint8_t SECTION_LAYOUT_VERSION = 10;
+#ifdef SYNTHESIZE_FONT_STYLES
+// Synthesized bold and italic faces lay out differently from the real ones under the same font IDs, so sections
+// written by the other build flavour are not reused
+constexpr uint8_t SECTION_FILE_VERSION = SECTION_LAYOUT_VERSION | 0x80;
+#else
+constexpr uint8_t SECTION_FILE_VERSION = SECTION_LAYOUT_VERSION;
+#endif
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
                                  sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(bool) +
                                  sizeof(uint32_t);
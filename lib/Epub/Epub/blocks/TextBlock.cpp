@@ -3,7 +3,7 @@
 #include <GfxRenderer.h>
 #include <Serialization.h>
 
-void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int x, const int y) const {
+void TextBlock::render(const GfxRenderer& renderer, const EpdFontFamily& font, const int x, const int y) const {
   // Validate iterator bounds before rendering
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
     Serial.printf("[%lu] [TXB] Render skipped: size mismatch (words=%u, xpos=%u, styles=%u)\n", millis(),
@@ -11,17 +11,30 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
     return;
   }
 
+  // Words go to the renderer in batches so no allocation is needed per line
+  constexpr size_t RUN_BATCH = 16;
+  GfxRenderer::TextRunItem items[RUN_BATCH];
+  size_t itemCount = 0;
+
   auto wordIt = words.begin();
   auto wordStylesIt = wordStyles.begin();
   auto wordXposIt = wordXpos.begin();
 
   for (size_t i = 0; i < words.size(); i++) {
-    renderer.drawText(fontId, *wordXposIt + x, y, wordIt->c_str(), true, *wordStylesIt);
+    items[itemCount++] = {*wordXposIt + x, wordIt->c_str(), *wordStylesIt};
+    if (itemCount == RUN_BATCH) {
+      renderer.drawRun(font, y, items, itemCount);
+      itemCount = 0;
+    }
 
     std::advance(wordIt, 1);
     std::advance(wordStylesIt, 1);
     std::advance(wordXposIt, 1);
   }
+
+  if (itemCount > 0) {
+    renderer.drawRun(font, y, items, itemCount);
+  }
 }
 
 bool TextBlock::serialize(FsFile& file) const {
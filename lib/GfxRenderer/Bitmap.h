@@ -44,6 +44,8 @@ class Bitmap {
   int getRowBytes() const { return rowBytes; }
   bool is1Bit() const { return bpp == 1; }
   uint16_t getBpp() const { return bpp; }
+  uint32_t getFileSize() const { return static_cast<uint32_t>(file.size()); }
+  bool getModifyDateTime(uint16_t* date, uint16_t* time) const { return file.getModifyDateTime(date, time); }
 
  private:
   static uint16_t readLE16(FsFile& f);
@@ -1,5 +1,6 @@
 #include "BitmapHelpers.h"
 
+#include <array>
 #include <cstdint>
 
 // Brightness/Contrast adjustments:
@@ -104,3 +105,138 @@ uint8_t quantize1bit(int gray, int x, int y) {
   const int adjustedThreshold = 128 + ((threshold - 128) / 2);  // Range: 64-192
   return (gray >= adjustedThreshold) ? 1 : 0;
 }
+
+// ============================================================================
+// Ordered dithering
+// ============================================================================
+
+namespace {
+constexpr int TILE_SIZE = 16;
+using ThresholdTile = std::array<uint8_t, TILE_SIZE * TILE_SIZE>;
+
+// Bayer index by bit interleaving: the reversed, interleaved bits of (x ^ y) and y give the threshold rank
+constexpr ThresholdTile makeBayerTile() {
+  ThresholdTile tile{};
+  for (int y = 0; y < TILE_SIZE; y++) {
+    for (int x = 0; x < TILE_SIZE; x++) {
+      const int xy = x ^ y;
+      int rank = 0;
+      for (int bit = 0; bit < 4; bit++) {
+        rank |= ((xy >> bit) & 1) << (7 - bit * 2);
+        rank |= ((y >> bit) & 1) << (6 - bit * 2);
+      }
+      tile[y * TILE_SIZE + x] = static_cast<uint8_t>(rank);
+    }
+  }
+  return tile;
+}
+
+// Void-and-cluster ranks (Ulichney), Gaussian sigma 1.5 on a wrapping 16x16 grid
+constexpr ThresholdTile BLUE_NOISE_RANKS = {
+    234,  50, 188,  19,  58, 171, 121,  47, 163,   3, 247, 104,  22, 132,  14,  65,
+    209,   8, 118,  97, 240, 205,  23, 228, 138,  64, 123, 170,  72, 224,  99, 149,
+    85, 139, 229, 165,  78, 146, 111,  84, 176, 216,  30, 231, 153, 201,  42, 180,
+    25,  62, 195,  29,  43, 185,   7, 249,  41, 100, 191,  48,  87,   5, 128, 243,
+    221, 152, 101, 253, 130, 220,  59, 200, 156,  12, 136, 112, 254, 174,  69, 109,
+    46, 189,   2,  73, 172,  90, 142, 116,  80, 237, 210,  61, 147,  33, 206, 160,
+    81, 124, 217, 113, 208,  15, 241,  27, 168,  45, 178,  20, 193,  96, 225,  18,
+    242, 164,  60,  35, 157,  53, 181,  68, 223, 105, 125,  83, 236, 131,  55, 141,
+    197,  10, 227, 134, 246,  95, 126, 198, 148,   1, 244, 161,  71,   9, 182, 106,
+    40,  93, 179,  75, 192,   6, 218,  36,  91,  57, 202,  34, 215, 155, 233,  74,
+    252, 120, 150,  24, 110,  63, 166, 119, 232, 183, 133, 103,  49, 117,  31, 167,
+    16, 212,  51, 238, 207, 137, 255,  21,  76, 151,  13, 250, 190,  88, 203, 135,
+    102, 184,  82, 169,  38,  89, 187,  52, 204,  98, 173,  67, 129,   4, 222,  56,
+    230, 144,   0, 127, 226,  11, 154, 114, 239,  39, 219,  28, 235, 145, 175,  77,
+    196,  37, 248,  70, 107, 199,  66, 177,  17, 143, 115, 159,  86,  44, 108,  26,
+    122,  92, 158, 214, 140,  32, 245,  94, 213,  79, 194,  54, 211, 186, 251, 162};
+
+// Ranks 0-255 become thresholds 0-254: a pixel is raised when its value is above the threshold, so 0 never and 255
+// always is
+constexpr ThresholdTile toThresholds(const ThresholdTile& ranks) {
+  ThresholdTile tile{};
+  for (int i = 0; i < TILE_SIZE * TILE_SIZE; i++) {
+    tile[i] = static_cast<uint8_t>(ranks[i] * 255 / 256);
+  }
+  return tile;
+}
+
+constexpr ThresholdTile BAYER_TILE = toThresholds(makeBayerTile());
+constexpr ThresholdTile BLUE_NOISE_TILE = toThresholds(BLUE_NOISE_RANKS);
+
+// Output levels of the 2-bit ditherers, fine-tuned to the X4 display
+constexpr int DISPLAY_LEVELS[4] = {15, 30, 80, 210};
+
+// For each gray value: the level at or below it, and how far it is towards the next level (0-255). A pixel goes up a
+// level when that fraction beats its threshold, so the share of raised pixels follows the fraction.
+struct LevelTable {
+  std::array<uint8_t, 256> base;
+  std::array<uint8_t, 256> fraction;
+};
+
+constexpr LevelTable makeLevelTable() {
+  LevelTable table{};
+  for (int gray = 0; gray < 256; gray++) {
+    int level = 0;
+    while (level < 3 && gray >= DISPLAY_LEVELS[level + 1]) {
+      level++;
+    }
+    table.base[gray] = static_cast<uint8_t>(level);
+    if (level < 3 && gray > DISPLAY_LEVELS[level]) {
+      const int span = DISPLAY_LEVELS[level + 1] - DISPLAY_LEVELS[level];
+      table.fraction[gray] = static_cast<uint8_t>((gray - DISPLAY_LEVELS[level]) * 256 / span);
+    }
+  }
+  return table;
+}
+
+constexpr LevelTable LEVEL_TABLE = makeLevelTable();
+
+const uint8_t* thresholdRow(const DitherPattern pattern, const int y) {
+  const ThresholdTile& tile = pattern == DitherPattern::Bayer ? BAYER_TILE : BLUE_NOISE_TILE;
+  return tile.data() + (y & (TILE_SIZE - 1)) * TILE_SIZE;
+}
+}  // namespace
+
+void orderedDitherRow2Bit(const uint8_t* gray, const int width, const int y, const DitherPattern pattern,
+                          uint8_t* out) {
+  const uint8_t* thresholds = thresholdRow(pattern, y);
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    uint8_t packed = 0;
+    for (int i = 0; i < 4; i++) {
+      const uint8_t value = gray[x + i];
+      const int level = LEVEL_TABLE.base[value] + (LEVEL_TABLE.fraction[value] > thresholds[(x + i) & (TILE_SIZE - 1)]);
+      packed |= level << (6 - i * 2);
+    }
+    *out++ = packed;
+  }
+  if (x < width) {
+    uint8_t packed = 0;
+    for (int i = 0; x + i < width; i++) {
+      const uint8_t value = gray[x + i];
+      const int level = LEVEL_TABLE.base[value] + (LEVEL_TABLE.fraction[value] > thresholds[(x + i) & (TILE_SIZE - 1)]);
+      packed |= level << (6 - i * 2);
+    }
+    *out = packed;
+  }
+}
+
+void orderedDitherRow1Bit(const uint8_t* gray, const int width, const int y, const DitherPattern pattern,
+                          uint8_t* out) {
+  const uint8_t* thresholds = thresholdRow(pattern, y);
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    uint8_t packed = 0;
+    for (int i = 0; i < 8; i++) {
+      packed |= (gray[x + i] > thresholds[(x + i) & (TILE_SIZE - 1)]) << (7 - i);
+    }
+    *out++ = packed;
+  }
+  if (x < width) {
+    uint8_t packed = 0;
+    for (int i = 0; x + i < width; i++) {
+      packed |= (gray[x + i] > thresholds[(x + i) & (TILE_SIZE - 1)]) << (7 - i);
+    }
+    *out = packed;
+  }
+}
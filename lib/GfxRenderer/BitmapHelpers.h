@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 
 // Helper functions
@@ -8,6 +9,17 @@ uint8_t quantizeSimple(int gray);
 uint8_t quantize1bit(int gray, int x, int y);
 int adjustPixel(int gray);
 
+// Ordered dithering compares every pixel against a fixed 16x16 threshold tile instead of diffusing the error, so it
+// keeps no row state and pixels are independent. Rows go straight into packed BMP row bytes (MSB first).
+enum class DitherPattern : uint8_t {
+  Bayer,     // Recursive Bayer matrix, regular cross-hatch texture
+  BlueNoise  // Void-and-cluster tile, no visible structure and less moire on halftoned covers
+};
+// 2-bit output, 4 pixels per byte, 0 black to 3 white at the same display-tuned levels as AtkinsonDitherer
+void orderedDitherRow2Bit(const uint8_t* gray, int width, int y, DitherPattern pattern, uint8_t* out);
+// 1-bit output, 8 pixels per byte, 1 white
+void orderedDitherRow1Bit(const uint8_t* gray, int width, int y, DitherPattern pattern, uint8_t* out);
+
 // 1-bit Atkinson dithering - better quality than noise dithering for thumbnails
 // Error distribution pattern (same as 2-bit but quantizes to 2 levels):
 //     X  1/8 1/8
@@ -0,0 +1,70 @@
+#include "DirtyRegion.h"
+
+#include <cstring>
+
+namespace {
+constexpr uint32_t FNV_OFFSET = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+}  // namespace
+
+template <typename RowChanged>
+void DirtyRegion::hashFrame(const uint8_t* frameBuffer, uint32_t* newColumnHashes, RowChanged&& rowChanged) {
+  for (int column = 0; column < COLUMN_COUNT; column++) {
+    newColumnHashes[column] = FNV_OFFSET;
+  }
+
+  for (int y = 0; y < PANEL_HEIGHT; y++) {
+    const uint8_t* row = frameBuffer + y * PANEL_WIDTH_BYTES;
+    uint32_t rowHash = FNV_OFFSET;
+    for (int column = 0; column < COLUMN_COUNT; column++) {
+      uint32_t word;
+      memcpy(&word, row + column * COLUMN_BYTES, sizeof(word));
+      rowHash = (rowHash ^ word) * FNV_PRIME;
+      newColumnHashes[column] = (newColumnHashes[column] ^ word) * FNV_PRIME;
+    }
+    if (rowHash != rowHashes[y]) {
+      rowHashes[y] = rowHash;
+      rowChanged(y);
+    }
+  }
+}
+
+void DirtyRegion::capture(const uint8_t* frameBuffer) {
+  hashFrame(frameBuffer, columnHashes, [](int) {});
+  hasSnapshot = true;
+}
+
+bool DirtyRegion::update(const uint8_t* frameBuffer, Rect* changed) {
+  int firstRow = PANEL_HEIGHT;
+  int lastRow = -1;
+  uint32_t newColumnHashes[COLUMN_COUNT];
+  hashFrame(frameBuffer, newColumnHashes, [&](const int y) {
+    if (y < firstRow) firstRow = y;
+    lastRow = y;
+  });
+
+  int firstColumn = COLUMN_COUNT;
+  int lastColumn = -1;
+  for (int column = 0; column < COLUMN_COUNT; column++) {
+    if (newColumnHashes[column] != columnHashes[column]) {
+      if (column < firstColumn) firstColumn = column;
+      lastColumn = column;
+    }
+    columnHashes[column] = newColumnHashes[column];
+  }
+
+  if (!hasSnapshot) {
+    hasSnapshot = true;
+    *changed = {0, 0, PANEL_WIDTH, PANEL_HEIGHT};
+    return true;
+  }
+
+  if (lastRow < 0 || lastColumn < 0) {
+    return false;
+  }
+
+  const int columnWidth = COLUMN_BYTES * 8;
+  *changed = {firstColumn * columnWidth, firstRow, (lastColumn - firstColumn + 1) * columnWidth,
+              lastRow - firstRow + 1};
+  return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// Tracks which part of the panel framebuffer changed since the last time it was pushed to the display.
+//
+// Rather than keeping a second 48KB copy of the framebuffer, a hash is kept for every panel row and for every 32 pixel
+// wide panel column. Comparing those against the current framebuffer yields the bounding box of the changed pixels,
+// so screens can keep redrawing from scratch and still get a windowed refresh when only a line changed.
+class DirtyRegion {
+ public:
+  static constexpr int PANEL_WIDTH = 800;
+  static constexpr int PANEL_HEIGHT = 480;
+  static constexpr int PANEL_WIDTH_BYTES = PANEL_WIDTH / 8;
+  // Column hashes cover 4 bytes, so windows always start and end on a byte boundary
+  static constexpr int COLUMN_BYTES = 4;
+  static constexpr int COLUMN_COUNT = PANEL_WIDTH_BYTES / COLUMN_BYTES;
+
+  struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+  // Records the framebuffer as what the panel currently shows
+  void capture(const uint8_t* frameBuffer);
+  // Forget the recorded frame, the next update reports the whole panel
+  void invalidate() { hasSnapshot = false; }
+  bool isValid() const { return hasSnapshot; }
+
+  // Compares the framebuffer against the recorded frame and records it in its place.
+  // Returns false if nothing changed, otherwise the panel space bounding box of the changes.
+  bool update(const uint8_t* frameBuffer, Rect* changed);
+
+ private:
+  uint32_t rowHashes[PANEL_HEIGHT] = {};
+  uint32_t columnHashes[COLUMN_COUNT] = {};
+  bool hasSnapshot = false;
+
+  // Hashes the framebuffer; rowChanged is called with every row whose hash differs from the recorded one
+  template <typename RowChanged>
+  void hashFrame(const uint8_t* frameBuffer, uint32_t* newColumnHashes, RowChanged&& rowChanged);
+};
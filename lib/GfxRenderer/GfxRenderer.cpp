@@ -2,7 +2,31 @@
 
 #include <Utf8.h>
 
-void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) { fontMap.insert({fontId, font}); }
+#include "GlyphBlitter.h"
+
+static_assert(GlyphBlitter::PANEL_WIDTH == EInkDisplay::DISPLAY_WIDTH &&
+                  GlyphBlitter::PANEL_HEIGHT == EInkDisplay::DISPLAY_HEIGHT,
+              "Glyph blitter panel geometry does not match the display");
+static_assert(DirtyRegion::PANEL_WIDTH == EInkDisplay::DISPLAY_WIDTH &&
+                  DirtyRegion::PANEL_HEIGHT == EInkDisplay::DISPLAY_HEIGHT,
+              "Dirty region panel geometry does not match the display");
+// Orientation and render mode are handed to the blitter by static_cast, checked here through the same conversion
+static_assert(static_cast<GlyphBlitter::Mapping>(GfxRenderer::Portrait) == GlyphBlitter::PORTRAIT &&
+                  static_cast<GlyphBlitter::Mapping>(GfxRenderer::LandscapeClockwise) == GlyphBlitter::LANDSCAPE_CW &&
+                  static_cast<GlyphBlitter::Mapping>(GfxRenderer::PortraitInverted) ==
+                      GlyphBlitter::PORTRAIT_INVERTED &&
+                  static_cast<GlyphBlitter::Mapping>(GfxRenderer::LandscapeCounterClockwise) ==
+                      GlyphBlitter::LANDSCAPE_CCW,
+              "Glyph blitter mappings must follow GfxRenderer::Orientation");
+static_assert(static_cast<GlyphBlitter::Plane>(GfxRenderer::BW) == GlyphBlitter::PLANE_BW &&
+                  static_cast<GlyphBlitter::Plane>(GfxRenderer::GRAYSCALE_LSB) == GlyphBlitter::PLANE_GRAY_LSB &&
+                  static_cast<GlyphBlitter::Plane>(GfxRenderer::GRAYSCALE_MSB) == GlyphBlitter::PLANE_GRAY_MSB,
+              "Glyph blitter planes must follow GfxRenderer::RenderMode");
+
+void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) {
+  fontMap.insert({fontId, font});
+  glyphAtlas.clear();
+}
 
 void GfxRenderer::rotateCoordinates(const int x, const int y, int* rotatedX, int* rotatedY) const {
   switch (orientation) {
@@ -110,24 +134,109 @@ void GfxRenderer::drawText(const int fontId, const int x, const int y, const cha
   }
 }
 
+const EpdFontFamily* GfxRenderer::getFontFamily(const int fontId) const {
+  const auto it = fontMap.find(fontId);
+  if (it == fontMap.end()) {
+    Serial.printf("[%lu] [GFX] Font %d not found\n", millis(), fontId);
+    return nullptr;
+  }
+  return &it->second;
+}
+
+void GfxRenderer::drawRun(const EpdFontFamily& font, const int y, const TextRunItem* items, const size_t count,
+                          const bool black) const {
+  // Glyphs of a word are resolved before drawing so words without anything printable can be skipped like drawText
+  // does, without a separate bounds pass. Longer words are drawn as they are decoded.
+  constexpr int MAX_RESOLVED_GLYPHS = 32;
+  const EpdGlyph* glyphs[MAX_RESOLVED_GLYPHS];
+  const int yPos = y + font.getData(EpdFontFamily::REGULAR)->ascender;
+
+  for (size_t i = 0; i < count; i++) {
+    const TextRunItem& item = items[i];
+    if (item.text == nullptr || *item.text == '\0') {
+      continue;
+    }
+
+    const EpdFont* face = font.getFont(item.style);
+    const EpdGlyph* replacement = nullptr;
+    const auto* text = reinterpret_cast<const uint8_t*>(item.text);
+    int xpos = item.x;
+    int resolved = 0;
+    bool printable = false;
+    bool streaming = false;
+    uint32_t cp;
+    while ((cp = utf8NextCodepoint(&text))) {
+      const EpdGlyph* glyph = font.getGlyph(cp, item.style);
+      if (!glyph) {
+        if (!replacement) replacement = font.getGlyph(REPLACEMENT_GLYPH, item.style);
+        glyph = replacement;
+      }
+      // Judged on the glyph that is placed, a word of missing characters still shows its replacement glyphs
+      printable = printable || (glyph && (glyph->width > 0 || glyph->height > 0));
+
+      if (!streaming && resolved == MAX_RESOLVED_GLYPHS) {
+        for (int g = 0; g < resolved; g++) {
+          placeGlyph(face, glyphs[g], &xpos, yPos, black);
+        }
+        streaming = true;
+      }
+      if (streaming) {
+        placeGlyph(face, glyph, &xpos, yPos, black);
+      } else {
+        glyphs[resolved++] = glyph;
+      }
+    }
+
+    if (streaming || !printable) {
+      continue;
+    }
+    for (int g = 0; g < resolved; g++) {
+      placeGlyph(face, glyphs[g], &xpos, yPos, black);
+    }
+  }
+}
+
 void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const bool state) const {
-  if (x1 == x2) {
-    if (y2 < y1) {
-      std::swap(y1, y2);
+  if (x1 == x2 || y1 == y2) {
+    // Axis aligned lines are one pixel wide rectangles
+    fillRect(std::min(x1, x2), std::min(y1, y2), std::abs(x2 - x1) + 1, std::abs(y2 - y1) + 1, state);
+    return;
+  }
+
+  uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  if (!frameBuffer) {
+    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    return;
+  }
+
+  // Bresenham, pixels falling outside the panel are skipped
+  const int dx = std::abs(x2 - x1);
+  const int dy = -std::abs(y2 - y1);
+  const int stepX = x1 < x2 ? 1 : -1;
+  const int stepY = y1 < y2 ? 1 : -1;
+  int error = dx + dy;
+  while (true) {
+    int rotatedX = 0;
+    int rotatedY = 0;
+    rotateCoordinates(x1, y1, &rotatedX, &rotatedY);
+    if (rotatedX >= 0 && rotatedX < EInkDisplay::DISPLAY_WIDTH && rotatedY >= 0 &&
+        rotatedY < EInkDisplay::DISPLAY_HEIGHT) {
+      uint8_t* dst = &frameBuffer[rotatedY * EInkDisplay::DISPLAY_WIDTH_BYTES + (rotatedX >> 3)];
+      const uint8_t bit = 0x80 >> (rotatedX & 7);
+      *dst = state ? *dst & ~bit : *dst | bit;
     }
-    for (int y = y1; y <= y2; y++) {
-      drawPixel(x1, y, state);
+    if (x1 == x2 && y1 == y2) {
+      break;
     }
-  } else if (y1 == y2) {
-    if (x2 < x1) {
-      std::swap(x1, x2);
+    const int doubledError = 2 * error;
+    if (doubledError >= dy) {
+      error += dy;
+      x1 += stepX;
     }
-    for (int x = x1; x <= x2; x++) {
-      drawPixel(x, y1, state);
+    if (doubledError <= dx) {
+      error += dx;
+      y1 += stepY;
     }
-  } else {
-    // TODO: Implement
-    Serial.printf("[%lu] [GFX] Line drawing not supported\n", millis());
   }
 }
 
@@ -139,8 +248,54 @@ void GfxRenderer::drawRect(const int x, const int y, const int width, const int
 }
 
 void GfxRenderer::fillRect(const int x, const int y, const int width, const int height, const bool state) const {
-  for (int fillY = y; fillY < y + height; fillY++) {
-    drawLine(x, fillY, x + width - 1, fillY, state);
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  // Every orientation maps an axis aligned rectangle onto an axis aligned panel rectangle
+  int panelX0 = 0, panelY0 = 0, panelX1 = 0, panelY1 = 0;
+  rotateCoordinates(x, y, &panelX0, &panelY0);
+  rotateCoordinates(x + width - 1, y + height - 1, &panelX1, &panelY1);
+  if (panelX0 > panelX1) std::swap(panelX0, panelX1);
+  if (panelY0 > panelY1) std::swap(panelY0, panelY1);
+  fillPanelRect(panelX0, panelY0, panelX1, panelY1, state);
+}
+
+void GfxRenderer::fillPanelRect(int panelX0, int panelY0, int panelX1, int panelY1, const bool state) const {
+  uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  if (!frameBuffer) {
+    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    return;
+  }
+
+  if (panelX0 < 0) panelX0 = 0;
+  if (panelY0 < 0) panelY0 = 0;
+  if (panelX1 >= EInkDisplay::DISPLAY_WIDTH) panelX1 = EInkDisplay::DISPLAY_WIDTH - 1;
+  if (panelY1 >= EInkDisplay::DISPLAY_HEIGHT) panelY1 = EInkDisplay::DISPLAY_HEIGHT - 1;
+  if (panelX0 > panelX1 || panelY0 > panelY1) {
+    return;
+  }
+
+  // Partial edge bytes are masked, everything in between is written as whole bytes
+  const int firstByte = panelX0 >> 3;
+  const int lastByte = panelX1 >> 3;
+  uint8_t firstMask = 0xFF >> (panelX0 & 7);
+  const uint8_t lastMask = 0xFF << (7 - (panelX1 & 7));
+  if (firstByte == lastByte) {
+    firstMask &= lastMask;
+  }
+  const uint8_t fill = state ? 0x00 : 0xFF;
+
+  for (int panelY = panelY0; panelY <= panelY1; panelY++) {
+    uint8_t* row = &frameBuffer[panelY * EInkDisplay::DISPLAY_WIDTH_BYTES];
+    row[firstByte] = state ? row[firstByte] & ~firstMask : row[firstByte] | firstMask;
+    if (firstByte == lastByte) {
+      continue;
+    }
+    if (lastByte - firstByte > 1) {
+      memset(&row[firstByte + 1], fill, lastByte - firstByte - 1);
+    }
+    row[lastByte] = state ? row[lastByte] & ~lastMask : row[lastByte] | lastMask;
   }
 }
 
@@ -154,166 +309,209 @@ void GfxRenderer::drawImage(const uint8_t bitmap[], const int x, const int y, co
 
 void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, const int maxWidth, const int maxHeight,
                              const float cropX, const float cropY) const {
-  // For 1-bit bitmaps, use optimized 1-bit rendering path (no crop support for 1-bit)
-  if (bitmap.is1Bit() && cropX == 0.0f && cropY == 0.0f) {
-    drawBitmap1Bit(bitmap, x, y, maxWidth, maxHeight);
-    return;
-  }
-
-  float scale = 1.0f;
-  bool isScaled = false;
-  int cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
-  int cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
+  const int cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
+  const int cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
   Serial.printf("[%lu] [GFX] Cropping %dx%d by %dx%d pix, is %s\n", millis(), bitmap.getWidth(), bitmap.getHeight(),
                 cropPixX, cropPixY, bitmap.isTopDown() ? "top-down" : "bottom-up");
 
-  if (maxWidth > 0 && (1.0f - cropX) * bitmap.getWidth() > maxWidth) {
-    scale = static_cast<float>(maxWidth) / static_cast<float>((1.0f - cropX) * bitmap.getWidth());
-    isScaled = true;
+  drawBitmapScaled(bitmap, x, y, cropPixX, cropPixY, maxWidth, maxHeight);
+}
+
+// Scale as the integer ratio scaleNum / scaleDen (never above 1), picking the tighter of the two limits
+void GfxRenderer::bitmapScale(const int srcWidth, const int srcHeight, const int maxWidth, const int maxHeight,
+                              int* scaleNum, int* scaleDen) {
+  *scaleNum = 1;
+  *scaleDen = 1;
+  if (maxWidth > 0 && srcWidth > maxWidth) {
+    *scaleNum = maxWidth;
+    *scaleDen = srcWidth;
   }
-  if (maxHeight > 0 && (1.0f - cropY) * bitmap.getHeight() > maxHeight) {
-    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>((1.0f - cropY) * bitmap.getHeight()));
-    isScaled = true;
+  if (maxHeight > 0 && srcHeight > maxHeight && maxHeight * *scaleDen < *scaleNum * srcHeight) {
+    *scaleNum = maxHeight;
+    *scaleDen = srcHeight;
   }
-  Serial.printf("[%lu] [GFX] Scaling by %f - %s\n", millis(), scale, isScaled ? "scaled" : "not scaled");
-
-  // Calculate output row size (2 bits per pixel, packed into bytes)
-  // IMPORTANT: Use int, not uint8_t, to avoid overflow for images > 1020 pixels wide
-  const int outputRowSize = (bitmap.getWidth() + 3) / 4;
-  auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
-  auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+}
 
-  if (!outputRow || !rowBytes) {
-    Serial.printf("[%lu] [GFX] !! Failed to allocate BMP row buffers\n", millis());
-    free(outputRow);
-    free(rowBytes);
+void GfxRenderer::getBitmapDrawSize(const Bitmap& bitmap, const int maxWidth, const int maxHeight, const float cropX,
+                                    const float cropY, int* width, int* height) {
+  const int srcWidth = bitmap.getWidth() - 2 * static_cast<int>(std::floor(bitmap.getWidth() * cropX / 2.0f));
+  const int srcHeight = bitmap.getHeight() - 2 * static_cast<int>(std::floor(bitmap.getHeight() * cropY / 2.0f));
+  if (srcWidth <= 0 || srcHeight <= 0) {
+    *width = 0;
+    *height = 0;
     return;
   }
+  int scaleNum, scaleDen;
+  bitmapScale(srcWidth, srcHeight, maxWidth, maxHeight, &scaleNum, &scaleDen);
+  *width = (srcWidth - 1) * scaleNum / scaleDen + 1;
+  *height = (srcHeight - 1) * scaleNum / scaleDen + 1;
+}
 
-  for (int bmpY = 0; bmpY < (bitmap.getHeight() - cropPixY); bmpY++) {
-    // The BMP's (0, 0) is the bottom-left corner (if the height is positive, top-left if negative).
-    // Screen's (0, 0) is the top-left corner.
-    int screenY = -cropPixY + (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY);
-    if (isScaled) {
-      screenY = std::floor(screenY * scale);
-    }
-    screenY += y;  // the offset should not be scaled
-    if (screenY >= getScreenHeight()) {
-      break;
-    }
-
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      Serial.printf("[%lu] [GFX] Failed to read row %d from bitmap\n", millis(), bmpY);
-      free(outputRow);
-      free(rowBytes);
-      return;
-    }
-
-    if (screenY < 0) {
-      continue;
-    }
-
-    if (bmpY < cropPixY) {
-      // Skip the row if it's outside the crop area
-      continue;
-    }
-
-    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
-      int screenX = bmpX - cropPixX;
-      if (isScaled) {
-        screenX = std::floor(screenX * scale);
-      }
-      screenX += x;  // the offset should not be scaled
-      if (screenX >= getScreenWidth()) {
-        break;
-      }
-      if (screenX < 0) {
-        continue;
-      }
-
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
-
-      if (renderMode == BW && val < 3) {
-        drawPixel(screenX, screenY);
-      } else if (renderMode == GRAYSCALE_MSB && (val == 1 || val == 2)) {
-        drawPixel(screenX, screenY, false);
-      } else if (renderMode == GRAYSCALE_LSB && val == 1) {
-        drawPixel(screenX, screenY, false);
-      }
-    }
+bool GfxRenderer::getPanelRect(const int x, const int y, const int width, const int height, int* panelX0,
+                               int* panelY0, int* panelX1, int* panelY1) const {
+  if (width <= 0 || height <= 0) {
+    return false;
   }
-
-  free(outputRow);
-  free(rowBytes);
+  rotateCoordinates(x, y, panelX0, panelY0);
+  rotateCoordinates(x + width - 1, y + height - 1, panelX1, panelY1);
+  if (*panelX0 > *panelX1) std::swap(*panelX0, *panelX1);
+  if (*panelY0 > *panelY1) std::swap(*panelY0, *panelY1);
+  *panelX0 = std::max(*panelX0, 0);
+  *panelY0 = std::max(*panelY0, 0);
+  *panelX1 = std::min(*panelX1, EInkDisplay::DISPLAY_WIDTH - 1);
+  *panelY1 = std::min(*panelY1, EInkDisplay::DISPLAY_HEIGHT - 1);
+  return *panelX0 <= *panelX1 && *panelY0 <= *panelY1;
 }
 
 void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y, const int maxWidth,
                                  const int maxHeight) const {
-  float scale = 1.0f;
-  bool isScaled = false;
-  if (maxWidth > 0 && bitmap.getWidth() > maxWidth) {
-    scale = static_cast<float>(maxWidth) / static_cast<float>(bitmap.getWidth());
-    isScaled = true;
+  drawBitmapScaled(bitmap, x, y, 0, 0, maxWidth, maxHeight);
+}
+
+void GfxRenderer::drawBitmapScaled(const Bitmap& bitmap, const int x, const int y, const int cropPixX,
+                                   const int cropPixY, const int maxWidth, const int maxHeight) const {
+  uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  if (!frameBuffer) {
+    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    return;
   }
-  if (maxHeight > 0 && bitmap.getHeight() > maxHeight) {
-    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(bitmap.getHeight()));
-    isScaled = true;
+
+  const int srcWidth = bitmap.getWidth() - 2 * cropPixX;
+  const int srcHeight = bitmap.getHeight() - 2 * cropPixY;
+  if (srcWidth <= 0 || srcHeight <= 0) {
+    return;
   }
 
-  // For 1-bit BMP, output is still 2-bit packed (for consistency with readNextRow)
-  const int outputRowSize = (bitmap.getWidth() + 3) / 4;
-  auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
+  int scaleNum, scaleDen;
+  bitmapScale(srcWidth, srcHeight, maxWidth, maxHeight, &scaleNum, &scaleDen);
+  const int dstWidth = (srcWidth - 1) * scaleNum / scaleDen + 1;
+  Serial.printf("[%lu] [GFX] Scaling by %d/%d to %dx%d\n", millis(), scaleNum, scaleDen, dstWidth,
+                (srcHeight - 1) * scaleNum / scaleDen + 1);
+
+  // Source pixels landing on the same destination pixel are averaged for gray sources. For 1-bit sources the darkest
+  // one wins so thin lines survive the downscale.
+  const bool average = !bitmap.is1Bit();
+
+  // Destination rows are collected into a tile of TILE_ROWS rows in the glyph bitmap layout (2-bit, 0 white to 3
+  // black) and written to the framebuffer through the orientation specialized glyph blitter, so portrait orientations
+  // still write whole bytes.
+  constexpr int TILE_ROWS = 8;
+  const int tileRowBytes = (dstWidth * TILE_ROWS + 3) / 4;
+  auto* outputRow = static_cast<uint8_t*>(malloc((bitmap.getWidth() + 3) / 4));
   auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+  auto* sums = static_cast<uint16_t*>(malloc(dstWidth * sizeof(uint16_t)));
+  auto* counts = static_cast<uint16_t*>(malloc(dstWidth * sizeof(uint16_t)));
+  auto* tile = static_cast<uint8_t*>(calloc(tileRowBytes, 1));
 
-  if (!outputRow || !rowBytes) {
-    Serial.printf("[%lu] [GFX] !! Failed to allocate 1-bit BMP row buffers\n", millis());
+  if (!outputRow || !rowBytes || !sums || !counts || !tile) {
+    Serial.printf("[%lu] [GFX] !! Failed to allocate BMP row buffers\n", millis());
     free(outputRow);
     free(rowBytes);
+    free(sums);
+    free(counts);
+    free(tile);
     return;
   }
 
-  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
-    // Read rows sequentially using readNextRow
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      Serial.printf("[%lu] [GFX] Failed to read row %d from 1-bit bitmap\n", millis(), bmpY);
-      free(outputRow);
-      free(rowBytes);
+  int tileTop = 0;
+  int tileFirst = TILE_ROWS;
+  int tileLast = -1;
+  const auto flushTile = [&] {
+    if (tileLast < tileFirst) {
       return;
     }
+    // Rows outside [tileFirst, tileLast] are still zero (white) and are skipped by starting the glyph lower
+    GlyphBlitter::blitGlyph(frameBuffer, static_cast<GlyphBlitter::Mapping>(orientation),
+                            static_cast<GlyphBlitter::Plane>(renderMode), true, tile, dstWidth, tileLast + 1,
+                            x, y + tileTop, true);
+    memset(tile, 0, tileRowBytes);
+    tileFirst = TILE_ROWS;
+    tileLast = -1;
+  };
+
+  int pendingRow = -1;
+  const auto emitRow = [&] {
+    if (pendingRow < 0) {
+      return;
+    }
+    // Bottom-up bitmaps deliver rows in descending order, so the tile is anchored on whichever end comes first
+    if (pendingRow < tileTop || pendingRow >= tileTop + TILE_ROWS) {
+      flushTile();
+      tileTop = bitmap.isTopDown() ? pendingRow : std::max(0, pendingRow - TILE_ROWS + 1);
+    }
+    const int tileRow = pendingRow - tileTop;
+    tileFirst = std::min(tileFirst, tileRow);
+    tileLast = std::max(tileLast, tileRow);
 
-    // Calculate screen Y based on whether BMP is top-down or bottom-up
-    const int bmpYOffset = bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY;
-    int screenY = y + (isScaled ? static_cast<int>(std::floor(bmpYOffset * scale)) : bmpYOffset);
-    if (screenY >= getScreenHeight()) {
-      continue;  // Continue reading to keep row counter in sync
+    int index = tileRow * dstWidth;
+    for (int dx = 0; dx < dstWidth; dx++, index++) {
+      if (counts[dx] == 0) {
+        continue;
+      }
+      // Bitmap rows use 0 for black and 3 for white, glyph bitmaps the other way round
+      const uint8_t value = average ? (sums[dx] + counts[dx] / 2) / counts[dx] : sums[dx];
+      tile[index >> 2] |= (3 - value) << ((3 - (index & 3)) * 2);
     }
-    if (screenY < 0) {
-      continue;
+    pendingRow = -1;
+  };
+
+  const int screenHeight = getScreenHeight();
+  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
+    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
+      Serial.printf("[%lu] [GFX] Failed to read row %d from bitmap\n", millis(), bmpY);
+      break;
     }
 
-    for (int bmpX = 0; bmpX < bitmap.getWidth(); bmpX++) {
-      int screenX = x + (isScaled ? static_cast<int>(std::floor(bmpX * scale)) : bmpX);
-      if (screenX >= getScreenWidth()) {
+    // The BMP's (0, 0) is the bottom-left corner (if the height is positive, top-left if negative).
+    // Screen's (0, 0) is the top-left corner.
+    const int srcY = (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY) - cropPixY;
+    if (srcY < 0 || srcY >= srcHeight) {
+      continue;
+    }
+    const int dstY = srcY * scaleNum / scaleDen;
+    const int screenY = y + dstY;
+    if (screenY < 0 || screenY >= screenHeight) {
+      if (bitmap.isTopDown() && screenY >= screenHeight) {
         break;
       }
-      if (screenX < 0) {
-        continue;
-      }
+      continue;
+    }
 
-      // Get 2-bit value (result of readNextRow quantization)
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+    if (dstY != pendingRow) {
+      emitRow();
+      pendingRow = dstY;
+      memset(sums, 0, dstWidth * sizeof(uint16_t));
+      memset(counts, 0, dstWidth * sizeof(uint16_t));
+    }
 
-      // For 1-bit source: 0 or 1 -> map to black (0,1,2) or white (3)
-      // val < 3 means black pixel (draw it)
-      if (val < 3) {
-        drawPixel(screenX, screenY, true);
+    // Integer DDA across the row: the destination column advances whenever the error passes the denominator
+    int dx = 0;
+    int error = 0;
+    for (int srcX = 0; srcX < srcWidth; srcX++) {
+      const int bmpX = srcX + cropPixX;
+      const uint8_t value = (outputRow[bmpX >> 2] >> (6 - ((bmpX & 3) * 2))) & 0x3;
+      if (average) {
+        sums[dx] += value;
+        counts[dx]++;
+      } else if (counts[dx] == 0 || value < sums[dx]) {
+        sums[dx] = value;
+        counts[dx] = 1;
+      }
+      error += scaleNum;
+      if (error >= scaleDen) {
+        error -= scaleDen;
+        dx++;
       }
-      // White pixels (val == 3) are not drawn (leave background)
     }
   }
+  emitRow();
+  flushTile();
 
   free(outputRow);
   free(rowBytes);
+  free(sums);
+  free(counts);
+  free(tile);
 }
 
 void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state) const {
@@ -374,10 +572,7 @@ void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoi
       if (startX < 0) startX = 0;
       if (endX >= getScreenWidth()) endX = getScreenWidth() - 1;
 
-      // Draw horizontal line
-      for (int x = startX; x <= endX; x++) {
-        drawPixel(x, scanY, state);
-      }
+      fillRect(startX, scanY, endX - startX + 1, 1, state);
     }
   }
 
@@ -399,17 +594,106 @@ void GfxRenderer::invertScreen() const {
 
 void GfxRenderer::displayBuffer(const EInkDisplay::RefreshMode refreshMode) const {
   einkDisplay.displayBuffer(refreshMode);
+  if (const uint8_t* frameBuffer = einkDisplay.getFrameBuffer()) {
+    dirtyRegion.capture(frameBuffer);
+  }
+}
+
+void GfxRenderer::displayWindow(const int x, const int y, const int width, const int height) const {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+
+  int panelX0 = 0, panelY0 = 0, panelX1 = 0, panelY1 = 0;
+  rotateCoordinates(x, y, &panelX0, &panelY0);
+  rotateCoordinates(x + width - 1, y + height - 1, &panelX1, &panelY1);
+  if (panelX0 > panelX1) std::swap(panelX0, panelX1);
+  if (panelY0 > panelY1) std::swap(panelY0, panelY1);
+
+  // The controller addresses whole bytes horizontally
+  panelX0 = std::max(0, panelX0) & ~7;
+  panelY0 = std::max(0, panelY0);
+  panelX1 = std::min(EInkDisplay::DISPLAY_WIDTH - 1, panelX1 | 7);
+  panelY1 = std::min(EInkDisplay::DISPLAY_HEIGHT - 1, panelY1);
+  if (panelX0 > panelX1 || panelY0 > panelY1) {
+    return;
+  }
+
+  einkDisplay.displayWindow(panelX0, panelY0, panelX1 - panelX0 + 1, panelY1 - panelY0 + 1);
+  // Only part of the panel was updated, the recorded frame no longer matches it
+  dirtyRegion.invalidate();
+}
+
+void GfxRenderer::flushDirtyRegion() const {
+  const uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  if (!frameBuffer) {
+    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    return;
+  }
+
+  DirtyRegion::Rect changed{};
+  if (!dirtyRegion.update(frameBuffer, &changed)) {
+    return;
+  }
+
+#ifdef DISABLE_WINDOWED_REFRESH
+  // The SDK's windowed update is experimental, builds that leave it out push the frame as displayBuffer() did
+  einkDisplay.displayBuffer(EInkDisplay::FAST_REFRESH);
+#else
+  // Past this the windowed update gains little over pushing the whole frame, which then gets the full refresh the
+  // readers use (HALF_REFRESH) to clear the ghosting of a mostly redrawn screen
+  constexpr int FULL_FLUSH_AREA = EInkDisplay::DISPLAY_WIDTH * EInkDisplay::DISPLAY_HEIGHT / 2;
+  if (changed.width * changed.height > FULL_FLUSH_AREA) {
+    einkDisplay.displayBuffer(EInkDisplay::HALF_REFRESH);
+    return;
+  }
+
+  // DirtyRegion rects are in panel coordinates with x on byte boundaries, as EInkDisplay::displayWindow expects
+  einkDisplay.displayWindow(changed.x, changed.y, changed.width, changed.height);
+#endif
 }
 
 std::string GfxRenderer::truncatedText(const int fontId, const char* text, const int maxWidth,
-                                       const EpdFontFamily::Style style) const {
-  std::string item = text;
-  int itemWidth = getTextWidth(fontId, item.c_str(), style);
-  while (itemWidth > maxWidth && item.length() > 8) {
-    item.replace(item.length() - 5, 5, "...");
-    itemWidth = getTextWidth(fontId, item.c_str(), style);
+                                       const EpdFontFamily::Style style, int* outWidth, const size_t minLength) const {
+  const int fullWidth = getTextWidth(fontId, text, style);
+  const size_t length = strlen(text);
+  if (fullWidth <= maxWidth || length <= minLength) {
+    if (outWidth) *outWidth = fullWidth;
+    return text;
   }
-  return item;
+
+  // Binary search for the longest prefix (on a UTF-8 boundary) that still fits with the ellipsis appended.
+  // The shortest prefix, which keeps the result minLength bytes long, is taken as fitting even when it overflows.
+  auto isContinuation = [text](const size_t i) { return (static_cast<uint8_t>(text[i]) & 0xC0) == 0x80; };
+  size_t shortest = minLength > 3 ? minLength - 3 : 0;
+  while (shortest < length && isContinuation(shortest)) shortest++;
+  std::string candidate;
+  size_t fits = shortest;
+  size_t tooLong = length;
+  while (tooLong - fits > 1) {
+    size_t mid = fits + (tooLong - fits) / 2;
+    while (mid > fits && isContinuation(mid)) mid--;
+    if (mid == fits) {
+      // Only one code point left between the bounds, try it whole
+      mid = fits + 1;
+      while (mid < tooLong && isContinuation(mid)) mid++;
+      if (mid == tooLong) break;
+    }
+    candidate.assign(text, mid);
+    candidate += "...";
+    if (getTextWidth(fontId, candidate.c_str(), style) <= maxWidth) {
+      fits = mid;
+    } else {
+      tooLong = mid;
+    }
+  }
+
+  // Don't leave a space dangling before the ellipsis
+  while (fits > shortest && text[fits - 1] == ' ') fits--;
+  candidate.assign(text, fits);
+  candidate += "...";
+  if (outWidth) *outWidth = getTextWidth(fontId, candidate.c_str(), style);
+  return candidate;
 }
 
 // Note: Internal driver treats screen in command orientation; this library exposes a logical orientation
@@ -590,13 +874,12 @@ void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y
     }
 
     const int is2Bit = font.getData(style)->is2Bit;
-    const uint32_t offset = glyph->dataOffset;
     const uint8_t width = glyph->width;
     const uint8_t height = glyph->height;
     const int left = glyph->left;
     const int top = glyph->top;
 
-    const uint8_t* bitmap = &font.getData(style)->bitmap[offset];
+    const uint8_t* bitmap = font.getFont(style)->getGlyphBitmap(glyph);
 
     if (bitmap != nullptr) {
       for (int glyphY = 0; glyphY < height; glyphY++) {
@@ -634,7 +917,7 @@ void GfxRenderer::drawTextRotated90CW(const int fontId, const int x, const int y
     }
 
     // Move to next character position (going up, so decrease Y)
-    yPos -= glyph->advanceX;
+    yPos -= font.getFont(style)->getAdvanceX(glyph);
   }
 }
 
@@ -648,7 +931,11 @@ void GfxRenderer::copyGrayscaleLsbBuffers() const { einkDisplay.copyGrayscaleLsb
 
 void GfxRenderer::copyGrayscaleMsbBuffers() const { einkDisplay.copyGrayscaleMsbBuffers(einkDisplay.getFrameBuffer()); }
 
-void GfxRenderer::displayGrayBuffer() const { einkDisplay.displayGrayBuffer(); }
+void GfxRenderer::displayGrayBuffer() const {
+  einkDisplay.displayGrayBuffer();
+  // The panel now shows the gray planes rather than the BW frame that was recorded
+  dirtyRegion.invalidate();
+}
 
 void GfxRenderer::freeBwBufferChunks() {
   for (auto& bwBufferChunk : bwBufferChunks) {
@@ -770,54 +1057,76 @@ void GfxRenderer::renderChar(const EpdFontFamily& fontFamily, const uint32_t cp,
     return;
   }
 
-  const int is2Bit = fontFamily.getData(style)->is2Bit;
-  const uint32_t offset = glyph->dataOffset;
-  const uint8_t width = glyph->width;
-  const uint8_t height = glyph->height;
-  const int left = glyph->left;
-
-  const uint8_t* bitmap = nullptr;
-  bitmap = &fontFamily.getData(style)->bitmap[offset];
-
-  if (bitmap != nullptr) {
-    for (int glyphY = 0; glyphY < height; glyphY++) {
-      const int screenY = *y - glyph->top + glyphY;
-      for (int glyphX = 0; glyphX < width; glyphX++) {
-        const int pixelPosition = glyphY * width + glyphX;
-        const int screenX = *x + left + glyphX;
-
-        if (is2Bit) {
-          const uint8_t byte = bitmap[pixelPosition / 4];
-          const uint8_t bit_index = (3 - pixelPosition % 4) * 2;
-          // the direct bit from the font is 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black
-          // we swap this to better match the way images and screen think about colors:
-          // 0 -> black, 1 -> dark grey, 2 -> light grey, 3 -> white
-          const uint8_t bmpVal = 3 - (byte >> bit_index) & 0x3;
-
-          if (renderMode == BW && bmpVal < 3) {
-            // Black (also paints over the grays in BW mode)
-            drawPixel(screenX, screenY, pixelState);
-          } else if (renderMode == GRAYSCALE_MSB && (bmpVal == 1 || bmpVal == 2)) {
-            // Light gray (also mark the MSB if it's going to be a dark gray too)
-            // We have to flag pixels in reverse for the gray buffers, as 0 leave alone, 1 update
-            drawPixel(screenX, screenY, false);
-          } else if (renderMode == GRAYSCALE_LSB && bmpVal == 1) {
-            // Dark gray
-            drawPixel(screenX, screenY, false);
-          }
-        } else {
-          const uint8_t byte = bitmap[pixelPosition / 8];
-          const uint8_t bit_index = 7 - (pixelPosition % 8);
+  placeGlyph(fontFamily.getFont(style), glyph, x, *y, pixelState);
+}
 
-          if ((byte >> bit_index) & 1) {
-            drawPixel(screenX, screenY, pixelState);
-          }
-        }
-      }
+void GfxRenderer::placeGlyph(const EpdFont* font, const EpdGlyph* glyph, int* x, const int y,
+                             const bool pixelState) const {
+  if (!glyph) {
+    return;
+  }
+
+  drawGlyphBitmap(font, glyph, *x + glyph->left, y - glyph->top, pixelState);
+  *x += font->getAdvanceX(glyph);
+}
+
+void GfxRenderer::drawGlyphBitmap(const EpdFont* font, const EpdGlyph* glyph, const int originX, const int originY,
+                                  const bool pixelState) const {
+  uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  if (!frameBuffer) {
+    Serial.printf("[%lu] [GFX] !! No framebuffer\n", millis());
+    return;
+  }
+
+  const auto mapping = static_cast<GlyphBlitter::Mapping>(orientation);
+  const auto plane = static_cast<GlyphBlitter::Plane>(renderMode);
+  const EpdFontData* fontData = font->data;
+
+  // Synthesized styles draw a widened box, shifted to keep the glyph's pen position
+  int left = glyph->left;
+  int width = glyph->width;
+  if (font->synthesis) {
+    font->getGlyphBox(glyph, &left, &width);
+  }
+  const int x = originX - glyph->left + left;
+
+  // Glyphs already rotated into panel rows are copied a byte at a time
+  bool useAtlas = GlyphAtlas::fitsPanel(mapping, width, glyph->height, x, originY);
+  const auto atlasPlane = fontData->is2Bit ? plane : GlyphBlitter::PLANE_BW;
+  if (useAtlas) {
+    if (const GlyphAtlas::Entry* entry = glyphAtlas.find(font, glyph, mapping, atlasPlane)) {
+      glyphAtlas.blit(frameBuffer, *entry, fontData->is2Bit, x, originY, pixelState);
+      return;
     }
   }
 
-  *x += glyph->advanceX;
+  // Synthesized styles are rendered into a scratch bitmap first, oversized glyphs fall back to the plain face
+  constexpr size_t MAX_SYNTHESIZED_GLYPH_BYTES = 1024;
+  uint8_t synthesized[MAX_SYNTHESIZED_GLYPH_BYTES];
+  const uint8_t* bitmap;
+  if (font->synthesis && font->synthesizeGlyph(glyph, synthesized, sizeof(synthesized))) {
+    bitmap = synthesized;
+  } else {
+    bitmap = font->getGlyphBitmap(glyph);
+    // The atlas keeps the synthesized look of a font's glyphs, not this fallback
+    useAtlas = useAtlas && !font->synthesis;
+    left = glyph->left;
+    width = glyph->width;
+  }
+  if (!bitmap) {
+    return;
+  }
+  const int drawX = originX - glyph->left + left;
+
+  if (useAtlas && width > 0 && glyph->height > 0) {
+    if (const GlyphAtlas::Entry* entry =
+            glyphAtlas.insert(font, glyph, mapping, atlasPlane, fontData->is2Bit, bitmap, width, glyph->height)) {
+      glyphAtlas.blit(frameBuffer, *entry, fontData->is2Bit, drawX, originY, pixelState);
+      return;
+    }
+  }
+  GlyphBlitter::blitGlyph(frameBuffer, mapping, plane, fontData->is2Bit, bitmap, width, glyph->height, drawX, originY,
+                          pixelState);
 }
 
 void GfxRenderer::getOrientedViewableTRBL(int* outTop, int* outRight, int* outBottom, int* outLeft) const {
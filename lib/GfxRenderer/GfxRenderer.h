@@ -6,6 +6,8 @@
 #include <map>
 
 #include "Bitmap.h"
+#include "DirtyRegion.h"
+#include "GlyphAtlas.h"
 
 class GfxRenderer {
  public:
@@ -30,8 +32,19 @@ class GfxRenderer {
   Orientation orientation;
   uint8_t* bwBufferChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
   std::map<int, EpdFontFamily> fontMap;
+  // Mutable so the const display calls can record what the panel shows
+  mutable DirtyRegion dirtyRegion;
+  // Glyphs pre-rotated for the current orientation, filled while drawing
+  mutable GlyphAtlas glyphAtlas;
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, const int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
+  void placeGlyph(const EpdFont* font, const EpdGlyph* glyph, int* x, int y, bool pixelState) const;
+  void drawGlyphBitmap(const EpdFont* font, const EpdGlyph* glyph, int originX, int originY, bool pixelState) const;
+  // Fills an inclusive panel space rectangle, clipped to the panel
+  void fillPanelRect(int panelX0, int panelY0, int panelX1, int panelY1, bool state) const;
+  void drawBitmapScaled(const Bitmap& bitmap, int x, int y, int cropPixX, int cropPixY, int maxWidth,
+                        int maxHeight) const;
+  static void bitmapScale(int srcWidth, int srcHeight, int maxWidth, int maxHeight, int* scaleNum, int* scaleDen);
   void freeBwBufferChunks();
   void rotateCoordinates(int x, int y, int* rotatedX, int* rotatedY) const;
 
@@ -57,6 +70,11 @@ class GfxRenderer {
   void displayBuffer(EInkDisplay::RefreshMode refreshMode = EInkDisplay::FAST_REFRESH) const;
   // EXPERIMENTAL: Windowed update - display only a rectangular region
   void displayWindow(int x, int y, int width, int height) const;
+  // Pushes only the part of the framebuffer that changed since the last display call, falling back to a full
+  // (HALF_REFRESH) displayBuffer when nothing was displayed yet or the change covers most of the panel.
+  // Relies on the SDK's experimental EInkDisplay::displayWindow; build with DISABLE_WINDOWED_REFRESH to always push
+  // the whole frame with a fast refresh instead.
+  void flushDirtyRegion() const;
   void invertScreen() const;
   void clearScreen(uint8_t color = 0xFF) const;
 
@@ -69,6 +87,9 @@ class GfxRenderer {
   void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0,
                   float cropY = 0) const;
   void drawBitmap1Bit(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight) const;
+  // Size drawBitmap gives the bitmap on screen for the same arguments
+  static void getBitmapDrawSize(const Bitmap& bitmap, int maxWidth, int maxHeight, float cropX, float cropY,
+                                int* width, int* height);
   void fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state = true) const;
 
   // Text
@@ -80,8 +101,23 @@ class GfxRenderer {
   int getSpaceWidth(int fontId) const;
   int getFontAscenderSize(int fontId) const;
   int getLineHeight(int fontId) const;
+  // Longest prefix of text that fits in maxWidth with "..." appended (text itself if it fits), found by binary search
+  // over prefix widths. Text of up to minLength bytes is kept whole and shorter results are not made, even if they
+  // overflow maxWidth. outWidth receives the width of the result.
   std::string truncatedText(int fontId, const char* text, int maxWidth,
-                            EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
+                            EpdFontFamily::Style style = EpdFontFamily::REGULAR, int* outWidth = nullptr,
+                            size_t minLength = 8) const;
+
+  // Text runs: one font lookup for many words, e.g. a line or a whole page
+  struct TextRunItem {
+    int x;
+    const char* text;
+    EpdFontFamily::Style style;
+  };
+  // Returns nullptr (and logs) if the font is not registered
+  const EpdFontFamily* getFontFamily(int fontId) const;
+  // Draws every item on the line whose top is at y, same placement as drawText per item
+  void drawRun(const EpdFontFamily& font, int y, const TextRunItem* items, size_t count, bool black = true) const;
 
   // UI Components
   void drawButtonHints(int fontId, const char* btn1, const char* btn2, const char* btn3, const char* btn4);
@@ -96,6 +132,7 @@ class GfxRenderer {
  public:
   // Grayscale functions
   void setRenderMode(const RenderMode mode) { this->renderMode = mode; }
+  RenderMode getRenderMode() const { return renderMode; }
   void copyGrayscaleLsbBuffers() const;
   void copyGrayscaleMsbBuffers() const;
   void displayGrayBuffer() const;
@@ -105,6 +142,9 @@ class GfxRenderer {
 
   // Low level functions
   uint8_t* getFrameBuffer() const;
+  // Inclusive panel space rectangle covered by a logical rectangle, clipped to the panel. False if nothing is left.
+  bool getPanelRect(int x, int y, int width, int height, int* panelX0, int* panelY0, int* panelX1,
+                    int* panelY1) const;
   static size_t getBufferSize();
   void grayscaleRevert() const;
   void getOrientedViewableTRBL(int* outTop, int* outRight, int* outBottom, int* outLeft) const;
@@ -0,0 +1,223 @@
+#include "GlyphAtlas.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using GlyphBlitter::Mapping;
+using GlyphBlitter::Plane;
+
+namespace {
+bool sampleGlyph(const bool is2Bit, const Plane plane, const uint8_t* bitmap, const int index) {
+  if (!is2Bit) {
+    return GlyphBlitter::samplePixel<false, GlyphBlitter::PLANE_BW>(bitmap, index);
+  }
+  switch (plane) {
+    case GlyphBlitter::PLANE_GRAY_LSB:
+      return GlyphBlitter::samplePixel<true, GlyphBlitter::PLANE_GRAY_LSB>(bitmap, index);
+    case GlyphBlitter::PLANE_GRAY_MSB:
+      return GlyphBlitter::samplePixel<true, GlyphBlitter::PLANE_GRAY_MSB>(bitmap, index);
+    case GlyphBlitter::PLANE_BW:
+    default:
+      return GlyphBlitter::samplePixel<true, GlyphBlitter::PLANE_BW>(bitmap, index);
+  }
+}
+}  // namespace
+
+GlyphAtlas::~GlyphAtlas() {
+  free(arena);
+  free(table);
+}
+
+void GlyphAtlas::panelOrigin(const Mapping mapping, const int panelWidth, const int panelHeight, const int originX,
+                             const int originY, int* panelX, int* panelY) {
+  switch (mapping) {
+    case GlyphBlitter::PORTRAIT:
+      *panelX = originY;
+      *panelY = GlyphBlitter::PANEL_HEIGHT - originX - panelHeight;
+      break;
+    case GlyphBlitter::LANDSCAPE_CW:
+      *panelX = GlyphBlitter::PANEL_WIDTH - originX - panelWidth;
+      *panelY = GlyphBlitter::PANEL_HEIGHT - originY - panelHeight;
+      break;
+    case GlyphBlitter::PORTRAIT_INVERTED:
+      *panelX = GlyphBlitter::PANEL_WIDTH - originY - panelWidth;
+      *panelY = originX;
+      break;
+    case GlyphBlitter::LANDSCAPE_CCW:
+    default:
+      *panelX = originX;
+      *panelY = originY;
+      break;
+  }
+}
+
+bool GlyphAtlas::fitsPanel(const Mapping mapping, const int width, const int height, const int originX,
+                           const int originY) {
+  const bool rotated = mapping == GlyphBlitter::PORTRAIT || mapping == GlyphBlitter::PORTRAIT_INVERTED;
+  const int panelWidth = rotated ? height : width;
+  const int panelHeight = rotated ? width : height;
+  int panelX, panelY;
+  panelOrigin(mapping, panelWidth, panelHeight, originX, originY, &panelX, &panelY);
+  return panelX >= 0 && panelX + panelWidth <= GlyphBlitter::PANEL_WIDTH;
+}
+
+uint16_t GlyphAtlas::hash(const void* font, const void* glyph, const Plane plane) {
+  const auto value = reinterpret_cast<uintptr_t>(glyph) ^ (reinterpret_cast<uintptr_t>(font) >> 4);
+  const auto mixed = static_cast<uint32_t>(value ^ (value >> 16)) * 0x9E3779B1u;
+  return static_cast<uint16_t>(((mixed >> 16) + plane) & (TABLE_SIZE - 1));
+}
+
+void GlyphAtlas::clear() {
+  arenaUsed = 0;
+  entryCount = 0;
+  if (table) {
+    for (uint16_t i = 0; i < TABLE_SIZE; i++) {
+      table[i] = EMPTY;
+    }
+  }
+}
+
+const GlyphAtlas::Entry* GlyphAtlas::find(const void* font, const void* glyph, const Mapping mapping,
+                                        const Plane plane) {
+  if (!table || mapping != this->mapping) {
+    misses++;
+    return nullptr;
+  }
+  for (uint16_t i = hash(font, glyph, plane);; i = (i + 1) & (TABLE_SIZE - 1)) {
+    if (table[i] == EMPTY) {
+      misses++;
+      return nullptr;
+    }
+    const Entry* entry = entryAt(table[i]);
+    if (entry->glyph == glyph && entry->font == font && entry->plane == plane) {
+      hits++;
+      return entry;
+    }
+  }
+}
+
+const GlyphAtlas::Entry* GlyphAtlas::insert(const void* font, const void* glyph, const Mapping mapping,
+                                            const Plane plane, const bool is2Bit, const uint8_t* bitmap,
+                                            const int width, const int height) {
+  const bool rotated = mapping == GlyphBlitter::PORTRAIT || mapping == GlyphBlitter::PORTRAIT_INVERTED;
+  const int panelWidth = rotated ? height : width;
+  const int panelHeight = rotated ? width : height;
+  if (panelWidth <= 0 || panelHeight <= 0 || panelWidth > UINT8_MAX || panelHeight > UINT8_MAX) {
+    return nullptr;
+  }
+  const int stride = (panelWidth + 7) / 8;
+  const size_t entrySize = (sizeof(Entry) + panelHeight * stride + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+  if (entrySize > ARENA_BYTES / 4) {
+    return nullptr;
+  }
+
+  if (!arena) {
+    arena = static_cast<uint8_t*>(malloc(ARENA_BYTES));
+    table = static_cast<uint16_t*>(malloc(sizeof(uint16_t) * TABLE_SIZE));
+    if (!arena || !table) {
+      free(arena);
+      free(table);
+      arena = nullptr;
+      table = nullptr;
+      return nullptr;
+    }
+    clear();
+  }
+  if (mapping != this->mapping || arenaUsed + entrySize > ARENA_BYTES || entryCount >= TABLE_SIZE * 3 / 4) {
+    if (entryCount > 0) {
+      resets++;
+    }
+    clear();
+    this->mapping = mapping;
+  }
+
+  auto* entry = reinterpret_cast<Entry*>(arena + arenaUsed);
+  entry->font = font;
+  entry->glyph = glyph;
+  entry->plane = plane;
+  entry->width = static_cast<uint8_t>(panelWidth);
+  entry->height = static_cast<uint8_t>(panelHeight);
+  entry->stride = static_cast<uint8_t>(stride);
+  auto* mask = reinterpret_cast<uint8_t*>(entry + 1);
+  memset(mask, 0, panelHeight * stride);
+
+  // Glyph pixel under panel pixel (column, row) of the entry, see GlyphBlitter::blit
+  for (int row = 0; row < panelHeight; row++) {
+    uint8_t* out = mask + row * stride;
+    for (int column = 0; column < panelWidth; column++) {
+      int glyphX, glyphY;
+      switch (mapping) {
+        case GlyphBlitter::PORTRAIT:
+          glyphX = width - 1 - row;
+          glyphY = column;
+          break;
+        case GlyphBlitter::LANDSCAPE_CW:
+          glyphX = width - 1 - column;
+          glyphY = height - 1 - row;
+          break;
+        case GlyphBlitter::PORTRAIT_INVERTED:
+          glyphX = row;
+          glyphY = height - 1 - column;
+          break;
+        case GlyphBlitter::LANDSCAPE_CCW:
+        default:
+          glyphX = column;
+          glyphY = row;
+          break;
+      }
+      if (sampleGlyph(is2Bit, plane, bitmap, glyphY * width + glyphX)) {
+        out[column >> 3] |= 0x80 >> (column & 7);
+      }
+    }
+  }
+
+  uint16_t i = hash(font, glyph, plane);
+  while (table[i] != EMPTY) {
+    i = (i + 1) & (TABLE_SIZE - 1);
+  }
+  table[i] = static_cast<uint16_t>(arenaUsed / alignof(Entry));
+  arenaUsed += entrySize;
+  entryCount++;
+  return entry;
+}
+
+void GlyphAtlas::blit(uint8_t* frameBuffer, const Entry& entry, const bool is2Bit, const int originX,
+                      const int originY, const bool pixelState) const {
+  // 1-bit glyphs have no gray levels, they draw with pixelState in every mode
+  const bool setBits = is2Bit && entry.plane != GlyphBlitter::PLANE_BW ? true : !pixelState;
+
+  int panelX, panelY;
+  panelOrigin(mapping, entry.width, entry.height, originX, originY, &panelX, &panelY);
+  int firstRow = 0;
+  int lastRow = entry.height - 1;
+  if (panelY < 0) firstRow = -panelY;
+  if (panelY + lastRow >= GlyphBlitter::PANEL_HEIGHT) lastRow = GlyphBlitter::PANEL_HEIGHT - 1 - panelY;
+
+  const int shift = panelX & 7;
+  const uint8_t* mask = entry.mask();
+  for (int row = firstRow; row <= lastRow; row++) {
+    uint8_t* dst = frameBuffer + (panelY + row) * GlyphBlitter::PANEL_WIDTH_BYTES + (panelX >> 3);
+    const uint8_t* src = mask + row * entry.stride;
+    if (shift == 0) {
+      for (int i = 0; i < entry.stride; i++) {
+        if (src[i]) {
+          GlyphBlitter::applyMask(dst + i, src[i], setBits);
+        }
+      }
+      continue;
+    }
+    // Bits shifted out of one mask byte carry into the next framebuffer byte. Only non-empty masks are applied, so
+    // the byte past the glyph is never touched unless the glyph reaches into it.
+    uint8_t carry = 0;
+    for (int i = 0; i < entry.stride; i++) {
+      const uint8_t bits = carry | (src[i] >> shift);
+      carry = static_cast<uint8_t>(src[i] << (8 - shift));
+      if (bits) {
+        GlyphBlitter::applyMask(dst + i, bits, setBits);
+      }
+    }
+    if (carry) {
+      GlyphBlitter::applyMask(dst + entry.stride, carry, setBits);
+    }
+  }
+}
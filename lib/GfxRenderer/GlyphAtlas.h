@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GlyphBlitter.h"
+
+// Cache of glyphs pre-rotated into panel space, built lazily the first time a glyph is drawn in a plane.
+//
+// An entry holds the glyph as the 1-bit mask it leaves on one framebuffer plane, laid out in panel rows for the current
+// orientation. Drawing it again is a shifted byte copy per panel row, whatever the orientation, instead of sampling
+// every glyph pixel through the rotation. Glyphs that are clipped horizontally by the panel edge take the
+// GlyphBlitter path.
+//
+// Entries live in one arena which is dropped as a whole when it fills up or the orientation changes. A page only
+// touches a few hundred distinct glyphs, so this rarely happens mid-page.
+//
+// Kept free of Arduino dependencies so it can be built and benchmarked on the host.
+class GlyphAtlas {
+ public:
+  static constexpr size_t ARENA_BYTES = 12 * 1024;
+  // Open addressing table, kept at most 3/4 full
+  static constexpr uint16_t TABLE_SIZE = 512;
+
+  struct Entry {
+    const void* font;
+    const void* glyph;
+    uint8_t plane;
+    uint8_t width;   // Panel pixels
+    uint8_t height;  // Panel rows
+    uint8_t stride;  // Bytes per panel row
+    // Followed by height rows of stride mask bytes
+    const uint8_t* mask() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+  };
+
+  GlyphAtlas() = default;
+  ~GlyphAtlas();
+  GlyphAtlas(const GlyphAtlas&) = delete;
+  GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+  // True if the glyph lands fully inside the panel horizontally, the only case entries are drawn for
+  static bool fitsPanel(GlyphBlitter::Mapping mapping, int width, int height, int originX, int originY);
+
+  // Entries are keyed by font, glyph and the plane the mask is for. 1-bit glyphs look the same on every plane and are
+  // always kept as PLANE_BW.
+  const Entry* find(const void* font, const void* glyph, GlyphBlitter::Mapping mapping, GlyphBlitter::Plane plane);
+  // Rotates the glyph bitmap into a new entry. Returns nullptr if the glyph is too large or no memory is available.
+  const Entry* insert(const void* font, const void* glyph, GlyphBlitter::Mapping mapping, GlyphBlitter::Plane plane,
+                      bool is2Bit, const uint8_t* bitmap, int width, int height);
+  // Draws an entry with the glyph's top-left corner at logical (originX, originY), same semantics as GlyphBlitter
+  void blit(uint8_t* frameBuffer, const Entry& entry, bool is2Bit, int originX, int originY, bool pixelState) const;
+
+  // Drops every entry, the arena stays allocated
+  void clear();
+
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t resets = 0;
+
+ private:
+  static constexpr uint16_t EMPTY = 0xFFFF;
+
+  uint8_t* arena = nullptr;
+  size_t arenaUsed = 0;
+  uint16_t* table = nullptr;
+  uint16_t entryCount = 0;
+  GlyphBlitter::Mapping mapping = GlyphBlitter::PORTRAIT;
+
+  // Panel space top-left corner of a panelWidth x panelHeight glyph drawn at logical (originX, originY)
+  static void panelOrigin(GlyphBlitter::Mapping mapping, int panelWidth, int panelHeight, int originX, int originY,
+                          int* panelX, int* panelY);
+  static uint16_t hash(const void* font, const void* glyph, GlyphBlitter::Plane plane);
+  Entry* entryAt(uint16_t offset) const { return reinterpret_cast<Entry*>(arena + offset * alignof(Entry)); }
+};
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+
+// Orientation and format specialized glyph blitters writing straight into the packed 1-bit panel framebuffer.
+//
+// Clipping is resolved once per glyph. Every panel row covered by the glyph is then walked left to right, with the
+// matching glyph pixel found by a constant source step for the orientation (+-1 along a glyph row, +-width along a
+// glyph column). Covered pixels are gathered into a byte mask which is applied to the framebuffer a byte at a time.
+//
+// Kept free of Arduino dependencies so it can be built and benchmarked on the host.
+namespace GlyphBlitter {
+
+constexpr int PANEL_WIDTH = 800;
+constexpr int PANEL_HEIGHT = 480;
+constexpr int PANEL_WIDTH_BYTES = PANEL_WIDTH / 8;
+
+// Same order as GfxRenderer::Orientation
+enum Mapping : uint8_t { PORTRAIT = 0, LANDSCAPE_CW = 1, PORTRAIT_INVERTED = 2, LANDSCAPE_CCW = 3 };
+
+// Same order as GfxRenderer::RenderMode
+enum Plane : uint8_t { PLANE_BW = 0, PLANE_GRAY_LSB = 1, PLANE_GRAY_MSB = 2 };
+
+template <bool IS_2BIT, Plane PLANE>
+inline bool samplePixel(const uint8_t* bitmap, const int index) {
+  if (!IS_2BIT) {
+    return (bitmap[index >> 3] >> (7 - (index & 7))) & 1;
+  }
+  // Font data: 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black
+  const uint8_t raw = (bitmap[index >> 2] >> ((3 - (index & 3)) * 2)) & 0x3;
+  if (PLANE == PLANE_BW) {
+    // Black, also paints over the grays
+    return raw != 0;
+  }
+  if (PLANE == PLANE_GRAY_MSB) {
+    // Both grays mark the MSB plane
+    return raw == 1 || raw == 2;
+  }
+  // Dark gray only
+  return raw == 2;
+}
+
+inline void applyMask(uint8_t* dst, const uint8_t mask, const bool setBits) {
+  if (setBits) {
+    *dst |= mask;
+  } else {
+    *dst &= static_cast<uint8_t>(~mask);
+  }
+}
+
+// Draws a glyph bitmap whose top-left corner sits at logical (originX, originY).
+// Black pixels clear framebuffer bits (pixelState true), gray planes always set bits - matching GfxRenderer::drawPixel.
+template <Mapping MAPPING, bool IS_2BIT, Plane PLANE>
+void blit(uint8_t* frameBuffer, const uint8_t* bitmap, const int width, const int height, const int originX,
+          const int originY, const bool pixelState) {
+  // 1-bit glyphs have no gray levels, they draw with pixelState in every mode
+  const bool setBits = IS_2BIT && PLANE != PLANE_BW ? true : !pixelState;
+
+  // Panel space bounding box of the glyph and the source step when moving one panel pixel to the right
+  int panelX0, panelY0, panelX1, panelY1, step;
+  switch (MAPPING) {
+    case PORTRAIT:
+      panelX0 = originY;
+      panelX1 = originY + height - 1;
+      panelY0 = PANEL_HEIGHT - originX - width;
+      panelY1 = PANEL_HEIGHT - 1 - originX;
+      step = width;
+      break;
+    case LANDSCAPE_CW:
+      panelX0 = PANEL_WIDTH - originX - width;
+      panelX1 = PANEL_WIDTH - 1 - originX;
+      panelY0 = PANEL_HEIGHT - originY - height;
+      panelY1 = PANEL_HEIGHT - 1 - originY;
+      step = -1;
+      break;
+    case PORTRAIT_INVERTED:
+      panelX0 = PANEL_WIDTH - originY - height;
+      panelX1 = PANEL_WIDTH - 1 - originY;
+      panelY0 = originX;
+      panelY1 = originX + width - 1;
+      step = -width;
+      break;
+    case LANDSCAPE_CCW:
+    default:
+      panelX0 = originX;
+      panelX1 = originX + width - 1;
+      panelY0 = originY;
+      panelY1 = originY + height - 1;
+      step = 1;
+      break;
+  }
+
+  // Clip once for the whole glyph
+  if (panelX0 < 0) panelX0 = 0;
+  if (panelY0 < 0) panelY0 = 0;
+  if (panelX1 >= PANEL_WIDTH) panelX1 = PANEL_WIDTH - 1;
+  if (panelY1 >= PANEL_HEIGHT) panelY1 = PANEL_HEIGHT - 1;
+  if (panelX0 > panelX1 || panelY0 > panelY1) {
+    return;
+  }
+
+  for (int panelY = panelY0; panelY <= panelY1; panelY++) {
+    // Glyph pixel under the first clipped panel pixel of this row
+    int glyphX, glyphY;
+    switch (MAPPING) {
+      case PORTRAIT:
+        glyphX = PANEL_HEIGHT - 1 - panelY - originX;
+        glyphY = panelX0 - originY;
+        break;
+      case LANDSCAPE_CW:
+        glyphX = PANEL_WIDTH - 1 - panelX0 - originX;
+        glyphY = PANEL_HEIGHT - 1 - panelY - originY;
+        break;
+      case PORTRAIT_INVERTED:
+        glyphX = panelY - originX;
+        glyphY = PANEL_WIDTH - 1 - panelX0 - originY;
+        break;
+      case LANDSCAPE_CCW:
+      default:
+        glyphX = panelX0 - originX;
+        glyphY = panelY - originY;
+        break;
+    }
+
+    uint8_t* dst = frameBuffer + panelY * PANEL_WIDTH_BYTES + (panelX0 >> 3);
+    uint8_t bit = 0x80 >> (panelX0 & 7);
+    uint8_t mask = 0;
+    int index = glyphY * width + glyphX;
+    for (int panelX = panelX0; panelX <= panelX1; panelX++, index += step) {
+      if (samplePixel<IS_2BIT, PLANE>(bitmap, index)) {
+        mask |= bit;
+      }
+      bit >>= 1;
+      if (!bit) {
+        if (mask) {
+          applyMask(dst, mask, setBits);
+        }
+        dst++;
+        bit = 0x80;
+        mask = 0;
+      }
+    }
+    if (mask) {
+      applyMask(dst, mask, setBits);
+    }
+  }
+}
+
+template <Mapping MAPPING, bool IS_2BIT>
+void blitPlane(uint8_t* frameBuffer, const Plane plane, const uint8_t* bitmap, const int width, const int height,
+               const int originX, const int originY, const bool pixelState) {
+  switch (plane) {
+    case PLANE_BW:
+      blit<MAPPING, IS_2BIT, PLANE_BW>(frameBuffer, bitmap, width, height, originX, originY, pixelState);
+      break;
+    case PLANE_GRAY_LSB:
+      blit<MAPPING, IS_2BIT, PLANE_GRAY_LSB>(frameBuffer, bitmap, width, height, originX, originY, pixelState);
+      break;
+    case PLANE_GRAY_MSB:
+      blit<MAPPING, IS_2BIT, PLANE_GRAY_MSB>(frameBuffer, bitmap, width, height, originX, originY, pixelState);
+      break;
+  }
+}
+
+template <Mapping MAPPING>
+void blitFormat(uint8_t* frameBuffer, const Plane plane, const bool is2Bit, const uint8_t* bitmap, const int width,
+                const int height, const int originX, const int originY, const bool pixelState) {
+  if (is2Bit) {
+    blitPlane<MAPPING, true>(frameBuffer, plane, bitmap, width, height, originX, originY, pixelState);
+  } else {
+    blitPlane<MAPPING, false>(frameBuffer, plane, bitmap, width, height, originX, originY, pixelState);
+  }
+}
+
+// Runtime dispatch onto the specialized blitters
+inline void blitGlyph(uint8_t* frameBuffer, const Mapping mapping, const Plane plane, const bool is2Bit,
+                      const uint8_t* bitmap, const int width, const int height, const int originX, const int originY,
+                      const bool pixelState) {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  switch (mapping) {
+    case PORTRAIT:
+      blitFormat<PORTRAIT>(frameBuffer, plane, is2Bit, bitmap, width, height, originX, originY, pixelState);
+      break;
+    case LANDSCAPE_CW:
+      blitFormat<LANDSCAPE_CW>(frameBuffer, plane, is2Bit, bitmap, width, height, originX, originY, pixelState);
+      break;
+    case PORTRAIT_INVERTED:
+      blitFormat<PORTRAIT_INVERTED>(frameBuffer, plane, is2Bit, bitmap, width, height, originX, originY, pixelState);
+      break;
+    case LANDSCAPE_CCW:
+      blitFormat<LANDSCAPE_CCW>(frameBuffer, plane, is2Bit, bitmap, width, height, originX, originY, pixelState);
+      break;
+  }
+}
+
+}  // namespace GlyphBlitter
@@ -0,0 +1,189 @@
+#include "PanelImage.h"
+
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include "Bitmap.h"
+#include "GfxRenderer.h"
+
+namespace {
+constexpr char CACHE_ROOT[] = "/.crosspoint/";
+constexpr char FOREIGN_CACHE_DIR[] = "/.crosspoint/sleep";
+}  // namespace
+
+PanelImage::~PanelImage() {
+  if (state == RECORDING && header.planeCount > 0) {
+    // The header goes in last, an interrupted recording is left with no planes and is redone next time
+    if (file.seek(0) && file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header)) {
+      Serial.printf("[%lu] [PIMG] Recorded %d planes of %dx%d panel pixels: %s\n", millis(), header.planeCount,
+                    header.panelX1 - header.panelX0 + 1, header.panelY1 - header.panelY0 + 1, path.c_str());
+    }
+  }
+  file.close();
+}
+
+std::string PanelImage::cachePathFor(const std::string& bmpPath, const char* use) {
+  if (bmpPath.rfind(CACHE_ROOT, 0) == 0) {
+    const size_t dot = bmpPath.rfind('.');
+    const std::string base = dot != std::string::npos && dot > bmpPath.rfind('/') ? bmpPath.substr(0, dot) : bmpPath;
+    return base + "_" + use + ".pimg";
+  }
+  return std::string(FOREIGN_CACHE_DIR) + "/" + std::to_string(std::hash<std::string>{}(bmpPath)) + "_" + use +
+         ".pimg";
+}
+
+size_t PanelImage::planeBytes() const {
+  const size_t stride = (header.panelX1 >> 3) - (header.panelX0 >> 3) + 1;
+  return stride * (header.panelY1 - header.panelY0 + 1);
+}
+
+void PanelImage::open(const Header& expected) {
+  if (SdMan.exists(path.c_str()) && SdMan.openFileForRead("PIMG", path, file)) {
+    Header stored;
+    if (file.read(reinterpret_cast<uint8_t*>(&stored), sizeof(stored)) == sizeof(stored) && stored.magic == MAGIC &&
+        stored.version == VERSION && stored.planeCount > 0 && stored.planeCount <= MAX_PLANES) {
+      // Everything but the plane list has to match what is being drawn now
+      Header compare = expected;
+      compare.planeCount = stored.planeCount;
+      memcpy(compare.planeModes, stored.planeModes, sizeof(compare.planeModes));
+      if (memcmp(&compare, &stored, sizeof(stored)) == 0) {
+        header = stored;
+        state = READING;
+        return;
+      }
+    }
+    file.close();
+    Serial.printf("[%lu] [PIMG] Cache out of date, recording again: %s\n", millis(), path.c_str());
+  }
+
+  SdMan.mkdir(path.substr(0, path.rfind('/')).c_str());
+  header = expected;
+  if (!SdMan.openFileForWrite("PIMG", path, file) ||
+      file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) != sizeof(header)) {
+    file.close();
+    state = FAILED;
+    return;
+  }
+  state = RECORDING;
+}
+
+bool PanelImage::readPlane(const int slot) {
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  if (!frameBuffer || !file.seek(sizeof(Header) + slot * planeBytes())) {
+    return false;
+  }
+
+  const int firstByte = header.panelX0 >> 3;
+  const int stride = (header.panelX1 >> 3) - firstByte + 1;
+  const int rows = header.panelY1 - header.panelY0 + 1;
+  const int chunkRows = std::min(rows, std::max(1, static_cast<int>(READ_CHUNK_BYTES) / stride));
+  auto* buffer = static_cast<uint8_t*>(malloc(chunkRows * stride));
+  if (!buffer) {
+    Serial.printf("[%lu] [PIMG] Failed to allocate read buffer\n", millis());
+    return false;
+  }
+
+  // Partial edge bytes keep the framebuffer pixels outside the image
+  uint8_t firstMask = 0xFF >> (header.panelX0 & 7);
+  const uint8_t lastMask = 0xFF << (7 - (header.panelX1 & 7));
+  if (stride == 1) {
+    firstMask &= lastMask;
+  }
+
+  bool ok = true;
+  for (int row = 0; row < rows && ok; row += chunkRows) {
+    const int count = std::min(chunkRows, rows - row);
+    if (file.read(buffer, count * stride) != count * stride) {
+      Serial.printf("[%lu] [PIMG] Short read at row %d: %s\n", millis(), row, path.c_str());
+      ok = false;
+      break;
+    }
+    for (int i = 0; i < count; i++) {
+      const uint8_t* src = buffer + i * stride;
+      uint8_t* dst = frameBuffer + (header.panelY0 + row + i) * EInkDisplay::DISPLAY_WIDTH_BYTES + firstByte;
+      dst[0] = (dst[0] & ~firstMask) | (src[0] & firstMask);
+      if (stride > 1) {
+        memcpy(dst + 1, src + 1, stride - 2);
+        dst[stride - 1] = (dst[stride - 1] & ~lastMask) | (src[stride - 1] & lastMask);
+      }
+    }
+  }
+  free(buffer);
+  return ok;
+}
+
+void PanelImage::recordPlane(const uint8_t mode) {
+  const uint8_t* recorded = header.planeModes;
+  const uint8_t* recordedEnd = recorded + header.planeCount;
+  if (header.planeCount >= MAX_PLANES || std::find(recorded, recordedEnd, mode) != recordedEnd) {
+    return;
+  }
+  const uint8_t* frameBuffer = renderer.getFrameBuffer();
+  if (!frameBuffer) {
+    return;
+  }
+
+  const int firstByte = header.panelX0 >> 3;
+  const size_t stride = (header.panelX1 >> 3) - firstByte + 1;
+  for (int panelY = header.panelY0; panelY <= header.panelY1; panelY++) {
+    if (file.write(frameBuffer + panelY * EInkDisplay::DISPLAY_WIDTH_BYTES + firstByte, stride) != stride) {
+      Serial.printf("[%lu] [PIMG] Failed to write cache, dropping it: %s\n", millis(), path.c_str());
+      file.close();
+      SdMan.remove(path.c_str());
+      state = FAILED;
+      return;
+    }
+  }
+  header.planeModes[header.planeCount++] = mode;
+}
+
+void PanelImage::drawBitmap(const Bitmap& bitmap, const int x, const int y, const int maxWidth, const int maxHeight,
+                            const float cropX, const float cropY) {
+  if (state == UNOPENED) {
+    int width, height;
+    GfxRenderer::getBitmapDrawSize(bitmap, maxWidth, maxHeight, cropX, cropY, &width, &height);
+    int panelX0, panelY0, panelX1, panelY1;
+    if (!renderer.getPanelRect(x, y, width, height, &panelX0, &panelY0, &panelX1, &panelY1)) {
+      state = FAILED;
+    } else {
+      Header expected = {};
+      expected.magic = MAGIC;
+      expected.sourceSize = bitmap.getFileSize();
+      bitmap.getModifyDateTime(&expected.sourceDate, &expected.sourceTime);
+      expected.cropX = cropX;
+      expected.cropY = cropY;
+      expected.x = static_cast<int16_t>(x);
+      expected.y = static_cast<int16_t>(y);
+      expected.maxWidth = static_cast<int16_t>(maxWidth);
+      expected.maxHeight = static_cast<int16_t>(maxHeight);
+      expected.sourceWidth = static_cast<uint16_t>(bitmap.getWidth());
+      expected.sourceHeight = static_cast<uint16_t>(bitmap.getHeight());
+      expected.panelX0 = static_cast<uint16_t>(panelX0);
+      expected.panelY0 = static_cast<uint16_t>(panelY0);
+      expected.panelX1 = static_cast<uint16_t>(panelX1);
+      expected.panelY1 = static_cast<uint16_t>(panelY1);
+      expected.version = VERSION;
+      expected.orientation = static_cast<uint8_t>(renderer.getOrientation());
+      open(expected);
+    }
+  }
+
+  const auto mode = static_cast<uint8_t>(renderer.getRenderMode());
+  if (state == READING) {
+    for (int slot = 0; slot < header.planeCount; slot++) {
+      if (header.planeModes[slot] == mode && readPlane(slot)) {
+        return;
+      }
+    }
+  }
+
+  renderer.drawBitmap(bitmap, x, y, maxWidth, maxHeight, cropX, cropY);
+  if (state == RECORDING) {
+    recordPlane(mode);
+  }
+}
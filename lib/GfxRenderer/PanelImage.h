@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SdFat.h>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+class Bitmap;
+class GfxRenderer;
+
+// Framebuffer-native cache of a bitmap drawn with GfxRenderer::drawBitmap: the panel rows it covers in each render
+// mode, already scaled, dithered and rotated.
+//
+// The first draw decodes the BMP as usual and records the rows it produced. Later draws of the same bitmap at the same
+// place and orientation read them back from the SD card straight into the framebuffer, one block of rows at a time.
+// The recording is completed when the PanelImage is destroyed. Rows are recorded over the cleared screen callers draw
+// images on, pixels beside the image in its edge bytes are left alone on playback.
+class PanelImage {
+ public:
+  PanelImage(const GfxRenderer& renderer, std::string path) : renderer(renderer), path(std::move(path)) {}
+  ~PanelImage();
+  PanelImage(const PanelImage&) = delete;
+  PanelImage& operator=(const PanelImage&) = delete;
+
+  // Cache location for bmpPath drawn for one screen (use): next to the BMP inside the book caches, under
+  // /.crosspoint/sleep for images from elsewhere on the card
+  static std::string cachePathFor(const std::string& bmpPath, const char* use);
+
+  // Same arguments and result as GfxRenderer::drawBitmap in the renderer's current render mode
+  void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0, float cropY = 0);
+
+ private:
+  static constexpr uint32_t MAGIC = 0x474D4950;  // "PIMG"
+  static constexpr uint8_t VERSION = 2;
+  static constexpr int MAX_PLANES = 3;
+  static constexpr size_t READ_CHUNK_BYTES = 4096;
+
+  struct Header {
+    uint32_t magic;
+    uint32_t sourceSize;
+    // FAT modification stamp of the BMP, a replaced image of the same size and dimensions still differs here
+    uint16_t sourceDate;
+    uint16_t sourceTime;
+    float cropX;
+    float cropY;
+    int16_t x;
+    int16_t y;
+    int16_t maxWidth;
+    int16_t maxHeight;
+    uint16_t sourceWidth;
+    uint16_t sourceHeight;
+    // Inclusive panel rectangle, rows are stored from the byte holding panelX0 to the one holding panelX1
+    uint16_t panelX0;
+    uint16_t panelY0;
+    uint16_t panelX1;
+    uint16_t panelY1;
+    uint8_t version;
+    uint8_t orientation;
+    uint8_t planeCount;
+    uint8_t planeModes[MAX_PLANES];  // Render mode of each stored plane, in file order
+    uint16_t reserved;
+  };
+  static_assert(sizeof(Header) == 48, "PanelImage header layout changed");
+
+  enum State { UNOPENED, READING, RECORDING, FAILED };
+
+  const GfxRenderer& renderer;
+  std::string path;
+  FsFile file;
+  State state = UNOPENED;
+  Header header = {};
+
+  void open(const Header& expected);
+  size_t planeBytes() const;
+  bool readPlane(int slot);
+  void recordPlane(uint8_t mode);
+};
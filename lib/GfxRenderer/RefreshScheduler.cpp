@@ -0,0 +1,55 @@
+#include "RefreshScheduler.h"
+
+#include <EInkDisplay.h>
+
+static_assert(RefreshScheduler::PANEL_WIDTH_BYTES == EInkDisplay::DISPLAY_WIDTH_BYTES &&
+                  RefreshScheduler::PANEL_HEIGHT == EInkDisplay::DISPLAY_HEIGHT,
+              "Refresh scheduler panel geometry does not match the display");
+static_assert(RefreshScheduler::PANEL_HEIGHT % RefreshScheduler::CELL_ROWS == 0,
+              "Refresh scheduler cells must tile the panel height");
+
+bool RefreshScheduler::update(const uint8_t* frameBuffer, const int pagesPerRefresh) {
+  uint32_t transitions = 0;
+
+  // One band of cells at a time keeps the scratch space off the render task's stack budget
+  for (int band = 0; band < PANEL_HEIGHT / CELL_ROWS; band++) {
+    uint8_t counts[PANEL_WIDTH_BYTES] = {};
+    uint32_t hashes[PANEL_WIDTH_BYTES] = {};
+    for (int y = band * CELL_ROWS; y < (band + 1) * CELL_ROWS; y++) {
+      const uint8_t* row = frameBuffer + y * PANEL_WIDTH_BYTES;
+      for (int x = 0; x < PANEL_WIDTH_BYTES; x++) {
+        // Black pixels are cleared bits
+        counts[x] += 8 - __builtin_popcount(row[x]);
+        hashes[x] = hashes[x] * 31 + row[x];
+      }
+    }
+
+    uint8_t* previousCounts = cellBlackCounts + band * PANEL_WIDTH_BYTES;
+    uint8_t* previousSignatures = cellSignatures + band * PANEL_WIDTH_BYTES;
+    for (int x = 0; x < PANEL_WIDTH_BYTES; x++) {
+      const uint32_t hash = hashes[x];
+      const auto signature = static_cast<uint8_t>(hash ^ (hash >> 8) ^ (hash >> 16) ^ (hash >> 24));
+      const uint32_t before = previousCounts[x];
+      const uint32_t after = counts[x];
+      const uint32_t drop = before > after ? before - after : 0;
+      if (signature == previousSignatures[x]) {
+        // Unchanged, barring a signature collision that the count still shows
+        transitions += drop;
+      } else {
+        const uint32_t independent = before * (CELL_PIXELS - after) / CELL_PIXELS;
+        transitions += independent > drop ? independent : drop;
+      }
+      previousCounts[x] = counts[x];
+      previousSignatures[x] = signature;
+    }
+  }
+
+  ghostingScore += transitions;
+  const uint32_t budget = static_cast<uint32_t>(pagesPerRefresh > 1 ? pagesPerRefresh : 1) * TEXT_PAGE_SCORE;
+  if (fullRefreshRequested || pagesPerRefresh <= 1 || ghostingScore >= budget) {
+    fullRefreshRequested = false;
+    ghostingScore = 0;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Decides when a reader page needs a full (HALF_REFRESH) update from the ghosting that fast refreshes leave behind.
+//
+// Ghosting comes mostly from pixels going black to white. The outgoing frame is not kept, so each frame is summarized
+// per cell of 8x16 panel pixels as its black pixel count and an 8-bit signature of its contents (6KB). A cell with an
+// unchanged signature has no transitions. For a changed cell the old and new black pixels are taken as independently
+// placed, so old * (white share of new) of them turn white, but never fewer than the drop in its count. These are
+// accumulated into a score, and a full refresh is due once the score reaches the configured number of pages worth of
+// turnover of a page of body text. Sparse pages therefore get more fast refreshes and dense or image pages get cleaned
+// sooner.
+class RefreshScheduler {
+ public:
+  static constexpr int PANEL_WIDTH_BYTES = 100;
+  static constexpr int PANEL_HEIGHT = 480;
+  static constexpr int CELL_ROWS = 16;
+  static constexpr int CELL_PIXELS = 8 * CELL_ROWS;
+  static constexpr int CELL_COUNT = PANEL_WIDTH_BYTES * (PANEL_HEIGHT / CELL_ROWS);
+  // Score of turning one full page of body text to the next, measured on Bookerly 14 (about 34000 exact transitions)
+  static constexpr uint32_t TEXT_PAGE_SCORE = 38000;
+
+  // Makes the next frame a full refresh, e.g. after an overlay or when opening a book
+  void requestFullRefresh() { fullRefreshRequested = true; }
+
+  // Records the frame about to be displayed and returns true if it should get a full refresh.
+  // pagesPerRefresh is the setting's number of text pages between full refreshes, 1 refreshes every frame.
+  bool update(const uint8_t* frameBuffer, int pagesPerRefresh);
+
+ private:
+  uint8_t cellBlackCounts[CELL_COUNT] = {};
+  uint8_t cellSignatures[CELL_COUNT] = {};
+  uint32_t ghostingScore = 0;
+  bool fullRefreshRequested = true;
+};
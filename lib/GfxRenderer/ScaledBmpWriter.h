@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+class Print;
+class AtkinsonDitherer;
+class FloydSteinbergDitherer;
+class Atkinson1BitDitherer;
+
+// Streams 8-bit grayscale source rows into a BMP for the cover and thumbnail caches: area-averages them down to the
+// output size, then dithers to 2-bit (or 1-bit) as they arrive. Only one output row of accumulators is kept, so image
+// decoders can hand over rows as they decode them.
+//
+// Shared by the JPEG and PNG converters so every cover format gets the same prescale and dithering.
+class ScaledBmpWriter {
+ public:
+  // Output size for a srcWidth x srcHeight image scaled to cover targetWidth x targetHeight, keeping the aspect ratio.
+  // Returns the scale, 1 when the image fits already or no target is given.
+  static float fitToTarget(int srcWidth, int srcHeight, int targetWidth, int targetHeight, int* outWidth,
+                           int* outHeight);
+
+  ScaledBmpWriter(Print& bmpOut, bool oneBit) : bmpOut(bmpOut), oneBit(oneBit) {}
+  ~ScaledBmpWriter();
+  ScaledBmpWriter(const ScaledBmpWriter&) = delete;
+  ScaledBmpWriter& operator=(const ScaledBmpWriter&) = delete;
+
+  // Writes the BMP header and allocates the row state. The source may be smaller than the output (e.g. a DC-only JPEG
+  // decode), rows are then repeated.
+  bool begin(int srcWidth, int srcHeight, int outWidth, int outHeight);
+  // Takes the next source row of srcWidth gray pixels, top to bottom
+  void writeRow(const uint8_t* gray);
+
+ private:
+  Print& bmpOut;
+  bool oneBit;
+  int srcWidth = 0;
+  int srcHeight = 0;
+  int outWidth = 0;
+  int outHeight = 0;
+  int bytesPerRow = 0;
+  bool needsScaling = false;
+  // Fixed point 16.16 source pixels per output pixel
+  uint32_t scaleX_fp = 65536;
+  uint32_t scaleY_fp = 65536;
+  int srcY = 0;
+  int currentOutY = 0;
+  uint32_t nextOutY_srcStart = 0;  // Source Y where next output row starts (16.16 fixed point)
+
+  uint8_t* rowBuffer = nullptr;
+  uint8_t* grayRow = nullptr;  // Adjusted gray values of the output row, for ordered dithering
+  uint32_t* rowAccum = nullptr;  // Accumulator for each output X (32-bit for larger sums)
+  uint16_t* rowCount = nullptr;  // Count of source pixels accumulated per output X
+  AtkinsonDitherer* atkinsonDitherer = nullptr;
+  FloydSteinbergDitherer* fsDitherer = nullptr;
+  Atkinson1BitDitherer* atkinson1BitDitherer = nullptr;
+
+  // Dithers one row of output gray values (gray(x) for x in 0..outWidth) into rowBuffer and writes it
+  template <typename GrayAt>
+  void emitRow(GrayAt grayAt, int y);
+};
@@ -52,13 +52,7 @@ CrossPointPosition ProgressMapper::toCrossPoint(const std::shared_ptr<Epub>& epu
     const size_t targetBytes = static_cast<size_t>(bookSize * koPos.percentage);
 
     // Find the spine item that contains this byte position
-    for (int i = 0; i < epub->getSpineItemsCount(); i++) {
-      const size_t cumulativeSize = epub->getCumulativeSpineItemSize(i);
-      if (cumulativeSize >= targetBytes) {
-        result.spineIndex = i;
-        break;
-      }
-    }
+    result.spineIndex = epub->getSpineIndexForBookOffset(targetBytes);
 
     // Estimate page number within the spine item using percentage (only when no XPath)
     if (totalPagesInSpine > 0 && result.spineIndex < epub->getSpineItemsCount()) {
@@ -0,0 +1,489 @@
+#include "PngToBmpConverter.h"
+
+#include <HardwareSerial.h>
+#include <SdFat.h>
+#include <miniz.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "ScaledBmpWriter.h"
+
+namespace {
+// Max size for cover images (portrait display size)
+constexpr int TARGET_MAX_WIDTH = 480;
+constexpr int TARGET_MAX_HEIGHT = 800;
+
+// Safety limits to prevent memory issues on ESP32, two rows are kept
+constexpr uint32_t MAX_IMAGE_WIDTH = 4096;
+constexpr uint32_t MAX_IMAGE_HEIGHT = 8192;
+constexpr size_t MAX_ROW_BYTES = 16384;
+constexpr size_t INPUT_BUFFER_SIZE = 1024;
+
+constexpr uint8_t PNG_SIGNATURE[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+
+enum ColorType : uint8_t { GRAY = 0, RGB = 2, PALETTE = 3, GRAY_ALPHA = 4, RGBA = 6 };
+
+uint32_t readU32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+// Same weights as the JPEG converter
+uint8_t luminance(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+
+// Transparent pixels show the white page
+uint8_t onWhite(const int gray, const int alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+uint8_t paethPredictor(const int a, const int b, const int c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a);
+  const int pb = abs(p - b);
+  const int pc = abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  if (pb <= pc) return b;
+  return c;
+}
+
+class PngDecoder {
+ public:
+  explicit PngDecoder(FsFile& file) : file(file) {}
+  ~PngDecoder() {
+    free(input);
+    free(inflator);
+    free(window);
+    free(rows[0]);
+    free(rows[1]);
+    free(grayRow);
+  }
+  PngDecoder(const PngDecoder&) = delete;
+  PngDecoder& operator=(const PngDecoder&) = delete;
+
+  // Reads the chunks up to the first IDAT
+  bool readHeader();
+  // Inflates the image data a row at a time into writer
+  bool decode(ScaledBmpWriter& writer);
+
+  uint32_t width = 0;
+  uint32_t height = 0;
+
+ private:
+  FsFile& file;
+  uint8_t bitDepth = 0;
+  uint8_t colorType = 0;
+  uint8_t channels = 0;
+  size_t rowBytes = 0;
+  // Distance to the corresponding byte of the previous pixel, for the filters
+  int filterStride = 1;
+  uint8_t paletteGray[256] = {};
+  bool hasPalette = false;
+  // tRNS color key of gray and RGB images, compared against the raw samples
+  bool hasColorKey = false;
+  uint16_t colorKey[3] = {};
+
+  // IDAT chunks form one zlib stream
+  uint32_t chunkRemaining = 0;
+  bool idatDone = false;
+  bool readError = false;
+  uint8_t* input = nullptr;
+  size_t inputPos = 0;
+  size_t inputFilled = 0;
+
+  tinfl_decompressor* inflator = nullptr;
+  uint8_t* window = nullptr;
+  // Current and previous row, each with the filter type byte in front
+  uint8_t* rows[2] = {nullptr, nullptr};
+  uint8_t* grayRow = nullptr;
+
+  bool readChunkHeader(uint32_t* length, uint8_t type[4]);
+  bool readChunkData(uint8_t* buffer, uint32_t length);
+  bool readIhdr(uint32_t length);
+  bool fillInput();
+  bool unfilter(uint8_t* row, const uint8_t* previous, uint8_t filter) const;
+  uint16_t sample(const uint8_t* row, uint32_t index) const;
+  void toGray(const uint8_t* row, uint8_t* out) const;
+};
+
+bool PngDecoder::readChunkHeader(uint32_t* length, uint8_t type[4]) {
+  uint8_t header[8];
+  if (file.read(header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  *length = readU32(header);
+  memcpy(type, header + 4, 4);
+  return *length <= 0x7FFFFFFF;
+}
+
+// Reads the chunk data and skips the CRC
+bool PngDecoder::readChunkData(uint8_t* buffer, const uint32_t length) {
+  return file.read(buffer, length) == static_cast<int>(length) && file.seekCur(4);
+}
+
+bool PngDecoder::readIhdr(const uint32_t length) {
+  uint8_t ihdr[13];
+  if (length != sizeof(ihdr) || !readChunkData(ihdr, length)) {
+    return false;
+  }
+  width = readU32(ihdr);
+  height = readU32(ihdr + 4);
+  bitDepth = ihdr[8];
+  colorType = ihdr[9];
+
+  Serial.printf("[%lu] [PNG] PNG dimensions: %lux%lu, color type: %d, bit depth: %d\n", millis(),
+                static_cast<unsigned long>(width), static_cast<unsigned long>(height), colorType, bitDepth);
+
+  bool validDepth;
+  switch (colorType) {
+    case GRAY:
+      channels = 1;
+      validDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+      break;
+    case PALETTE:
+      channels = 1;
+      validDepth = bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+      break;
+    case RGB:
+    case GRAY_ALPHA:
+    case RGBA:
+      channels = colorType == RGB ? 3 : colorType == GRAY_ALPHA ? 2 : 4;
+      validDepth = bitDepth == 8 || bitDepth == 16;
+      break;
+    default:
+      validDepth = false;
+      break;
+  }
+  if (!validDepth || ihdr[10] != 0 || ihdr[11] != 0) {
+    Serial.printf("[%lu] [PNG] Unsupported PNG format\n", millis());
+    return false;
+  }
+  if (ihdr[12] != 0) {
+    Serial.printf("[%lu] [PNG] Interlaced PNG not supported\n", millis());
+    return false;
+  }
+  if (width == 0 || height == 0 || width > MAX_IMAGE_WIDTH || height > MAX_IMAGE_HEIGHT) {
+    Serial.printf("[%lu] [PNG] Image too large, max supported: %lux%lu\n", millis(),
+                  static_cast<unsigned long>(MAX_IMAGE_WIDTH), static_cast<unsigned long>(MAX_IMAGE_HEIGHT));
+    return false;
+  }
+
+  const uint32_t bitsPerPixel = channels * bitDepth;
+  rowBytes = (width * bitsPerPixel + 7) / 8;
+  filterStride = bitsPerPixel < 8 ? 1 : static_cast<int>(bitsPerPixel / 8);
+  if (rowBytes > MAX_ROW_BYTES) {
+    Serial.printf("[%lu] [PNG] Row too large (%d bytes), max: %d\n", millis(), static_cast<int>(rowBytes),
+                  static_cast<int>(MAX_ROW_BYTES));
+    return false;
+  }
+  return true;
+}
+
+bool PngDecoder::readHeader() {
+  uint8_t signature[sizeof(PNG_SIGNATURE)];
+  if (file.read(signature, sizeof(signature)) != sizeof(signature) ||
+      memcmp(signature, PNG_SIGNATURE, sizeof(signature)) != 0) {
+    Serial.printf("[%lu] [PNG] Not a PNG file\n", millis());
+    return false;
+  }
+
+  input = static_cast<uint8_t*>(malloc(INPUT_BUFFER_SIZE));
+  if (!input) {
+    Serial.printf("[%lu] [PNG] Failed to allocate input buffer\n", millis());
+    return false;
+  }
+
+  bool first = true;
+  while (true) {
+    uint32_t length;
+    uint8_t type[4];
+    if (!readChunkHeader(&length, type)) {
+      Serial.printf("[%lu] [PNG] Truncated PNG header\n", millis());
+      return false;
+    }
+
+    if (first) {
+      first = false;
+      if (memcmp(type, "IHDR", 4) != 0 || !readIhdr(length)) {
+        return false;
+      }
+    } else if (memcmp(type, "PLTE", 4) == 0) {
+      if (length % 3 != 0 || length / 3 > 256 || !readChunkData(input, length)) {
+        Serial.printf("[%lu] [PNG] Invalid palette\n", millis());
+        return false;
+      }
+      for (uint32_t i = 0; i < length / 3; i++) {
+        paletteGray[i] = luminance(input[i * 3], input[i * 3 + 1], input[i * 3 + 2]);
+      }
+      hasPalette = true;
+    } else if (memcmp(type, "tRNS", 4) == 0) {
+      if (length > INPUT_BUFFER_SIZE || !readChunkData(input, length)) {
+        Serial.printf("[%lu] [PNG] Invalid transparency chunk\n", millis());
+        return false;
+      }
+      if (colorType == PALETTE) {
+        for (uint32_t i = 0; i < length && i < 256; i++) {
+          paletteGray[i] = onWhite(paletteGray[i], input[i]);
+        }
+      } else if ((colorType == GRAY && length >= 2) || (colorType == RGB && length >= 6)) {
+        hasColorKey = true;
+        for (int c = 0; c < (colorType == GRAY ? 1 : 3); c++) {
+          colorKey[c] = static_cast<uint16_t>((input[c * 2] << 8) | input[c * 2 + 1]);
+        }
+      }
+    } else if (memcmp(type, "IDAT", 4) == 0) {
+      if (colorType == PALETTE && !hasPalette) {
+        Serial.printf("[%lu] [PNG] Missing palette\n", millis());
+        return false;
+      }
+      chunkRemaining = length;
+      return true;
+    } else if (memcmp(type, "IEND", 4) == 0) {
+      Serial.printf("[%lu] [PNG] No image data\n", millis());
+      return false;
+    } else if (!file.seekCur(static_cast<int64_t>(length) + 4)) {
+      return false;
+    }
+  }
+}
+
+// Reads the next piece of the zlib stream, moving on to the following IDAT chunk when one is used up
+bool PngDecoder::fillInput() {
+  while (chunkRemaining == 0) {
+    uint32_t length;
+    uint8_t type[4];
+    // CRC of the chunk just finished
+    if (idatDone || !file.seekCur(4) || !readChunkHeader(&length, type) || memcmp(type, "IDAT", 4) != 0) {
+      idatDone = true;
+      return false;
+    }
+    chunkRemaining = length;
+  }
+
+  const size_t toRead = chunkRemaining < INPUT_BUFFER_SIZE ? chunkRemaining : INPUT_BUFFER_SIZE;
+  if (file.read(input, toRead) != static_cast<int>(toRead)) {
+    readError = true;
+    idatDone = true;
+    return false;
+  }
+  chunkRemaining -= toRead;
+  inputPos = 0;
+  inputFilled = toRead;
+  return true;
+}
+
+bool PngDecoder::unfilter(uint8_t* row, const uint8_t* previous, const uint8_t filter) const {
+  const int stride = filterStride;
+  const int count = static_cast<int>(rowBytes);
+  switch (filter) {
+    case 0:  // None
+      return true;
+    case 1:  // Sub
+      for (int i = stride; i < count; i++) {
+        row[i] += row[i - stride];
+      }
+      return true;
+    case 2:  // Up
+      for (int i = 0; i < count; i++) {
+        row[i] += previous[i];
+      }
+      return true;
+    case 3:  // Average
+      for (int i = 0; i < count; i++) {
+        const int left = i >= stride ? row[i - stride] : 0;
+        row[i] += (left + previous[i]) >> 1;
+      }
+      return true;
+    case 4:  // Paeth
+      for (int i = 0; i < count; i++) {
+        const int left = i >= stride ? row[i - stride] : 0;
+        const int upperLeft = i >= stride ? previous[i - stride] : 0;
+        row[i] += paethPredictor(left, previous[i], upperLeft);
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Raw sample value, index counts samples along the row
+uint16_t PngDecoder::sample(const uint8_t* row, const uint32_t index) const {
+  switch (bitDepth) {
+    case 16:
+      return static_cast<uint16_t>((row[index * 2] << 8) | row[index * 2 + 1]);
+    case 8:
+      return row[index];
+    default: {
+      const uint32_t bit = index * bitDepth;
+      return (row[bit >> 3] >> (8 - bitDepth - (bit & 7))) & ((1 << bitDepth) - 1);
+    }
+  }
+}
+
+void PngDecoder::toGray(const uint8_t* row, uint8_t* out) const {
+  // Sub-byte and 16-bit samples are brought to 8 bits
+  const int maxValue = (1 << bitDepth) - 1;
+  const auto to8Bit = [this, maxValue](const uint16_t value) {
+    return static_cast<int>(bitDepth == 16 ? value >> 8 : bitDepth == 8 ? value : value * 255 / maxValue);
+  };
+
+  for (uint32_t x = 0; x < width; x++) {
+    switch (colorType) {
+      case GRAY: {
+        const uint16_t value = sample(row, x);
+        out[x] = hasColorKey && value == colorKey[0] ? 255 : to8Bit(value);
+        break;
+      }
+      case PALETTE:
+        out[x] = paletteGray[sample(row, x)];
+        break;
+      case RGB: {
+        const uint16_t r = sample(row, x * 3);
+        const uint16_t g = sample(row, x * 3 + 1);
+        const uint16_t b = sample(row, x * 3 + 2);
+        const bool transparent = hasColorKey && r == colorKey[0] && g == colorKey[1] && b == colorKey[2];
+        out[x] = transparent ? 255 : luminance(to8Bit(r), to8Bit(g), to8Bit(b));
+        break;
+      }
+      case GRAY_ALPHA:
+        out[x] = onWhite(to8Bit(sample(row, x * 2)), to8Bit(sample(row, x * 2 + 1)));
+        break;
+      case RGBA:
+      default:
+        out[x] = onWhite(luminance(to8Bit(sample(row, x * 4)), to8Bit(sample(row, x * 4 + 1)),
+                                   to8Bit(sample(row, x * 4 + 2))),
+                         to8Bit(sample(row, x * 4 + 3)));
+        break;
+    }
+  }
+}
+
+bool PngDecoder::decode(ScaledBmpWriter& writer) {
+  inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  window = static_cast<uint8_t*>(malloc(TINFL_LZ_DICT_SIZE));
+  rows[0] = static_cast<uint8_t*>(calloc(rowBytes + 1, 1));
+  rows[1] = static_cast<uint8_t*>(calloc(rowBytes + 1, 1));
+  grayRow = static_cast<uint8_t*>(malloc(width));
+  if (!inflator || !window || !rows[0] || !rows[1] || !grayRow) {
+    Serial.printf("[%lu] [PNG] Failed to allocate decode buffers (%d byte rows)\n", millis(),
+                  static_cast<int>(rowBytes));
+    return false;
+  }
+  tinfl_init(inflator);
+
+  uint8_t* current = rows[0];
+  uint8_t* previous = rows[1];
+  size_t rowFill = 0;
+  size_t windowPos = 0;
+  uint32_t y = 0;
+
+  while (y < height) {
+    if (inputPos >= inputFilled && !idatDone) {
+      inputPos = 0;
+      inputFilled = 0;
+      fillInput();
+    }
+    if (readError) {
+      Serial.printf("[%lu] [PNG] Failed to read image data\n", millis());
+      return false;
+    }
+
+    size_t inBytes = inputFilled - inputPos;
+    size_t outBytes = TINFL_LZ_DICT_SIZE - windowPos;
+    const tinfl_status status =
+        tinfl_decompress(inflator, input + inputPos, &inBytes, window, window + windowPos, &outBytes,
+                         TINFL_FLAG_PARSE_ZLIB_HEADER | (idatDone ? 0 : TINFL_FLAG_HAS_MORE_INPUT));
+    inputPos += inBytes;
+
+    // Split the inflated bytes into rows: filter type byte, then rowBytes of filtered data
+    const uint8_t* inflated = window + windowPos;
+    size_t remaining = outBytes;
+    while (remaining > 0 && y < height) {
+      const size_t take = remaining < rowBytes + 1 - rowFill ? remaining : rowBytes + 1 - rowFill;
+      memcpy(current + rowFill, inflated, take);
+      inflated += take;
+      remaining -= take;
+      rowFill += take;
+      if (rowFill < rowBytes + 1) {
+        break;
+      }
+
+      if (!unfilter(current + 1, previous + 1, current[0])) {
+        Serial.printf("[%lu] [PNG] Invalid filter type %d in row %lu\n", millis(), current[0],
+                      static_cast<unsigned long>(y));
+        return false;
+      }
+      toGray(current + 1, grayRow);
+      writer.writeRow(grayRow);
+      uint8_t* swap = previous;
+      previous = current;
+      current = swap;
+      rowFill = 0;
+      y++;
+    }
+    windowPos = (windowPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+
+    if (status < 0) {
+      Serial.printf("[%lu] [PNG] tinfl_decompress() failed with status %d\n", millis(), status);
+      return false;
+    }
+    if (status == TINFL_STATUS_DONE) {
+      break;
+    }
+  }
+
+  if (y < height) {
+    Serial.printf("[%lu] [PNG] Image data ended after %lu of %lu rows\n", millis(), static_cast<unsigned long>(y),
+                  static_cast<unsigned long>(height));
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+bool PngToBmpConverter::pngFileToBmpStreamInternal(FsFile& pngFile, Print& bmpOut, const int targetWidth,
+                                                   const int targetHeight, const bool oneBit) {
+  Serial.printf("[%lu] [PNG] Converting PNG to %s BMP (target: %dx%d)\n", millis(), oneBit ? "1-bit" : "2-bit",
+                targetWidth, targetHeight);
+
+  PngDecoder decoder(pngFile);
+  if (!decoder.readHeader()) {
+    return false;
+  }
+
+  const int width = static_cast<int>(decoder.width);
+  const int height = static_cast<int>(decoder.height);
+  int outWidth, outHeight;
+  ScaledBmpWriter::fitToTarget(width, height, targetWidth, targetHeight, &outWidth, &outHeight);
+  if (outWidth != width || outHeight != height) {
+    Serial.printf("[%lu] [PNG] Pre-scaling %dx%d -> %dx%d (fit to %dx%d)\n", millis(), width, height, outWidth,
+                  outHeight, targetWidth, targetHeight);
+  }
+
+  ScaledBmpWriter writer(bmpOut, oneBit);
+  if (!writer.begin(width, height, outWidth, outHeight)) {
+    Serial.printf("[%lu] [PNG] Failed to allocate row buffer\n", millis());
+    return false;
+  }
+  if (!decoder.decode(writer)) {
+    return false;
+  }
+
+  Serial.printf("[%lu] [PNG] Successfully converted PNG to BMP\n", millis());
+  return true;
+}
+
+// Core function: Convert PNG file to 2-bit BMP (uses default target size)
+bool PngToBmpConverter::pngFileToBmpStream(FsFile& pngFile, Print& bmpOut) {
+  return pngFileToBmpStreamInternal(pngFile, bmpOut, TARGET_MAX_WIDTH, TARGET_MAX_HEIGHT, false);
+}
+
+// Convert with custom target size (for thumbnails, 2-bit)
+bool PngToBmpConverter::pngFileToBmpStreamWithSize(FsFile& pngFile, Print& bmpOut, const int targetMaxWidth,
+                                                   const int targetMaxHeight) {
+  return pngFileToBmpStreamInternal(pngFile, bmpOut, targetMaxWidth, targetMaxHeight, false);
+}
+
+// Convert to 1-bit BMP (black and white only, no grays) for fast home screen rendering
+bool PngToBmpConverter::pngFileTo1BitBmpStreamWithSize(FsFile& pngFile, Print& bmpOut, const int targetMaxWidth,
+                                                       const int targetMaxHeight) {
+  return pngFileToBmpStreamInternal(pngFile, bmpOut, targetMaxWidth, targetMaxHeight, true);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+class FsFile;
+class Print;
+
+// Converts PNG covers to the BMPs used by the cover and thumbnail caches, like JpegToBmpConverter.
+//
+// Rows are inflated and unfiltered one at a time with tinfl and handed to ScaledBmpWriter, so memory stays at the
+// inflate window plus two rows whatever the image height. All bit depths and color types are supported, transparency
+// is composited onto white. Interlaced (Adam7) images are rejected.
+class PngToBmpConverter {
+  static bool pngFileToBmpStreamInternal(FsFile& pngFile, Print& bmpOut, int targetWidth, int targetHeight,
+                                         bool oneBit);
+
+ public:
+  static bool pngFileToBmpStream(FsFile& pngFile, Print& bmpOut);
+  // Convert with custom target size (for thumbnails)
+  static bool pngFileToBmpStreamWithSize(FsFile& pngFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
+  // Convert to 1-bit BMP (black and white only, no grays) for fast home screen rendering
+  static bool pngFileTo1BitBmpStreamWithSize(FsFile& pngFile, Print& bmpOut, int targetMaxWidth, int targetMaxHeight);
+};
@@ -2,6 +2,7 @@
 
 #include <FsHelpers.h>
 #include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
 
 Txt::Txt(std::string path, std::string cacheBasePath)
     : filepath(std::move(path)), cacheBasePath(std::move(cacheBasePath)) {
@@ -117,6 +118,7 @@ bool Txt::generateCoverBmp() const {
       (len >= 4 && (coverImagePath.substr(len - 4) == ".jpg" || coverImagePath.substr(len - 4) == ".JPG")) ||
       (len >= 5 && (coverImagePath.substr(len - 5) == ".jpeg" || coverImagePath.substr(len - 5) == ".JPEG"));
   const bool isBmp = len >= 4 && (coverImagePath.substr(len - 4) == ".bmp" || coverImagePath.substr(len - 4) == ".BMP");
+  const bool isPng = len >= 4 && (coverImagePath.substr(len - 4) == ".png" || coverImagePath.substr(len - 4) == ".PNG");
 
   if (isBmp) {
     // Copy BMP file to cache
@@ -140,32 +142,33 @@ bool Txt::generateCoverBmp() const {
     return true;
   }
 
-  if (isJpg) {
-    // Convert JPG/JPEG to BMP (same approach as Epub)
-    Serial.printf("[%lu] [TXT] Generating BMP from JPG cover image\n", millis());
-    FsFile coverJpg, coverBmp;
-    if (!SdMan.openFileForRead("TXT", coverImagePath, coverJpg)) {
+  if (isJpg || isPng) {
+    // Convert JPG/JPEG/PNG to BMP (same approach as Epub)
+    const char* format = isPng ? "PNG" : "JPG";
+    Serial.printf("[%lu] [TXT] Generating BMP from %s cover image\n", millis(), format);
+    FsFile coverImage, coverBmp;
+    if (!SdMan.openFileForRead("TXT", coverImagePath, coverImage)) {
       return false;
     }
     if (!SdMan.openFileForWrite("TXT", getCoverBmpPath(), coverBmp)) {
-      coverJpg.close();
+      coverImage.close();
       return false;
     }
-    const bool success = JpegToBmpConverter::jpegFileToBmpStream(coverJpg, coverBmp);
-    coverJpg.close();
+    const bool success = isPng ? PngToBmpConverter::pngFileToBmpStream(coverImage, coverBmp)
+                               : JpegToBmpConverter::jpegFileToBmpStream(coverImage, coverBmp);
+    coverImage.close();
     coverBmp.close();
 
     if (!success) {
-      Serial.printf("[%lu] [TXT] Failed to generate BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Failed to generate BMP from %s cover image\n", millis(), format);
       SdMan.remove(getCoverBmpPath().c_str());
     } else {
-      Serial.printf("[%lu] [TXT] Generated BMP from JPG cover image\n", millis());
+      Serial.printf("[%lu] [TXT] Generated BMP from %s cover image\n", millis(), format);
     }
     return success;
   }
 
-  // PNG files are not supported (would need a PNG decoder)
-  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG)\n", millis());
+  Serial.printf("[%lu] [TXT] Cover image format not supported (only BMP/JPG/JPEG/PNG)\n", millis());
   return false;
 }
 
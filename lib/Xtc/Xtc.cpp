@@ -582,11 +582,12 @@ uint8_t Xtc::getBitDepth() const {
   return parser->getBitDepth();
 }
 
-size_t Xtc::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) const {
+size_t Xtc::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize,
+                     const std::function<bool()>& keepLoading) const {
   if (!loaded || !parser) {
     return 0;
   }
-  return const_cast<xtc::XtcParser*>(parser.get())->loadPage(pageIndex, buffer, bufferSize);
+  return const_cast<xtc::XtcParser*>(parser.get())->loadPage(pageIndex, buffer, bufferSize, keepLoading);
 }
 
 xtc::XtcError Xtc::loadPageStreaming(uint32_t pageIndex,
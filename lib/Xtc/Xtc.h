@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "Xtc/XtcPageRenderer.h"
 #include "Xtc/XtcParser.h"
 #include "Xtc/XtcTypes.h"
 
@@ -77,9 +78,11 @@ class Xtc {
    * @param pageIndex Page index (0-based)
    * @param buffer Output buffer
    * @param bufferSize Buffer size
+   * @param keepLoading Optional, asked between chunks of the page; returning false stops the load
    * @return Number of bytes read
    */
-  size_t loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) const;
+  size_t loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize,
+                  const std::function<bool()>& keepLoading = nullptr) const;
 
   /**
    * Load page with streaming callback
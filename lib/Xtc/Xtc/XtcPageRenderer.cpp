@@ -0,0 +1,201 @@
+/**
+ * XtcPageRenderer.cpp
+ *
+ * Rasterizes loaded XTG/XTH page data into the GfxRenderer framebuffer
+ */
+
+#include "XtcPageRenderer.h"
+
+#include <GfxRenderer.h>
+
+namespace xtc {
+
+namespace {
+
+// Transposes an 8x8 bit matrix: byte i of the result is column i of the input (bit 7 = column 0), with input row 0
+// in its bit 7. Rows are read stride bytes apart.
+void transpose8(const uint8_t* in, const size_t stride, uint8_t* out) {
+  uint32_t x = in[0] << 24 | in[stride] << 16 | in[2 * stride] << 8 | in[3 * stride];
+  uint32_t y = in[4 * stride] << 24 | in[5 * stride] << 16 | in[6 * stride] << 8 | in[7 * stride];
+  uint32_t t = (x ^ (x >> 7)) & 0x00AA00AA;
+  x = x ^ t ^ (t << 7);
+  t = (y ^ (y >> 7)) & 0x00AA00AA;
+  y = y ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC;
+  x = x ^ t ^ (t << 14);
+  t = (y ^ (y >> 14)) & 0x0000CCCC;
+  y = y ^ t ^ (t << 14);
+  t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+  y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+  x = t;
+  for (int i = 0; i < 4; i++) {
+    out[i] = static_cast<uint8_t>(x >> (24 - 8 * i));
+    out[i + 4] = static_cast<uint8_t>(y >> (24 - 8 * i));
+  }
+}
+
+uint8_t reverseBits(uint8_t b) {
+  b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  return static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+}
+
+// Byte-wise writer for a portrait page: logical column x is panel row DISPLAY_HEIGHT - 1 - x (Portrait) or x
+// (PortraitInverted), logical rows 8j..8j+7 are byte j of that row, or the mirrored byte with its bits reversed.
+// BW takes white bits and clears the rest, the gray modes set the bits of marked pixels, same as drawPixel.
+template <GfxRenderer::RenderMode mode, bool inverted>
+struct PanelWriter {
+  uint8_t* frameBuffer;
+
+  uint8_t* row(const int x) const {
+    return frameBuffer + (inverted ? x : EInkDisplay::DISPLAY_HEIGHT - 1 - x) * EInkDisplay::DISPLAY_WIDTH_BYTES;
+  }
+  static void put(uint8_t* row, const int j, const uint8_t bits) {
+    uint8_t& dst = inverted ? row[EInkDisplay::DISPLAY_WIDTH_BYTES - 1 - j] : row[j];
+    const uint8_t value = inverted ? reverseBits(bits) : bits;
+    if (mode == GfxRenderer::BW) {
+      dst &= value;
+    } else {
+      dst |= value;
+    }
+  }
+};
+
+// XTH columns already run along panel rows, 8 pixels per byte: each output byte is a bit operation on the two planes
+template <GfxRenderer::RenderMode mode, bool inverted>
+void blitXth(const PanelWriter<mode, inverted> writer, const uint8_t* pageBuffer, const int pageWidth,
+             const int pageHeight) {
+  const int colBytes = pageHeight / 8;
+  const size_t planeSize = static_cast<size_t>(pageWidth) * colBytes;
+  for (int col = 0; col < pageWidth; col++) {
+    const uint8_t* plane1 = pageBuffer + static_cast<size_t>(col) * colBytes;
+    const uint8_t* plane2 = plane1 + planeSize;
+    uint8_t* row = writer.row(pageWidth - 1 - col);
+    for (int j = 0; j < colBytes; j++) {
+      if (mode == GfxRenderer::BW) {
+        writer.put(row, j, ~(plane1[j] | plane2[j]));  // White only where both bits are clear
+      } else if (mode == GfxRenderer::GRAYSCALE_LSB) {
+        writer.put(row, j, ~plane1[j] & plane2[j]);  // Value 1, dark grey
+      } else {
+        writer.put(row, j, plane1[j] ^ plane2[j]);  // Values 1 and 2, both greys
+      }
+    }
+  }
+}
+
+// XTG rows run across panel rows: every 8x8 block is transposed so its 8 pixel columns become 8 panel row bytes
+template <bool inverted>
+void blitXtg(const PanelWriter<GfxRenderer::BW, inverted> writer, const uint8_t* pageBuffer, const int pageWidth,
+             const int pageHeight) {
+  const int rowBytes = pageWidth / 8;
+  uint8_t columns[8];
+  for (int j = 0; j < pageHeight / 8; j++) {
+    const uint8_t* block = pageBuffer + static_cast<size_t>(j) * 8 * rowBytes;
+    for (int b = 0; b < rowBytes; b++) {
+      transpose8(block + b, rowBytes, columns);
+      for (int k = 0; k < 8; k++) {
+        writer.put(writer.row(b * 8 + k), j, columns[k]);
+      }
+    }
+  }
+}
+
+template <bool inverted>
+void blitPage(uint8_t* frameBuffer, const GfxRenderer::RenderMode renderMode, const uint8_t* pageBuffer,
+              const int pageWidth, const int pageHeight, const uint8_t bitDepth) {
+  if (bitDepth != 2) {
+    if (renderMode == GfxRenderer::BW) {
+      blitXtg(PanelWriter<GfxRenderer::BW, inverted>{frameBuffer}, pageBuffer, pageWidth, pageHeight);
+    }
+    return;
+  }
+  switch (renderMode) {
+    case GfxRenderer::BW:
+      blitXth(PanelWriter<GfxRenderer::BW, inverted>{frameBuffer}, pageBuffer, pageWidth, pageHeight);
+      break;
+    case GfxRenderer::GRAYSCALE_LSB:
+      blitXth(PanelWriter<GfxRenderer::GRAYSCALE_LSB, inverted>{frameBuffer}, pageBuffer, pageWidth, pageHeight);
+      break;
+    case GfxRenderer::GRAYSCALE_MSB:
+      blitXth(PanelWriter<GfxRenderer::GRAYSCALE_MSB, inverted>{frameBuffer}, pageBuffer, pageWidth, pageHeight);
+      break;
+  }
+}
+
+// Pixel by pixel through drawPixel, for layouts the blitter does not cover
+void drawPagePixels(const GfxRenderer& renderer, const uint8_t* pageBuffer, const uint16_t pageWidth,
+                    const uint16_t pageHeight, const uint8_t bitDepth) {
+  const GfxRenderer::RenderMode renderMode = renderer.getRenderMode();
+
+  if (bitDepth == 2) {
+    // XTH 2-bit mode: Two bit planes, column-major order
+    // - Columns scanned right to left (x = width-1 down to 0)
+    // - 8 vertical pixels per byte (MSB = topmost pixel in group)
+    // - First plane: Bit1, Second plane: Bit2
+    // - Pixel value = (bit1 << 1) | bit2
+    // - Grayscale: 0=White, 1=Dark Grey, 2=Light Grey, 3=Black
+    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
+    const uint8_t* plane1 = pageBuffer;              // Bit1 plane
+    const uint8_t* plane2 = pageBuffer + planeSize;  // Bit2 plane
+    const size_t colBytes = (pageHeight + 7) / 8;    // Bytes per column (100 for 800 height)
+
+    for (uint16_t y = 0; y < pageHeight; y++) {
+      for (uint16_t x = 0; x < pageWidth; x++) {
+        const size_t byteOffset = static_cast<size_t>(pageWidth - 1 - x) * colBytes + y / 8;
+        const size_t bitInByte = 7 - (y % 8);
+        const uint8_t value = (((plane1[byteOffset] >> bitInByte) & 1) << 1) | ((plane2[byteOffset] >> bitInByte) & 1);
+
+        if (renderMode == GfxRenderer::BW && value >= 1) {
+          renderer.drawPixel(x, y, true);
+        } else if (renderMode == GfxRenderer::GRAYSCALE_LSB && value == 1) {
+          // In LUT: 0 bit = apply gray effect, 1 bit = untouched
+          renderer.drawPixel(x, y, false);
+        } else if (renderMode == GfxRenderer::GRAYSCALE_MSB && (value == 1 || value == 2)) {
+          renderer.drawPixel(x, y, false);
+        }
+      }
+    }
+    return;
+  }
+
+  if (renderMode != GfxRenderer::BW) {
+    return;
+  }
+
+  // 1-bit mode: 8 pixels per byte, MSB first
+  const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
+  for (uint16_t srcY = 0; srcY < pageHeight; srcY++) {
+    const size_t srcRowStart = srcY * srcRowBytes;
+    for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
+      // Read source pixel (MSB first, bit 7 = leftmost pixel)
+      const size_t srcByte = srcRowStart + srcX / 8;
+      const size_t srcBit = 7 - (srcX % 8);
+      const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
+      if (isBlack) {
+        renderer.drawPixel(srcX, srcY, true);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void drawPage(const GfxRenderer& renderer, const uint8_t* pageBuffer, const uint16_t pageWidth,
+              const uint16_t pageHeight, const uint8_t bitDepth) {
+  // Portrait pages with whole bytes in both directions go straight into the framebuffer a byte at a time
+  const GfxRenderer::Orientation orientation = renderer.getOrientation();
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+  const bool blittable = frameBuffer &&
+                         (orientation == GfxRenderer::Portrait || orientation == GfxRenderer::PortraitInverted) &&
+                         pageWidth <= EInkDisplay::DISPLAY_HEIGHT && pageHeight <= EInkDisplay::DISPLAY_WIDTH &&
+                         pageWidth % 8 == 0 && pageHeight % 8 == 0;
+  if (!blittable) {
+    drawPagePixels(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
+  } else if (orientation == GfxRenderer::Portrait) {
+    blitPage<false>(frameBuffer, renderer.getRenderMode(), pageBuffer, pageWidth, pageHeight, bitDepth);
+  } else {
+    blitPage<true>(frameBuffer, renderer.getRenderMode(), pageBuffer, pageWidth, pageHeight, bitDepth);
+  }
+}
+
+}  // namespace xtc
@@ -0,0 +1,31 @@
+/**
+ * XtcPageRenderer.h
+ *
+ * Rasterizes loaded XTG/XTH page data into the GfxRenderer framebuffer
+ * XTC ebook support for CrossPoint Reader
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class GfxRenderer;
+
+namespace xtc {
+
+/**
+ * Draw a page buffer (as filled by Xtc::loadPage) for the renderer's current render mode
+ *
+ * BW: every non-white pixel is drawn black
+ * GRAYSCALE_LSB: dark grey pixels (XTH value 1) are marked
+ * GRAYSCALE_MSB: dark and light grey pixels (XTH values 1 and 2) are marked
+ *
+ * 1-bit pages only have a BW pass. The framebuffer is expected to be cleared by the caller.
+ *
+ * In the portrait orientations pages are blitted a framebuffer byte at a time: XTH columns already lie along panel
+ * rows, XTG rows are turned with 8x8 bit transposes. Other layouts fall back to drawPixel.
+ */
+void drawPage(const GfxRenderer& renderer, const uint8_t* pageBuffer, uint16_t pageWidth, uint16_t pageHeight,
+              uint8_t bitDepth);
+
+}  // namespace xtc
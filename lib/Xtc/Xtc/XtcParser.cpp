@@ -10,13 +10,176 @@
 #include <FsHelpers.h>
 #include <HardwareSerial.h>
 #include <SDCardManager.h>
+#include <miniz.h>
 
 #include <cstring>
 
 namespace xtc {
 
+namespace {
+// Read size for compressed payloads in loadPage
+constexpr size_t PAYLOAD_CHUNK_SIZE = 4096;
+
+// Hands out a compressed page payload from the card one chunk at a time
+class PayloadReader {
+ public:
+  PayloadReader(FsFile& file, const size_t size, const size_t chunkSize)
+      : file(file), remaining(size), chunkSize(chunkSize) {}
+
+  // Reads the next chunk once the current one is used up; false at the end of the payload or on a read error
+  bool fill() {
+    if (position < filled) {
+      return true;
+    }
+    if (remaining == 0) {
+      return false;
+    }
+    if (buffer.empty()) {
+      buffer.resize(chunkSize);
+    }
+    const int bytesRead = file.read(buffer.data(), std::min(buffer.size(), remaining));
+    if (bytesRead <= 0) {
+      remaining = 0;
+      return false;
+    }
+    remaining -= bytesRead;
+    filled = bytesRead;
+    position = 0;
+    return true;
+  }
+  const uint8_t* data() const { return buffer.data() + position; }
+  size_t available() const { return filled - position; }
+  void consume(const size_t count) { position += count; }
+  bool hasMore() const { return remaining > 0; }
+
+  bool next(uint8_t& byte) {
+    if (!fill()) {
+      return false;
+    }
+    byte = buffer[position++];
+    return true;
+  }
+
+  bool read(uint8_t* out, size_t count) {
+    while (count > 0) {
+      if (!fill()) {
+        return false;
+      }
+      const size_t take = std::min(count, available());
+      memcpy(out, data(), take);
+      consume(take);
+      out += take;
+      count -= take;
+    }
+    return true;
+  }
+
+ private:
+  FsFile& file;
+  size_t remaining;
+  size_t chunkSize;
+  std::vector<uint8_t> buffer;
+  size_t filled = 0;
+  size_t position = 0;
+};
+
+// PackBits decoder that can stop anywhere inside a run and carry on with the next output chunk
+class PackBitsDecoder {
+ public:
+  explicit PackBitsDecoder(PayloadReader& input) : input(input) {}
+
+  // Fills out completely, false if the payload ends early
+  bool decode(uint8_t* out, const size_t size) {
+    size_t pos = 0;
+    while (pos < size) {
+      if (repeat > 0) {
+        const size_t take = std::min(repeat, size - pos);
+        memset(out + pos, value, take);
+        pos += take;
+        repeat -= take;
+      } else if (literal > 0) {
+        const size_t take = std::min(literal, size - pos);
+        if (!input.read(out + pos, take)) {
+          return false;
+        }
+        pos += take;
+        literal -= take;
+      } else {
+        uint8_t header;
+        if (!input.next(header)) {
+          return false;
+        }
+        if (header < 128) {
+          literal = header + 1;
+        } else if (header > 128) {
+          if (!input.next(value)) {
+            return false;
+          }
+          repeat = 257 - header;
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  PayloadReader& input;
+  size_t literal = 0;
+  size_t repeat = 0;
+  uint8_t value = 0;
+};
+
+// Inflates a raw deflate payload straight into the page buffer. keepLoading is asked with the number of bytes decoded
+// so far after every piece of output, returning false stops with CANCELLED.
+XtcError inflatePayload(PayloadReader& input, uint8_t* buffer, const size_t bitmapSize,
+                        const std::function<bool(size_t offset)>& keepLoading) {
+  const auto inflator = static_cast<tinfl_decompressor*>(malloc(sizeof(tinfl_decompressor)));
+  if (!inflator) {
+    Serial.printf("[%lu] [XTC] Failed to allocate memory for inflator\n", millis());
+    return XtcError::MEMORY_ERROR;
+  }
+  tinfl_init(inflator);
+
+  size_t total = 0;
+  XtcError result = XtcError::DECOMPRESSION_ERROR;
+  while (true) {
+    // An empty input is passed on as well, tinfl reports a truncated stream itself
+    input.fill();
+    size_t inBytes = input.available();
+    size_t outBytes = bitmapSize - total;
+    const tinfl_status status = tinfl_decompress(
+        inflator, input.data(), &inBytes, buffer, buffer + total, &outBytes,
+        TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF | (input.hasMore() ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+    input.consume(inBytes);
+
+    if (outBytes > 0 && !keepLoading(total)) {
+      result = XtcError::CANCELLED;
+      break;
+    }
+    total += outBytes;
+
+    if (status == TINFL_STATUS_DONE) {
+      result = total == bitmapSize ? XtcError::OK : XtcError::DECOMPRESSION_ERROR;
+      break;
+    }
+    if (status == TINFL_STATUS_HAS_MORE_OUTPUT && total == bitmapSize) {
+      Serial.printf("[%lu] [XTC] Deflate payload is larger than the page\n", millis());
+      break;
+    }
+    if (status < 0) {
+      Serial.printf("[%lu] [XTC] tinfl_decompress() failed with status %d\n", millis(), status);
+      break;
+    }
+  }
+
+  free(inflator);
+  return result;
+}
+}  // namespace
+
 XtcParser::XtcParser()
     : m_isOpen(false),
+      m_pageTableUses(0),
       m_defaultWidth(DISPLAY_WIDTH),
       m_defaultHeight(DISPLAY_HEIGHT),
       m_bitDepth(1),
@@ -77,7 +240,7 @@ void XtcParser::close() {
     m_file.close();
     m_isOpen = false;
   }
-  m_pageTable.clear();
+  clearPageTableCache();
   m_chapters.clear();
   m_title.clear();
   m_hasChapters = false;
@@ -148,38 +311,95 @@ XtcError XtcParser::readPageTable() {
     return XtcError::CORRUPTED_HEADER;
   }
 
-  // Seek to page table
-  if (!m_file.seek(m_header.pageTableOffset)) {
-    Serial.printf("[%lu] [XTC] Failed to seek to page table at %llu\n", millis(), m_header.pageTableOffset);
+  // Entries are read when pages are, here the table only has to lie within the file
+  const uint64_t tableSize = static_cast<uint64_t>(m_header.pageCount) * sizeof(PageTableEntry);
+  const uint64_t tableEnd = m_header.pageTableOffset + tableSize;
+  if (tableEnd > m_file.size()) {
+    Serial.printf("[%lu] [XTC] Page table at %llu with %u entries runs past the end of the file\n", millis(),
+                  m_header.pageTableOffset, m_header.pageCount);
+    return XtcError::CORRUPTED_HEADER;
+  }
+
+  clearPageTableCache();
+
+  // Default dimensions from first page
+  const PageInfo* firstPage = findPageInfo(0);
+  if (!firstPage) {
     return XtcError::READ_ERROR;
   }
+  m_defaultWidth = firstPage->width;
+  m_defaultHeight = firstPage->height;
 
-  m_pageTable.resize(m_header.pageCount);
+  Serial.printf("[%lu] [XTC] Page table at %llu with %u entries\n", millis(), m_header.pageTableOffset,
+                m_header.pageCount);
+  return XtcError::OK;
+}
 
-  // Read page table entries
-  for (uint16_t i = 0; i < m_header.pageCount; i++) {
+void XtcParser::clearPageTableCache() {
+  for (auto& block : m_pageTableCache) {
+    block.firstPage = NO_BLOCK;
+    block.lastUse = 0;
+  }
+  m_pageTableUses = 0;
+}
+
+bool XtcParser::readPageTableBlock(const uint32_t firstPage, PageTableBlock& block) {
+  static_assert(sizeof(PageInfo) == sizeof(PageTableEntry), "page table entries are converted in place");
+
+  block.firstPage = NO_BLOCK;
+  const uint32_t count = std::min(PAGE_TABLE_BLOCK_ENTRIES, m_header.pageCount - firstPage);
+  const size_t bytes = count * sizeof(PageTableEntry);
+  if (!m_file.seek(m_header.pageTableOffset + static_cast<uint64_t>(firstPage) * sizeof(PageTableEntry)) ||
+      m_file.read(reinterpret_cast<uint8_t*>(block.entries), bytes) != static_cast<int>(bytes)) {
+    Serial.printf("[%lu] [XTC] Failed to read page table entries %lu-%lu\n", millis(), firstPage,
+                  firstPage + count - 1);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
     PageTableEntry entry;
-    size_t bytesRead = m_file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(PageTableEntry));
-    if (bytesRead != sizeof(PageTableEntry)) {
-      Serial.printf("[%lu] [XTC] Failed to read page table entry %u\n", millis(), i);
-      return XtcError::READ_ERROR;
-    }
+    memcpy(&entry, &block.entries[i], sizeof(entry));
+    block.entries[i].offset = static_cast<uint32_t>(entry.dataOffset);
+    block.entries[i].size = entry.dataSize;
+    block.entries[i].width = entry.width;
+    block.entries[i].height = entry.height;
+    block.entries[i].bitDepth = m_bitDepth;
+    block.entries[i].padding = 0;
+  }
+  block.firstPage = firstPage;
+  return true;
+}
 
-    m_pageTable[i].offset = static_cast<uint32_t>(entry.dataOffset);
-    m_pageTable[i].size = entry.dataSize;
-    m_pageTable[i].width = entry.width;
-    m_pageTable[i].height = entry.height;
-    m_pageTable[i].bitDepth = m_bitDepth;
+const PageInfo* XtcParser::findPageInfo(const uint32_t pageIndex) {
+  if (pageIndex >= m_header.pageCount) {
+    return nullptr;
+  }
 
-    // Update default dimensions from first page
-    if (i == 0) {
-      m_defaultWidth = entry.width;
-      m_defaultHeight = entry.height;
+  const uint32_t firstPage = pageIndex - pageIndex % PAGE_TABLE_BLOCK_ENTRIES;
+  PageTableBlock* block = nullptr;
+  for (auto& cached : m_pageTableCache) {
+    if (cached.firstPage == firstPage) {
+      block = &cached;
+      break;
     }
   }
 
-  Serial.printf("[%lu] [XTC] Read %u page table entries\n", millis(), m_header.pageCount);
-  return XtcError::OK;
+  if (!block) {
+    // Least recently used block, never used ones first
+    block = &m_pageTableCache[0];
+    for (auto& cached : m_pageTableCache) {
+      if (cached.lastUse < block->lastUse) {
+        block = &cached;
+      }
+    }
+    if (!readPageTableBlock(firstPage, *block)) {
+      block->lastUse = 0;
+      return nullptr;
+    }
+  }
+
+  block->lastUse = ++m_pageTableUses;
+  return &block->entries[pageIndex - firstPage];
 }
 
 XtcError XtcParser::readChapters() {
@@ -288,41 +508,40 @@ XtcError XtcParser::readChapters() {
   return XtcError::OK;
 }
 
-bool XtcParser::getPageInfo(uint32_t pageIndex, PageInfo& info) const {
-  if (pageIndex >= m_pageTable.size()) {
+bool XtcParser::getPageInfo(uint32_t pageIndex, PageInfo& info) {
+  const PageInfo* page = findPageInfo(pageIndex);
+  if (!page) {
     return false;
   }
-  info = m_pageTable[pageIndex];
+  info = *page;
   return true;
 }
 
-size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize) {
+XtcError XtcParser::readPageHeader(uint32_t pageIndex, XtgPageHeader& pageHeader, size_t& bitmapSize) {
   if (!m_isOpen) {
-    m_lastError = XtcError::FILE_NOT_FOUND;
-    return 0;
+    return XtcError::FILE_NOT_FOUND;
   }
 
   if (pageIndex >= m_header.pageCount) {
-    m_lastError = XtcError::PAGE_OUT_OF_RANGE;
-    return 0;
+    return XtcError::PAGE_OUT_OF_RANGE;
   }
 
-  const PageInfo& page = m_pageTable[pageIndex];
+  const PageInfo* page = findPageInfo(pageIndex);
+  if (!page) {
+    return XtcError::READ_ERROR;
+  }
 
   // Seek to page data
-  if (!m_file.seek(page.offset)) {
-    Serial.printf("[%lu] [XTC] Failed to seek to page %u at offset %lu\n", millis(), pageIndex, page.offset);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
+  if (!m_file.seek(page->offset)) {
+    Serial.printf("[%lu] [XTC] Failed to seek to page %u at offset %lu\n", millis(), pageIndex, page->offset);
+    return XtcError::READ_ERROR;
   }
 
   // Read page header (XTG for 1-bit, XTH for 2-bit - same structure)
-  XtgPageHeader pageHeader;
   size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
   if (headerRead != sizeof(XtgPageHeader)) {
     Serial.printf("[%lu] [XTC] Failed to read page header for page %u\n", millis(), pageIndex);
-    m_lastError = XtcError::READ_ERROR;
-    return 0;
+    return XtcError::READ_ERROR;
   }
 
   // Verify page magic (XTG for 1-bit, XTH for 2-bit)
@@ -330,14 +549,19 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
   if (pageHeader.magic != expectedMagic) {
     Serial.printf("[%lu] [XTC] Invalid page magic for page %u: 0x%08X (expected 0x%08X)\n", millis(), pageIndex,
                   pageHeader.magic, expectedMagic);
-    m_lastError = XtcError::INVALID_MAGIC;
-    return 0;
+    return XtcError::INVALID_MAGIC;
+  }
+
+  if (pageHeader.compression != XTG_COMPRESSION_NONE && pageHeader.compression != XTG_COMPRESSION_PACKBITS &&
+      pageHeader.compression != XTG_COMPRESSION_DEFLATE) {
+    Serial.printf("[%lu] [XTC] Unsupported compression %u for page %u\n", millis(), pageHeader.compression,
+                  pageIndex);
+    return XtcError::DECOMPRESSION_ERROR;
   }
 
   // Calculate bitmap size based on bit depth
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
   // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
   if (m_bitDepth == 2) {
     // XTH: two bit planes, each containing (width * height) bits rounded up to bytes
     bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
@@ -345,6 +569,18 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
     bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
   }
 
+  return XtcError::OK;
+}
+
+size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize,
+                           const std::function<bool()>& keepLoading) {
+  XtgPageHeader pageHeader;
+  size_t bitmapSize = 0;
+  m_lastError = readPageHeader(pageIndex, pageHeader, bitmapSize);
+  if (m_lastError != XtcError::OK) {
+    return 0;
+  }
+
   // Check buffer size
   if (bufferSize < bitmapSize) {
     Serial.printf("[%lu] [XTC] Buffer too small: need %u, have %u\n", millis(), bitmapSize, bufferSize);
@@ -352,61 +588,89 @@ size_t XtcParser::loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSiz
     return 0;
   }
 
-  // Read bitmap data
-  size_t bytesRead = m_file.read(buffer, bitmapSize);
-  if (bytesRead != bitmapSize) {
-    Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, bytesRead);
-    m_lastError = XtcError::READ_ERROR;
+  // With keepLoading the page is read or decoded a chunk at a time and asked before each further chunk
+  const size_t step = keepLoading ? PAYLOAD_CHUNK_SIZE : bitmapSize;
+  auto stopped = [&keepLoading](const size_t offset) { return offset > 0 && keepLoading && !keepLoading(); };
+
+  if (pageHeader.compression == XTG_COMPRESSION_NONE) {
+    // Read bitmap data
+    for (size_t offset = 0; offset < bitmapSize; offset += step) {
+      if (stopped(offset)) {
+        m_lastError = XtcError::CANCELLED;
+        return 0;
+      }
+      const size_t toRead = std::min(step, bitmapSize - offset);
+      const size_t bytesRead = m_file.read(buffer + offset, toRead);
+      if (bytesRead != toRead) {
+        Serial.printf("[%lu] [XTC] Page read error: expected %u, got %u\n", millis(), bitmapSize, offset + bytesRead);
+        m_lastError = XtcError::READ_ERROR;
+        return 0;
+      }
+    }
+    m_lastError = XtcError::OK;
+    return bitmapSize;
+  }
+
+  // Compressed pages decode straight into the buffer, so only the read chunk is allocated on top
+  PayloadReader input(m_file, pageHeader.dataSize, PAYLOAD_CHUNK_SIZE);
+  if (pageHeader.compression == XTG_COMPRESSION_PACKBITS) {
+    PackBitsDecoder decoder(input);
+    m_lastError = XtcError::OK;
+    for (size_t offset = 0; offset < bitmapSize && m_lastError == XtcError::OK; offset += step) {
+      if (stopped(offset)) {
+        m_lastError = XtcError::CANCELLED;
+      } else if (!decoder.decode(buffer + offset, std::min(step, bitmapSize - offset))) {
+        m_lastError = XtcError::DECOMPRESSION_ERROR;
+      }
+    }
+  } else {
+    m_lastError =
+        inflatePayload(input, buffer, bitmapSize, [&stopped](const size_t offset) { return !stopped(offset); });
+  }
+  if (m_lastError == XtcError::CANCELLED) {
     return 0;
   }
-
-  m_lastError = XtcError::OK;
-  return bytesRead;
+  if (m_lastError != XtcError::OK) {
+    Serial.printf("[%lu] [XTC] Failed to decode page %u (%u bytes, compression %u)\n", millis(), pageIndex,
+                  pageHeader.dataSize, pageHeader.compression);
+    return 0;
+  }
+  return bitmapSize;
 }
 
 XtcError XtcParser::loadPageStreaming(uint32_t pageIndex,
                                       std::function<void(const uint8_t* data, size_t size, size_t offset)> callback,
                                       size_t chunkSize) {
-  if (!m_isOpen) {
-    return XtcError::FILE_NOT_FOUND;
-  }
-
-  if (pageIndex >= m_header.pageCount) {
-    return XtcError::PAGE_OUT_OF_RANGE;
-  }
-
-  const PageInfo& page = m_pageTable[pageIndex];
-
-  // Seek to page data
-  if (!m_file.seek(page.offset)) {
-    return XtcError::READ_ERROR;
-  }
-
-  // Read and skip page header (XTG for 1-bit, XTH for 2-bit)
   XtgPageHeader pageHeader;
-  size_t headerRead = m_file.read(reinterpret_cast<uint8_t*>(&pageHeader), sizeof(XtgPageHeader));
-  const uint32_t expectedMagic = (m_bitDepth == 2) ? XTH_MAGIC : XTG_MAGIC;
-  if (headerRead != sizeof(XtgPageHeader) || pageHeader.magic != expectedMagic) {
-    return XtcError::READ_ERROR;
+  size_t bitmapSize = 0;
+  const XtcError err = readPageHeader(pageIndex, pageHeader, bitmapSize);
+  if (err != XtcError::OK) {
+    return err;
   }
 
-  // Calculate bitmap size based on bit depth
-  // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
-  // XTH (2-bit): Two bit planes, ((width * height + 7) / 8) * 2 bytes
-  size_t bitmapSize;
-  if (m_bitDepth == 2) {
-    bitmapSize = ((static_cast<size_t>(pageHeader.width) * pageHeader.height + 7) / 8) * 2;
-  } else {
-    bitmapSize = ((pageHeader.width + 7) / 8) * pageHeader.height;
+  // Deflate back-references reach anywhere earlier in the page, which chunks can't provide
+  if (pageHeader.compression == XTG_COMPRESSION_DEFLATE) {
+    Serial.printf("[%lu] [XTC] Deflate page %u can only be loaded whole\n", millis(), pageIndex);
+    return XtcError::DECOMPRESSION_ERROR;
   }
 
   // Read in chunks
   std::vector<uint8_t> chunk(chunkSize);
+  PayloadReader input(m_file, pageHeader.dataSize, chunkSize);
+  PackBitsDecoder decoder(input);
   size_t totalRead = 0;
 
   while (totalRead < bitmapSize) {
     size_t toRead = std::min(chunkSize, bitmapSize - totalRead);
-    size_t bytesRead = m_file.read(chunk.data(), toRead);
+    size_t bytesRead;
+    if (pageHeader.compression == XTG_COMPRESSION_PACKBITS) {
+      if (!decoder.decode(chunk.data(), toRead)) {
+        return XtcError::DECOMPRESSION_ERROR;
+      }
+      bytesRead = toRead;
+    } else {
+      bytesRead = m_file.read(chunk.data(), toRead);
+    }
 
     if (bytesRead == 0) {
       return XtcError::READ_ERROR;
@@ -41,22 +41,26 @@ class XtcParser {
   uint16_t getHeight() const { return m_defaultHeight; }
   uint8_t getBitDepth() const { return m_bitDepth; }  // 1 = XTC/XTG, 2 = XTCH/XTH
 
-  // Page information
-  bool getPageInfo(uint32_t pageIndex, PageInfo& info) const;
+  // Page information, may read a block of the page table from the card
+  bool getPageInfo(uint32_t pageIndex, PageInfo& info);
 
   /**
    * Load page bitmap (raw 1-bit data, skipping XTG header)
+   * Compressed pages are decoded straight into the buffer.
    *
    * @param pageIndex Page index (0-based)
    * @param buffer Output buffer (caller allocated)
    * @param bufferSize Buffer size
+   * @param keepLoading Optional, asked between chunks of the page; returning false stops the load (CANCELLED)
    * @return Number of bytes read on success, 0 on failure
    */
-  size_t loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize);
+  size_t loadPage(uint32_t pageIndex, uint8_t* buffer, size_t bufferSize,
+                  const std::function<bool()>& keepLoading = nullptr);
 
   /**
    * Streaming page load
    * Memory-efficient method that reads page data in chunks.
+   * PackBits pages are delivered decoded; deflate pages fail with DECOMPRESSION_ERROR, use loadPage for those.
    *
    * @param pageIndex Page index
    * @param callback Callback function to receive data chunks
@@ -80,10 +84,22 @@ class XtcParser {
   XtcError getLastError() const { return m_lastError; }
 
  private:
+  // The page table is read on demand in blocks of entries, the least recently used block is replaced on a miss, so
+  // open time and memory do not depend on the page count
+  static constexpr uint32_t PAGE_TABLE_BLOCK_ENTRIES = 64;
+  static constexpr int PAGE_TABLE_CACHE_BLOCKS = 4;
+  static constexpr uint32_t NO_BLOCK = UINT32_MAX;
+  struct PageTableBlock {
+    uint32_t firstPage = NO_BLOCK;
+    uint32_t lastUse = 0;
+    PageInfo entries[PAGE_TABLE_BLOCK_ENTRIES];
+  };
+
   FsFile m_file;
   bool m_isOpen;
   XtcHeader m_header;
-  std::vector<PageInfo> m_pageTable;
+  PageTableBlock m_pageTableCache[PAGE_TABLE_CACHE_BLOCKS];
+  uint32_t m_pageTableUses;
   std::vector<ChapterInfo> m_chapters;
   std::string m_title;
   uint16_t m_defaultWidth;
@@ -95,8 +111,12 @@ class XtcParser {
   // Internal helper functions
   XtcError readHeader();
   XtcError readPageTable();
+  void clearPageTableCache();
+  bool readPageTableBlock(uint32_t firstPage, PageTableBlock& block);
+  const PageInfo* findPageInfo(uint32_t pageIndex);
   XtcError readTitle();
   XtcError readChapters();
+  XtcError readPageHeader(uint32_t pageIndex, XtgPageHeader& pageHeader, size_t& bitmapSize);
 };
 
 }  // namespace xtc
@@ -27,6 +27,11 @@ constexpr uint32_t XTG_MAGIC = 0x00475458;  // "XTG\0" for 1-bit page data
 // "XTH\0" = 0x58, 0x54, 0x48, 0x00
 constexpr uint32_t XTH_MAGIC = 0x00485458;  // "XTH\0" for 2-bit page data
 
+// XTG/XTH page payload compression
+constexpr uint8_t XTG_COMPRESSION_NONE = 0;
+constexpr uint8_t XTG_COMPRESSION_PACKBITS = 1;  // PackBits run-length encoding
+constexpr uint8_t XTG_COMPRESSION_DEFLATE = 2;   // Raw deflate stream, no zlib header
+
 // XTeink X4 display resolution
 constexpr uint16_t DISPLAY_WIDTH = 480;
 constexpr uint16_t DISPLAY_HEIGHT = 800;
@@ -68,8 +73,8 @@ struct XtgPageHeader {
   uint16_t width;       // 0x04: Image width (pixels)
   uint16_t height;      // 0x06: Image height (pixels)
   uint8_t colorMode;    // 0x08: Color mode (0=monochrome)
-  uint8_t compression;  // 0x09: Compression (0=uncompressed)
-  uint32_t dataSize;    // 0x0A: Image data size (bytes)
+  uint8_t compression;  // 0x09: Compression (0=uncompressed, 1=PackBits, 2=deflate)
+  uint32_t dataSize;    // 0x0A: Image data size (bytes, as stored when compressed)
   uint64_t md5;         // 0x0E: MD5 checksum (first 8 bytes, optional)
   // Followed by bitmap data at offset 0x16 (22)
   //
@@ -81,6 +86,10 @@ struct XtgPageHeader {
   //   First plane: Bit1 for all pixels
   //   Second plane: Bit2 for all pixels
   //   pixelValue = (bit1 << 1) | bit2
+  //
+  // Compressed pages hold dataSize bytes that decode to exactly the bitmap above.
+  // PackBits: a header byte n, then n+1 literal bytes for n < 128, or the next byte repeated 257-n times for n > 128
+  // (n = 128 is skipped).
 };
 #pragma pack(pop)
 
@@ -112,6 +121,7 @@ enum class XtcError {
   WRITE_ERROR,
   MEMORY_ERROR,
   DECOMPRESSION_ERROR,
+  CANCELLED,
 };
 
 // Convert error code to string
@@ -137,6 +147,8 @@ inline const char* errorToString(XtcError err) {
       return "Memory allocation error";
     case XtcError::DECOMPRESSION_ERROR:
       return "Decompression error";
+    case XtcError::CANCELLED:
+      return "Cancelled";
     default:
       return "Unknown error";
   }
@@ -197,6 +197,12 @@ int CrossPointSettings::getRefreshFrequency() const {
 
 int CrossPointSettings::getReaderFontId() const {
   switch (fontFamily) {
+    case SD_CARD:
+      // Without a font on the card fall back to the default font
+      if (sdReaderFontId != 0) {
+        return sdReaderFontId;
+      }
+      return BOOKERLY_14_FONT_ID;
     case BOOKERLY:
     default:
       switch (fontSize) {
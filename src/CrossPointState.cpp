@@ -5,7 +5,7 @@
 #include <Serialization.h>
 
 namespace {
-constexpr uint8_t STATE_FILE_VERSION = 2;
+constexpr uint8_t STATE_FILE_VERSION = 3;
 constexpr char STATE_FILE[] = "/.crosspoint/state.bin";
 }  // namespace
 
@@ -39,8 +39,12 @@ bool CrossPointState::loadFromFile() {
   }
 
   serialization::readString(inputFile, openEpubPath);
-  if (version >= 2) {
+  if (version >= 3) {
     serialization::readPod(inputFile, lastSleepImage);
+  } else if (version == 2) {
+    uint8_t lastSleepImageByte = 0;
+    serialization::readPod(inputFile, lastSleepImageByte);
+    lastSleepImage = lastSleepImageByte;
   } else {
     lastSleepImage = 0;
   }
@@ -8,7 +8,7 @@ class CrossPointState {
 
  public:
   std::string openEpubPath;
-  uint8_t lastSleepImage;
+  uint32_t lastSleepImage;
   ~CrossPointState() = default;
 
   // Get singleton instance
@@ -0,0 +1,201 @@
+#include "SleepImageIndex.h"
+
+#include <Bitmap.h>
+#include <HardwareSerial.h>
+#include <SDCardManager.h>
+#include <Serialization.h>
+
+#include <map>
+#include <vector>
+
+namespace {
+constexpr uint8_t INDEX_FILE_VERSION = 1;
+constexpr char SLEEP_DIR[] = "/sleep";
+constexpr char INDEX_DIR[] = "/.crosspoint/sleep";
+constexpr char INDEX_FILE[] = "/.crosspoint/sleep/index.bin";
+// Version, directory date and time, entry count
+constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t);
+// Size, date, time, width, height, bpp and the name length in front of the name
+constexpr uint32_t ENTRY_FIXED_SIZE = sizeof(uint32_t) + 4 * sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint32_t);
+constexpr uint32_t MAX_NAME_LENGTH = 255;
+
+bool isSleepImageName(const std::string& name) {
+  return !name.empty() && name[0] != '.' && name.size() > 4 && name.substr(name.size() - 4) == ".bmp";
+}
+
+bool readEntryAt(FsFile& file, const uint32_t offset, SleepImageIndex::Entry& entry) {
+  if (!file.seek(offset)) {
+    return false;
+  }
+  serialization::readPod(file, entry.size);
+  serialization::readPod(file, entry.modifyDate);
+  serialization::readPod(file, entry.modifyTime);
+  serialization::readPod(file, entry.width);
+  serialization::readPod(file, entry.height);
+  serialization::readPod(file, entry.bpp);
+  uint32_t nameLength = 0;
+  serialization::readPod(file, nameLength);
+  if (nameLength == 0 || nameLength > MAX_NAME_LENGTH) {
+    return false;
+  }
+  entry.name.resize(nameLength);
+  return file.read(&entry.name[0], nameLength) == static_cast<int>(nameLength);
+}
+}  // namespace
+
+void SleepImageIndex::invalidate() { SdMan.remove(INDEX_FILE); }
+
+bool SleepImageIndex::openIndex(const uint16_t dirDate, const uint16_t dirTime) {
+  indexFile.close();
+  count = 0;
+  if (!SdMan.exists(INDEX_FILE) || !SdMan.openFileForRead("SLI", INDEX_FILE, indexFile)) {
+    return false;
+  }
+
+  uint8_t version = 0;
+  uint16_t storedDate = 0;
+  uint16_t storedTime = 0;
+  uint32_t storedCount = 0;
+  serialization::readPod(indexFile, version);
+  serialization::readPod(indexFile, storedDate);
+  serialization::readPod(indexFile, storedTime);
+  serialization::readPod(indexFile, storedCount);
+  if (version != INDEX_FILE_VERSION ||
+      indexFile.size() < HEADER_SIZE + static_cast<uint64_t>(storedCount) * (sizeof(uint32_t) + ENTRY_FIXED_SIZE)) {
+    indexFile.close();
+    return false;
+  }
+  // An index for an older directory state stays open so rebuild can reuse its entries
+  if (storedDate != dirDate || storedTime != dirTime) {
+    return false;
+  }
+  count = storedCount;
+  return true;
+}
+
+bool SleepImageIndex::readEntry(const uint32_t index, Entry& entry) {
+  if (index >= count || !indexFile.seek(HEADER_SIZE + index * sizeof(uint32_t))) {
+    return false;
+  }
+  uint32_t offset = 0;
+  serialization::readPod(indexFile, offset);
+  return readEntryAt(indexFile, offset, entry);
+}
+
+bool SleepImageIndex::rebuild(FsFile& dir, const uint16_t dirDate, const uint16_t dirTime) {
+  const unsigned long start = millis();
+
+  // Entries of the previous index are reused for files whose size and time did not change
+  std::map<std::string, Entry> known;
+  if (indexFile) {
+    indexFile.seek(HEADER_SIZE - sizeof(uint32_t));
+    uint32_t knownCount = 0;
+    serialization::readPod(indexFile, knownCount);
+    for (uint32_t i = 0; i < knownCount; i++) {
+      uint32_t offset = 0;
+      Entry entry;
+      if (!indexFile.seek(HEADER_SIZE + i * sizeof(uint32_t))) {
+        break;
+      }
+      serialization::readPod(indexFile, offset);
+      if (!readEntryAt(indexFile, offset, entry)) {
+        break;
+      }
+      known.emplace(entry.name, entry);
+    }
+  }
+  indexFile.close();
+
+  std::vector<Entry> entries;
+  int parsed = 0;
+  char name[MAX_NAME_LENGTH + 1];
+  for (auto file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    if (file.isDirectory()) {
+      file.close();
+      continue;
+    }
+    file.getName(name, sizeof(name));
+    Entry entry;
+    entry.name = name;
+    if (!isSleepImageName(entry.name)) {
+      file.close();
+      continue;
+    }
+    entry.size = static_cast<uint32_t>(file.size());
+    entry.modifyDate = 0;
+    entry.modifyTime = 0;
+    file.getModifyDateTime(&entry.modifyDate, &entry.modifyTime);
+
+    const auto it = known.find(entry.name);
+    if (it != known.end() && it->second.size == entry.size && it->second.modifyDate == entry.modifyDate &&
+        it->second.modifyTime == entry.modifyTime) {
+      entries.push_back(it->second);
+      file.close();
+      continue;
+    }
+
+    parsed++;
+    Bitmap bitmap(file);
+    if (bitmap.parseHeaders() != BmpReaderError::Ok) {
+      Serial.printf("[%lu] [SLI] Skipping invalid BMP file: %s\n", millis(), name);
+      file.close();
+      continue;
+    }
+    entry.width = static_cast<uint16_t>(bitmap.getWidth());
+    entry.height = static_cast<uint16_t>(bitmap.getHeight());
+    entry.bpp = static_cast<uint8_t>(bitmap.getBpp());
+    entries.push_back(entry);
+    file.close();
+  }
+
+  SdMan.mkdir(INDEX_DIR);
+  FsFile outputFile;
+  if (!SdMan.openFileForWrite("SLI", INDEX_FILE, outputFile)) {
+    return false;
+  }
+  serialization::writePod(outputFile, INDEX_FILE_VERSION);
+  serialization::writePod(outputFile, dirDate);
+  serialization::writePod(outputFile, dirTime);
+  serialization::writePod(outputFile, static_cast<uint32_t>(entries.size()));
+  uint32_t offset = HEADER_SIZE + entries.size() * sizeof(uint32_t);
+  for (const auto& entry : entries) {
+    serialization::writePod(outputFile, offset);
+    offset += ENTRY_FIXED_SIZE + entry.name.size();
+  }
+  for (const auto& entry : entries) {
+    serialization::writePod(outputFile, entry.size);
+    serialization::writePod(outputFile, entry.modifyDate);
+    serialization::writePod(outputFile, entry.modifyTime);
+    serialization::writePod(outputFile, entry.width);
+    serialization::writePod(outputFile, entry.height);
+    serialization::writePod(outputFile, entry.bpp);
+    serialization::writeString(outputFile, entry.name);
+  }
+  outputFile.close();
+
+  Serial.printf("[%lu] [SLI] Indexed %d sleep images (%d headers parsed) in %lu ms\n", millis(),
+                static_cast<int>(entries.size()), parsed, millis() - start);
+  return openIndex(dirDate, dirTime);
+}
+
+bool SleepImageIndex::refresh() {
+  auto dir = SdMan.open(SLEEP_DIR);
+  if (!dir || !dir.isDirectory()) {
+    if (dir) dir.close();
+    indexFile.close();
+    count = 0;
+    return false;
+  }
+
+  uint16_t dirDate = 0;
+  uint16_t dirTime = 0;
+  dir.getModifyDateTime(&dirDate, &dirTime);
+  if (openIndex(dirDate, dirTime)) {
+    dir.close();
+    return true;
+  }
+
+  const bool ok = rebuild(dir, dirDate, dirTime);
+  dir.close();
+  return ok;
+}
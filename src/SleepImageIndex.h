@@ -0,0 +1,40 @@
+#pragma once
+#include <SdFat.h>
+
+#include <cstdint>
+#include <string>
+
+// Persistent index of the valid BMPs in /sleep, so entering sleep does not have to open and parse every image.
+//
+// The index remembers the directory's modification time. While it is unchanged the index is used as is; otherwise it
+// is rebuilt from a directory listing, parsing headers only for files that are new or whose size or time changed.
+// Entries sit behind an offset table, so reading one is a seek and a read whatever the image count.
+class SleepImageIndex {
+ public:
+  struct Entry {
+    std::string name;
+    uint32_t size;
+    uint16_t modifyDate;
+    uint16_t modifyTime;
+    uint16_t width;
+    uint16_t height;
+    uint8_t bpp;
+  };
+
+  ~SleepImageIndex() { indexFile.close(); }
+
+  // Brings the index up to date with /sleep. False if there is no /sleep directory or the index cannot be written.
+  bool refresh();
+  uint32_t getCount() const { return count; }
+  bool readEntry(uint32_t index, Entry& entry);
+
+  // Forces a rebuild on the next refresh, for changes made on the device: SdFat leaves the directory time alone
+  static void invalidate();
+
+ private:
+  FsFile indexFile;
+  uint32_t count = 0;
+
+  bool openIndex(uint16_t dirDate, uint16_t dirTime);
+  bool rebuild(FsFile& dir, uint16_t dirDate, uint16_t dirTime);
+};
@@ -3,6 +3,7 @@
 #include <Bitmap.h>
 #include <Epub.h>
 #include <GfxRenderer.h>
+#include <PanelImage.h>
 #include <SDCardManager.h>
 #include <Xtc.h>
 
@@ -261,8 +262,9 @@ void HomeActivity::render() {
             coverY = bookY + (bookHeight - bitmap.getHeight()) / 2;
           }
 
-          // Draw the cover image centered within the book card
-          renderer.drawBitmap(bitmap, coverX, coverY, bookWidth, bookHeight);
+          // Draw the cover image centered within the book card, from the panel row cache after the first time
+          PanelImage image(renderer, PanelImage::cachePathFor(coverBmpPath, "home"));
+          image.drawBitmap(bitmap, coverX, coverY, bookWidth, bookHeight);
 
           // Draw border around the card
           renderer.drawRect(bookX, bookY, bookWidth, bookHeight);
@@ -97,6 +97,17 @@ void EpubReaderActivity::onExit() {
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
 
+  // Stop a deferred TOC task from starting its build, or wait for the running build and the task to finish. The task
+  // is only started under the mutex, so no new one can appear once the flag is set.
+  xSemaphoreTake(renderingMutex, portMAX_DELAY);
+  tocTaskCancelled = true;
+  xSemaphoreGive(renderingMutex);
+  if (tocTaskDone) {
+    xSemaphoreTake(tocTaskDone, portMAX_DELAY);
+    vSemaphoreDelete(tocTaskDone);
+    tocTaskDone = nullptr;
+  }
+
   // Wait until not rendering to delete task to avoid killing mid-instruction to EPD
   xSemaphoreTake(renderingMutex, portMAX_DELAY);
   if (displayTaskHandle) {
@@ -116,10 +127,15 @@ void EpubReaderActivity::loop() {
     return;
   }
 
-  // Enter chapter selection activity
+  // Enter chapter selection activity. While a deferred TOC is being built the press is kept and the chapter list
+  // opens as soon as the TOC task is done.
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
+    chapterSelectionRequested = true;
+  }
+  if (chapterSelectionRequested && !epub->isTocPending()) {
     // Don't start activity transition while rendering
     xSemaphoreTake(renderingMutex, portMAX_DELAY);
+    chapterSelectionRequested = false;
     const int currentPage = section ? section->currentPage : 0;
     const int totalPages = section ? section->pageCount : 0;
     exitActivity();
@@ -228,6 +244,39 @@ void EpubReaderActivity::loop() {
   }
 }
 
+// Finishes the TOC pass skipped by a deferred Epub::load once the first page is on screen. The TOC is parsed without
+// the rendering mutex so page turns carry on, only the swap of book.bin is done under it. Called with the mutex held,
+// the task is started at most once per activity.
+void EpubReaderActivity::startDeferredTocTask() {
+  if (tocTaskDone || tocTaskCancelled || !epub->isTocPending()) {
+    return;
+  }
+
+  tocTaskDone = xSemaphoreCreateBinary();
+  if (!tocTaskDone) {
+    return;
+  }
+  if (xTaskCreate(
+          [](void* param) {
+            auto* self = static_cast<EpubReaderActivity*>(param);
+            const bool prepared = !self->tocTaskCancelled && self->epub->prepareDeferredToc();
+            xSemaphoreTake(self->renderingMutex, portMAX_DELAY);
+            if (prepared && !self->tocTaskCancelled) {
+              self->epub->publishDeferredToc();
+              // Redraw so the status bar picks up the chapter title
+              self->updateRequired = true;
+            }
+            xSemaphoreGive(self->renderingMutex);
+            // Last access to the activity, onExit may free it as soon as this is given
+            xSemaphoreGive(self->tocTaskDone);
+            vTaskDelete(nullptr);
+          },
+          "EpubTocTask", 8192, this, 1, nullptr) != pdPASS) {
+    vSemaphoreDelete(tocTaskDone);
+    tocTaskDone = nullptr;
+  }
+}
+
 void EpubReaderActivity::displayTaskLoop() {
   while (true) {
     if (updateRequired) {
@@ -305,8 +354,8 @@ void EpubReaderActivity::renderScreen() {
         renderer.fillRect(boxXNoBar, boxY, boxWidthNoBar, boxHeightNoBar, false);
         renderer.drawText(UI_12_FONT_ID, boxXNoBar + boxMargin, boxY + boxMargin, "Indexing...");
         renderer.drawRect(boxXNoBar + 5, boxY + 5, boxWidthNoBar - 10, boxHeightNoBar - 10);
-        renderer.displayBuffer();
-        pagesUntilFullRefresh = 0;
+        renderer.flushDirtyRegion();
+        refreshScheduler.requestFullRefresh();
       }
 
       // Setup callback - only called for chapters >= 50KB, redraws with progress bar
@@ -315,14 +364,14 @@ void EpubReaderActivity::renderScreen() {
         renderer.drawText(UI_12_FONT_ID, boxXWithBar + boxMargin, boxY + boxMargin, "Indexing...");
         renderer.drawRect(boxXWithBar + 5, boxY + 5, boxWidthWithBar - 10, boxHeightWithBar - 10);
         renderer.drawRect(barX, barY, barWidth, barHeight);
-        renderer.displayBuffer();
+        renderer.flushDirtyRegion();
       };
 
       // Progress callback to update progress bar
       auto progressCallback = [this, barX, barY, barWidth, barHeight](int progress) {
         const int fillWidth = (barWidth - 2) * progress / 100;
         renderer.fillRect(barX + 1, barY + 1, fillWidth, barHeight - 2, true);
-        renderer.displayBuffer(EInkDisplay::FAST_REFRESH);
+        renderer.flushDirtyRegion();
       };
 
       if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
@@ -374,6 +423,9 @@ void EpubReaderActivity::renderScreen() {
     Serial.printf("[%lu] [ERS] Rendered page in %dms\n", millis(), millis() - start);
   }
 
+  // First page is on screen, finish a deferred TOC pass in the background
+  startDeferredTocTask();
+
   FsFile f;
   if (SdMan.openFileForWrite("ERS", epub->getCachePath() + "/progress.bin", f)) {
     uint8_t data[4];
@@ -391,20 +443,18 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
                                         const int orientedMarginLeft) {
   page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
   renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-  if (pagesUntilFullRefresh <= 1) {
+  if (refreshScheduler.update(renderer.getFrameBuffer(), SETTINGS.getRefreshFrequency())) {
     renderer.displayBuffer(EInkDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
   } else {
     renderer.displayBuffer();
-    pagesUntilFullRefresh--;
   }
 
-  // Save bw buffer to reset buffer state after grayscale data sync
-  renderer.storeBwBuffer();
-
   // grayscale rendering
   // TODO: Only do this if font supports it
   if (SETTINGS.textAntiAliasing) {
+    // Save bw buffer to reset buffer state after grayscale data sync
+    const bool bwStored = renderer.storeBwBuffer();
+
     renderer.clearScreen(0x00);
     renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
     page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
@@ -419,10 +469,17 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
     // display grayscale part
     renderer.displayGrayBuffer();
     renderer.setRenderMode(GfxRenderer::BW);
-  }
 
-  // restore the bw data
-  renderer.restoreBwBuffer();
+    // restore the bw data, or render it again if there was no heap to keep a copy
+    if (bwStored) {
+      renderer.restoreBwBuffer();
+    } else {
+      renderer.clearScreen();
+      page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+      renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+      renderer.cleanupGrayscaleWithFrameBuffer();
+    }
+  }
 }
 
 void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const int orientedMarginBottom,
@@ -436,6 +493,8 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
   const bool showBatteryPercentage =
       SETTINGS.hideBatteryPercentage == CrossPointSettings::HIDE_BATTERY_PERCENTAGE::HIDE_NEVER;
 
+  const StatusBarCache& cache = getStatusBarCache();
+
   // Position status bar near the bottom of the logical screen, regardless of orientation
   const auto screenHeight = renderer.getScreenHeight();
   const auto textY = screenHeight - orientedMarginBottom - 4;
@@ -444,7 +503,7 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
   if (showProgress) {
     // Calculate progress in book
     const float sectionChapterProg = static_cast<float>(section->currentPage) / section->pageCount;
-    const float bookProgress = epub->calculateProgress(currentSpineIndex, sectionChapterProg) * 100;
+    const float bookProgress = (cache.bookProgressStart + sectionChapterProg * cache.bookProgressSpan) * 100;
 
     // Right aligned text for progress counter
     char progressStr[32];
@@ -473,30 +532,46 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
     // available space.
     int titleMarginLeftAdjusted = std::max(titleMarginLeft, titleMarginRight);
     int availableTitleSpace = rendererableScreenWidth - 2 * titleMarginLeftAdjusted;
-    const int tocIndex = epub->getTocIndexForSpineIndex(currentSpineIndex);
+    if (cache.titleWidth > availableTitleSpace) {
+      // Not enough space to center on the screen, center it within the remaining space instead
+      availableTitleSpace = rendererableScreenWidth - titleMarginLeft - titleMarginRight;
+      titleMarginLeftAdjusted = titleMarginLeft;
+    }
 
-    std::string title;
-    int titleWidth;
-    if (tocIndex == -1) {
-      title = "Unnamed";
-      titleWidth = renderer.getTextWidth(SMALL_FONT_ID, "Unnamed");
-    } else {
-      const auto tocItem = epub->getTocItem(tocIndex);
-      title = tocItem.title;
-      titleWidth = renderer.getTextWidth(SMALL_FONT_ID, title.c_str());
-      if (titleWidth > availableTitleSpace) {
-        // Not enough space to center on the screen, center it within the remaining space instead
-        availableTitleSpace = rendererableScreenWidth - titleMarginLeft - titleMarginRight;
-        titleMarginLeftAdjusted = titleMarginLeft;
-      }
-      while (titleWidth > availableTitleSpace && title.length() > 11) {
-        title.replace(title.length() - 8, 8, "...");
-        titleWidth = renderer.getTextWidth(SMALL_FONT_ID, title.c_str());
-      }
+    // A title that fits is drawn as is. Otherwise it is only re-fitted when the space changed, which happens when the
+    // progress text width does.
+    if (cache.titleWidth > availableTitleSpace && cache.fittedSpace != availableTitleSpace) {
+      // Titles keep at least 11 bytes, as the status bar always did
+      statusBarCache.fittedTitle = renderer.truncatedText(SMALL_FONT_ID, cache.title.c_str(), availableTitleSpace,
+                                                          EpdFontFamily::REGULAR, &statusBarCache.fittedTitleWidth, 11);
+      statusBarCache.fittedSpace = availableTitleSpace;
     }
+    const bool titleFits = cache.titleWidth <= availableTitleSpace;
+    const std::string& title = titleFits ? cache.title : cache.fittedTitle;
+    const int titleWidth = titleFits ? cache.titleWidth : cache.fittedTitleWidth;
 
     renderer.drawText(SMALL_FONT_ID,
                       titleMarginLeftAdjusted + orientedMarginLeft + (availableTitleSpace - titleWidth) / 2, textY,
                       title.c_str());
   }
 }
+
+const EpubReaderActivity::StatusBarCache& EpubReaderActivity::getStatusBarCache() const {
+  const int tocCount = epub->getTocItemsCount();
+  if (statusBarCache.spineIndex == currentSpineIndex && statusBarCache.tocCount == tocCount) {
+    return statusBarCache;
+  }
+
+  StatusBarCache& cache = statusBarCache;
+  cache.spineIndex = currentSpineIndex;
+  cache.tocCount = tocCount;
+
+  const int tocIndex = epub->getTocIndexForSpineIndex(currentSpineIndex);
+  cache.title = tocIndex == -1 ? "Unnamed" : epub->getTocItem(tocIndex).title;
+  cache.titleWidth = renderer.getTextWidth(SMALL_FONT_ID, cache.title.c_str());
+  cache.fittedSpace = -1;
+
+  cache.bookProgressStart = epub->calculateProgress(currentSpineIndex, 0.0f);
+  cache.bookProgressSpan = epub->calculateProgress(currentSpineIndex, 1.0f) - cache.bookProgressStart;
+  return cache;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <Epub.h>
 #include <Epub/Section.h>
+#include <RefreshScheduler.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <freertos/task.h>
@@ -8,22 +9,45 @@
 #include "activities/ActivityWithSubactivity.h"
 
 class EpubReaderActivity final : public ActivityWithSubactivity {
+  // Status bar values that only change with the section, so page turns don't hit the SD card or re-measure the title
+  struct StatusBarCache {
+    int spineIndex = -1;
+    int tocCount = -1;  // TOC may still be filled in by the deferred TOC task
+    std::string title;
+    int titleWidth = 0;
+    // Title shortened for the space it was last fitted into
+    int fittedSpace = -1;
+    std::string fittedTitle;
+    int fittedTitleWidth = 0;
+    // Share of the book before this spine item, and the share the spine item itself covers
+    float bookProgressStart = 0;
+    float bookProgressSpan = 0;
+  };
+
   std::shared_ptr<Epub> epub;
   std::unique_ptr<Section> section = nullptr;
   TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
+  // Given by the deferred TOC task as its last action, onExit waits for it before tearing the activity down
+  SemaphoreHandle_t tocTaskDone = nullptr;
+  bool tocTaskCancelled = false;
+  // Confirm pressed while the TOC was still being built, the chapter list opens once it is ready
+  bool chapterSelectionRequested = false;
   int currentSpineIndex = 0;
   int nextPageNumber = 0;
-  int pagesUntilFullRefresh = 0;
+  RefreshScheduler refreshScheduler;
+  mutable StatusBarCache statusBarCache;
   bool updateRequired = false;
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
   static void taskTrampoline(void* param);
   [[noreturn]] void displayTaskLoop();
+  void startDeferredTocTask();
   void renderScreen();
   void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
                       int orientedMarginBottom, int orientedMarginLeft);
+  const StatusBarCache& getStatusBarCache() const;
   void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
 
  public:
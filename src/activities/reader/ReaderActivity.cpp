@@ -34,7 +34,8 @@ std::unique_ptr<Epub> ReaderActivity::loadEpub(const std::string& path) {
   }
 
   auto epub = std::unique_ptr<Epub>(new Epub(path, "/.crosspoint"));
-  if (epub->load()) {
+  // Defer the TOC pass on first open, EpubReaderActivity finishes it in the background
+  if (epub->load(true, true)) {
     return epub;
   }
 
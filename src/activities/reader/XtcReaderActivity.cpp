@@ -7,6 +7,7 @@
 
 #include "XtcReaderActivity.h"
 
+#include <Esp.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
 #include <SDCardManager.h>
@@ -21,6 +22,8 @@
 namespace {
 constexpr unsigned long skipPageMs = 700;
 constexpr unsigned long goHomeMs = 1000;
+// Heap that has to stay free besides the spare page buffers used for prefetching
+constexpr size_t prefetchHeapReserve = 64 * 1024;
 }  // namespace
 
 void XtcReaderActivity::taskTrampoline(void* param) {
@@ -69,6 +72,7 @@ void XtcReaderActivity::onExit() {
   }
   vSemaphoreDelete(renderingMutex);
   renderingMutex = nullptr;
+  freePageBuffers();
   xtc.reset();
 }
 
@@ -155,6 +159,10 @@ void XtcReaderActivity::displayTaskLoop() {
       xSemaphoreTake(renderingMutex, portMAX_DELAY);
       renderScreen();
       xSemaphoreGive(renderingMutex);
+    } else if (prefetchPending && !subActivity) {
+      xSemaphoreTake(renderingMutex, portMAX_DELAY);
+      prefetchPages();
+      xSemaphoreGive(renderingMutex);
     }
     vTaskDelay(10 / portTICK_PERIOD_MS);
   }
@@ -178,24 +186,109 @@ void XtcReaderActivity::renderScreen() {
   saveProgress();
 }
 
-void XtcReaderActivity::renderPage() {
+bool XtcReaderActivity::allocatePageBuffers() {
   const uint16_t pageWidth = xtc->getPageWidth();
   const uint16_t pageHeight = xtc->getPageHeight();
-  const uint8_t bitDepth = xtc->getBitDepth();
 
   // Calculate buffer size for one page
   // XTG (1-bit): Row-major, ((width+7)/8) * height bytes
   // XTH (2-bit): Two bit planes, column-major, ((width * height + 7) / 8) * 2 bytes
-  size_t pageBufferSize;
-  if (bitDepth == 2) {
+  if (xtc->getBitDepth() == 2) {
     pageBufferSize = ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2;
   } else {
     pageBufferSize = ((pageWidth + 7) / 8) * pageHeight;
   }
 
-  // Allocate page buffer
-  uint8_t* pageBuffer = static_cast<uint8_t*>(malloc(pageBufferSize));
-  if (!pageBuffer) {
+  pageBuffers[0].data = static_cast<uint8_t*>(malloc(pageBufferSize));
+  if (!pageBuffers[0].data) {
+    return false;
+  }
+  pageBufferCount = 1;
+
+  // Spares for prefetching only while they leave enough heap for everything else
+  while (pageBufferCount < MAX_PAGE_BUFFERS && ESP.getMaxAllocHeap() >= pageBufferSize + prefetchHeapReserve) {
+    auto* data = static_cast<uint8_t*>(malloc(pageBufferSize));
+    if (!data) {
+      break;
+    }
+    pageBuffers[pageBufferCount++].data = data;
+  }
+  Serial.printf("[%lu] [XTR] Allocated %d page buffers of %lu bytes (%d for prefetch)\n", millis(), pageBufferCount,
+                pageBufferSize, pageBufferCount - 1);
+  return true;
+}
+
+void XtcReaderActivity::freePageBuffers() {
+  for (auto& buffer : pageBuffers) {
+    free(buffer.data);
+    buffer = PageBuffer{};
+  }
+  pageBufferCount = 0;
+  shownBuffer = -1;
+  prefetchPending = false;
+}
+
+int XtcReaderActivity::findPageBuffer(const uint32_t page) const {
+  for (int i = 0; i < pageBufferCount; i++) {
+    if (pageBuffers[i].page == page) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int XtcReaderActivity::pickPageBuffer(const uint32_t around, const int keep) const {
+  // The buffer holding the page furthest from the one being read around, empty ones first
+  int best = -1;
+  uint32_t bestDistance = 0;
+  for (int i = 0; i < pageBufferCount; i++) {
+    if (i == keep) {
+      continue;
+    }
+    const uint32_t page = pageBuffers[i].page;
+    const uint32_t distance = page == NO_PAGE ? NO_PAGE : (page > around ? page - around : around - page);
+    if (best < 0 || distance > bestDistance) {
+      best = i;
+      bestDistance = distance;
+    }
+  }
+  return best;
+}
+
+void XtcReaderActivity::prefetchPages() {
+  prefetchPending = false;
+  const uint32_t shownPage = currentPage;
+
+  // Next page first, then the previous one if there is a second spare buffer
+  const uint32_t targets[] = {shownPage + 1, shownPage > 0 ? shownPage - 1 : NO_PAGE};
+  for (int i = 0; i < pageBufferCount - 1 && i < 2; i++) {
+    const uint32_t page = targets[i];
+    if (page >= xtc->getPageCount() || findPageBuffer(page) >= 0) {
+      continue;
+    }
+
+    const int slot = pickPageBuffer(shownPage, shownBuffer);
+    uint8_t* data = pageBuffers[slot].data;
+    pageBuffers[slot].page = NO_PAGE;
+    const unsigned long start = millis();
+    // Decoded in place like a shown page, so compressed pages need no dictionary window on top of the reserve.
+    // A turn onto this very page lets the read finish, a jump anywhere else stops it at the next chunk.
+    if (xtc->loadPage(page, data, pageBufferSize, [&] { return !updateRequired || currentPage == page; }) == 0) {
+      Serial.printf("[%lu] [XTR] Prefetch of page %lu stopped: %s\n", millis(), page,
+                    xtc::errorToString(xtc->getLastError()));
+      return;
+    }
+    pageBuffers[slot].page = page;
+    Serial.printf("[%lu] [XTR] Prefetched page %lu in %lu ms\n", millis(), page, millis() - start);
+  }
+}
+
+void XtcReaderActivity::renderPage() {
+  const uint16_t pageWidth = xtc->getPageWidth();
+  const uint16_t pageHeight = xtc->getPageHeight();
+  const uint8_t bitDepth = xtc->getBitDepth();
+
+  if (pageBufferCount == 0 && !allocatePageBuffers()) {
     Serial.printf("[%lu] [XTR] Failed to allocate page buffer (%lu bytes)\n", millis(), pageBufferSize);
     renderer.clearScreen();
     renderer.drawCenteredText(UI_12_FONT_ID, 300, "Memory error", true, EpdFontFamily::BOLD);
@@ -203,157 +296,97 @@ void XtcReaderActivity::renderPage() {
     return;
   }
 
-  // Load page data
-  size_t bytesRead = xtc->loadPage(currentPage, pageBuffer, pageBufferSize);
-  if (bytesRead == 0) {
-    Serial.printf("[%lu] [XTR] Failed to load page %lu\n", millis(), currentPage);
-    free(pageBuffer);
-    renderer.clearScreen();
-    renderer.drawCenteredText(UI_12_FONT_ID, 300, "Page load error", true, EpdFontFamily::BOLD);
-    renderer.displayBuffer();
-    return;
+  // A prefetched page is drawn straight away, anything else is loaded now
+  int slot = findPageBuffer(currentPage);
+  if (slot < 0) {
+    slot = pickPageBuffer(currentPage, -1);
+    pageBuffers[slot].page = NO_PAGE;
+    if (xtc->loadPage(currentPage, pageBuffers[slot].data, pageBufferSize) == 0) {
+      Serial.printf("[%lu] [XTR] Failed to load page %lu\n", millis(), currentPage);
+      renderer.clearScreen();
+      renderer.drawCenteredText(UI_12_FONT_ID, 300, "Page load error", true, EpdFontFamily::BOLD);
+      renderer.displayBuffer();
+      return;
+    }
+    pageBuffers[slot].page = currentPage;
   }
+  shownBuffer = slot;
+  prefetchPending = pageBufferCount > 1;
+  const uint8_t* pageBuffer = pageBuffers[slot].data;
 
   // Clear screen first
   renderer.clearScreen();
 
-  // Copy page bitmap using GfxRenderer's drawPixel
   // XTC/XTCH pages are pre-rendered with status bar included, so render full page
-  const uint16_t maxSrcY = pageHeight;
-
   if (bitDepth == 2) {
-    // XTH 2-bit mode: Two bit planes, column-major order
-    // - Columns scanned right to left (x = width-1 down to 0)
-    // - 8 vertical pixels per byte (MSB = topmost pixel in group)
-    // - First plane: Bit1, Second plane: Bit2
-    // - Pixel value = (bit1 << 1) | bit2
-    // - Grayscale: 0=White, 1=Dark Grey, 2=Light Grey, 3=Black
-
-    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
-    const uint8_t* plane1 = pageBuffer;              // Bit1 plane
-    const uint8_t* plane2 = pageBuffer + planeSize;  // Bit2 plane
-    const size_t colBytes = (pageHeight + 7) / 8;    // Bytes per column (100 for 800 height)
-
-    // Lambda to get pixel value at (x, y)
-    auto getPixelValue = [&](uint16_t x, uint16_t y) -> uint8_t {
-      const size_t colIndex = pageWidth - 1 - x;
-      const size_t byteInCol = y / 8;
-      const size_t bitInByte = 7 - (y % 8);
-      const size_t byteOffset = colIndex * colBytes + byteInCol;
-      const uint8_t bit1 = (plane1[byteOffset] >> bitInByte) & 1;
-      const uint8_t bit2 = (plane2[byteOffset] >> bitInByte) & 1;
-      return (bit1 << 1) | bit2;
-    };
-
     // Optimized grayscale rendering without storeBwBuffer (saves 48KB peak memory)
     // Flow: BW display → LSB/MSB passes → grayscale display → re-render BW for next frame
+    // Each pass is a byte-wise blit of the page planes (see xtc::drawPage), so redrawing per pass is cheap
 
-    // Count pixel distribution for debugging
+#ifdef XTC_PIXEL_STATS
+    // Count pixel distribution for debugging, a byte of 8 pixels at a time
+    const size_t planeSize = (static_cast<size_t>(pageWidth) * pageHeight + 7) / 8;
     uint32_t pixelCounts[4] = {0, 0, 0, 0};
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        pixelCounts[getPixelValue(x, y)]++;
-      }
+    for (size_t i = 0; i < planeSize; i++) {
+      const uint8_t bit1 = pageBuffer[i];
+      const uint8_t bit2 = pageBuffer[planeSize + i];
+      pixelCounts[1] += __builtin_popcount(~bit1 & bit2 & 0xFF);
+      pixelCounts[2] += __builtin_popcount(bit1 & ~bit2 & 0xFF);
+      pixelCounts[3] += __builtin_popcount(bit1 & bit2);
     }
+    pixelCounts[0] = static_cast<uint32_t>(pageWidth) * pageHeight - pixelCounts[1] - pixelCounts[2] - pixelCounts[3];
     Serial.printf("[%lu] [XTR] Pixel distribution: White=%lu, DarkGrey=%lu, LightGrey=%lu, Black=%lu\n", millis(),
                   pixelCounts[0], pixelCounts[1], pixelCounts[2], pixelCounts[3]);
+#endif
 
     // Pass 1: BW buffer - draw all non-white pixels as black
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
+    xtc::drawPage(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
 
-    // Display BW with conditional refresh based on pagesUntilFullRefresh
-    if (pagesUntilFullRefresh <= 1) {
+    // Display BW, with a full refresh once enough ghosting has built up
+    if (refreshScheduler.update(renderer.getFrameBuffer(), SETTINGS.getRefreshFrequency())) {
       renderer.displayBuffer(EInkDisplay::HALF_REFRESH);
-      pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
     } else {
       renderer.displayBuffer();
-      pagesUntilFullRefresh--;
     }
 
     // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
-    // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) == 1) {  // Dark grey only
-          renderer.drawPixel(x, y, false);
-        }
-      }
-    }
+    renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
+    xtc::drawPage(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
     renderer.copyGrayscaleLsbBuffers();
 
     // Pass 3: MSB buffer - mark LIGHT AND DARK gray (XTH value 1 or 2)
-    // In LUT: 0 bit = apply gray effect, 1 bit = untouched
     renderer.clearScreen(0x00);
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        const uint8_t pv = getPixelValue(x, y);
-        if (pv == 1 || pv == 2) {  // Dark grey or Light grey
-          renderer.drawPixel(x, y, false);
-        }
-      }
-    }
+    renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
+    xtc::drawPage(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
     renderer.copyGrayscaleMsbBuffers();
 
     // Display grayscale overlay
     renderer.displayGrayBuffer();
+    renderer.setRenderMode(GfxRenderer::BW);
 
     // Pass 4: Re-render BW to framebuffer (restore for next frame, instead of restoreBwBuffer)
     renderer.clearScreen();
-    for (uint16_t y = 0; y < pageHeight; y++) {
-      for (uint16_t x = 0; x < pageWidth; x++) {
-        if (getPixelValue(x, y) >= 1) {
-          renderer.drawPixel(x, y, true);
-        }
-      }
-    }
+    xtc::drawPage(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
 
     // Cleanup grayscale buffers with current frame buffer
     renderer.cleanupGrayscaleWithFrameBuffer();
 
-    free(pageBuffer);
-
     Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (2-bit grayscale)\n", millis(), currentPage + 1,
                   xtc->getPageCount());
     return;
-  } else {
-    // 1-bit mode: 8 pixels per byte, MSB first
-    const size_t srcRowBytes = (pageWidth + 7) / 8;  // 60 bytes for 480 width
-
-    for (uint16_t srcY = 0; srcY < maxSrcY; srcY++) {
-      const size_t srcRowStart = srcY * srcRowBytes;
-
-      for (uint16_t srcX = 0; srcX < pageWidth; srcX++) {
-        // Read source pixel (MSB first, bit 7 = leftmost pixel)
-        const size_t srcByte = srcRowStart + srcX / 8;
-        const size_t srcBit = 7 - (srcX % 8);
-        const bool isBlack = !((pageBuffer[srcByte] >> srcBit) & 1);  // XTC: 0 = black, 1 = white
-
-        if (isBlack) {
-          renderer.drawPixel(srcX, srcY, true);
-        }
-      }
-    }
   }
-  // White pixels are already cleared by clearScreen()
 
-  free(pageBuffer);
+  // 1-bit mode: white pixels are already cleared by clearScreen()
+  xtc::drawPage(renderer, pageBuffer, pageWidth, pageHeight, bitDepth);
 
   // XTC pages already have status bar pre-rendered, no need to add our own
 
   // Display with appropriate refresh
-  if (pagesUntilFullRefresh <= 1) {
+  if (refreshScheduler.update(renderer.getFrameBuffer(), SETTINGS.getRefreshFrequency())) {
     renderer.displayBuffer(EInkDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
   } else {
     renderer.displayBuffer();
-    pagesUntilFullRefresh--;
   }
 
   Serial.printf("[%lu] [XTR] Rendered page %lu/%lu (%u-bit)\n", millis(), currentPage + 1, xtc->getPageCount(),
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <RefreshScheduler.h>
 #include <Xtc.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
@@ -19,8 +20,23 @@ class XtcReaderActivity final : public ActivityWithSubactivity {
   TaskHandle_t displayTaskHandle = nullptr;
   SemaphoreHandle_t renderingMutex = nullptr;
   uint32_t currentPage = 0;
-  int pagesUntilFullRefresh = 0;
+  RefreshScheduler refreshScheduler;
   bool updateRequired = false;
+
+  // Page data buffers: the page on screen plus spares, as many as free heap allows, which the display task fills with
+  // the next and previous page while idle
+  static constexpr int MAX_PAGE_BUFFERS = 3;
+  static constexpr uint32_t NO_PAGE = UINT32_MAX;
+  struct PageBuffer {
+    uint8_t* data = nullptr;
+    uint32_t page = NO_PAGE;
+  };
+  PageBuffer pageBuffers[MAX_PAGE_BUFFERS];
+  int pageBufferCount = 0;
+  size_t pageBufferSize = 0;
+  int shownBuffer = -1;
+  bool prefetchPending = false;
+
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
@@ -28,6 +44,11 @@ class XtcReaderActivity final : public ActivityWithSubactivity {
   [[noreturn]] void displayTaskLoop();
   void renderScreen();
   void renderPage();
+  bool allocatePageBuffers();
+  void freePageBuffers();
+  int findPageBuffer(uint32_t page) const;
+  int pickPageBuffer(uint32_t around, int keep) const;
+  void prefetchPages();
   void saveProgress() const;
   void loadProgress();
 
@@ -348,7 +348,7 @@ void KeyboardEntryActivity::render() const {
   // Draw side button hints for Up/Down navigation
   renderer.drawSideButtonHints(UI_10_FONT_ID, "Up", "Down");
 
-  renderer.displayBuffer();
+  renderer.flushDirtyRegion();
 }
 
 void KeyboardEntryActivity::renderItemWithSelector(const int x, const int y, const char* item,
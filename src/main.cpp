@@ -1,5 +1,6 @@
 #include <Arduino.h>
 #include <EInkDisplay.h>
+#include <EpdSdFont.h>
 #include <Epub.h>
 #include <GfxRenderer.h>
 #include <InputManager.h>
@@ -46,79 +47,85 @@ GfxRenderer renderer(einkDisplay);
 Activity* currentActivity;
 
 // Fonts
+#ifdef SYNTHESIZE_FONT_STYLES
+// Reader bold and italic faces are synthesized from the regular bitmaps at draw time instead of stored in flash
+#define READER_FONT(font, data, style, synthesis) EpdFont font(&data##_regular, synthesis)
+#else
+#define READER_FONT(font, data, style, synthesis) EpdFont font(&data##_##style)
+#endif
 EpdFont bookerly14RegularFont(&bookerly_14_regular);
-EpdFont bookerly14BoldFont(&bookerly_14_bold);
-EpdFont bookerly14ItalicFont(&bookerly_14_italic);
-EpdFont bookerly14BoldItalicFont(&bookerly_14_bolditalic);
+READER_FONT(bookerly14BoldFont, bookerly_14, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(bookerly14ItalicFont, bookerly_14, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(bookerly14BoldItalicFont, bookerly_14, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily bookerly14FontFamily(&bookerly14RegularFont, &bookerly14BoldFont, &bookerly14ItalicFont,
                                    &bookerly14BoldItalicFont);
 #ifndef OMIT_FONTS
 EpdFont bookerly12RegularFont(&bookerly_12_regular);
-EpdFont bookerly12BoldFont(&bookerly_12_bold);
-EpdFont bookerly12ItalicFont(&bookerly_12_italic);
-EpdFont bookerly12BoldItalicFont(&bookerly_12_bolditalic);
+READER_FONT(bookerly12BoldFont, bookerly_12, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(bookerly12ItalicFont, bookerly_12, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(bookerly12BoldItalicFont, bookerly_12, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily bookerly12FontFamily(&bookerly12RegularFont, &bookerly12BoldFont, &bookerly12ItalicFont,
                                    &bookerly12BoldItalicFont);
 EpdFont bookerly16RegularFont(&bookerly_16_regular);
-EpdFont bookerly16BoldFont(&bookerly_16_bold);
-EpdFont bookerly16ItalicFont(&bookerly_16_italic);
-EpdFont bookerly16BoldItalicFont(&bookerly_16_bolditalic);
+READER_FONT(bookerly16BoldFont, bookerly_16, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(bookerly16ItalicFont, bookerly_16, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(bookerly16BoldItalicFont, bookerly_16, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily bookerly16FontFamily(&bookerly16RegularFont, &bookerly16BoldFont, &bookerly16ItalicFont,
                                    &bookerly16BoldItalicFont);
 EpdFont bookerly18RegularFont(&bookerly_18_regular);
-EpdFont bookerly18BoldFont(&bookerly_18_bold);
-EpdFont bookerly18ItalicFont(&bookerly_18_italic);
-EpdFont bookerly18BoldItalicFont(&bookerly_18_bolditalic);
+READER_FONT(bookerly18BoldFont, bookerly_18, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(bookerly18ItalicFont, bookerly_18, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(bookerly18BoldItalicFont, bookerly_18, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily bookerly18FontFamily(&bookerly18RegularFont, &bookerly18BoldFont, &bookerly18ItalicFont,
                                    &bookerly18BoldItalicFont);
 
 EpdFont notosans12RegularFont(&notosans_12_regular);
-EpdFont notosans12BoldFont(&notosans_12_bold);
-EpdFont notosans12ItalicFont(&notosans_12_italic);
-EpdFont notosans12BoldItalicFont(&notosans_12_bolditalic);
+READER_FONT(notosans12BoldFont, notosans_12, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(notosans12ItalicFont, notosans_12, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(notosans12BoldItalicFont, notosans_12, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily notosans12FontFamily(&notosans12RegularFont, &notosans12BoldFont, &notosans12ItalicFont,
                                    &notosans12BoldItalicFont);
 EpdFont notosans14RegularFont(&notosans_14_regular);
-EpdFont notosans14BoldFont(&notosans_14_bold);
-EpdFont notosans14ItalicFont(&notosans_14_italic);
-EpdFont notosans14BoldItalicFont(&notosans_14_bolditalic);
+READER_FONT(notosans14BoldFont, notosans_14, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(notosans14ItalicFont, notosans_14, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(notosans14BoldItalicFont, notosans_14, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily notosans14FontFamily(&notosans14RegularFont, &notosans14BoldFont, &notosans14ItalicFont,
                                    &notosans14BoldItalicFont);
 EpdFont notosans16RegularFont(&notosans_16_regular);
-EpdFont notosans16BoldFont(&notosans_16_bold);
-EpdFont notosans16ItalicFont(&notosans_16_italic);
-EpdFont notosans16BoldItalicFont(&notosans_16_bolditalic);
+READER_FONT(notosans16BoldFont, notosans_16, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(notosans16ItalicFont, notosans_16, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(notosans16BoldItalicFont, notosans_16, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily notosans16FontFamily(&notosans16RegularFont, &notosans16BoldFont, &notosans16ItalicFont,
                                    &notosans16BoldItalicFont);
 EpdFont notosans18RegularFont(&notosans_18_regular);
-EpdFont notosans18BoldFont(&notosans_18_bold);
-EpdFont notosans18ItalicFont(&notosans_18_italic);
-EpdFont notosans18BoldItalicFont(&notosans_18_bolditalic);
+READER_FONT(notosans18BoldFont, notosans_18, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(notosans18ItalicFont, notosans_18, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(notosans18BoldItalicFont, notosans_18, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily notosans18FontFamily(&notosans18RegularFont, &notosans18BoldFont, &notosans18ItalicFont,
                                    &notosans18BoldItalicFont);
 
 EpdFont opendyslexic8RegularFont(&opendyslexic_8_regular);
-EpdFont opendyslexic8BoldFont(&opendyslexic_8_bold);
-EpdFont opendyslexic8ItalicFont(&opendyslexic_8_italic);
-EpdFont opendyslexic8BoldItalicFont(&opendyslexic_8_bolditalic);
+READER_FONT(opendyslexic8BoldFont, opendyslexic_8, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(opendyslexic8ItalicFont, opendyslexic_8, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(opendyslexic8BoldItalicFont, opendyslexic_8, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily opendyslexic8FontFamily(&opendyslexic8RegularFont, &opendyslexic8BoldFont, &opendyslexic8ItalicFont,
                                       &opendyslexic8BoldItalicFont);
 EpdFont opendyslexic10RegularFont(&opendyslexic_10_regular);
-EpdFont opendyslexic10BoldFont(&opendyslexic_10_bold);
-EpdFont opendyslexic10ItalicFont(&opendyslexic_10_italic);
-EpdFont opendyslexic10BoldItalicFont(&opendyslexic_10_bolditalic);
+READER_FONT(opendyslexic10BoldFont, opendyslexic_10, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(opendyslexic10ItalicFont, opendyslexic_10, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(opendyslexic10BoldItalicFont, opendyslexic_10, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily opendyslexic10FontFamily(&opendyslexic10RegularFont, &opendyslexic10BoldFont, &opendyslexic10ItalicFont,
                                        &opendyslexic10BoldItalicFont);
 EpdFont opendyslexic12RegularFont(&opendyslexic_12_regular);
-EpdFont opendyslexic12BoldFont(&opendyslexic_12_bold);
-EpdFont opendyslexic12ItalicFont(&opendyslexic_12_italic);
-EpdFont opendyslexic12BoldItalicFont(&opendyslexic_12_bolditalic);
+READER_FONT(opendyslexic12BoldFont, opendyslexic_12, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(opendyslexic12ItalicFont, opendyslexic_12, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(opendyslexic12BoldItalicFont, opendyslexic_12, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily opendyslexic12FontFamily(&opendyslexic12RegularFont, &opendyslexic12BoldFont, &opendyslexic12ItalicFont,
                                        &opendyslexic12BoldItalicFont);
 EpdFont opendyslexic14RegularFont(&opendyslexic_14_regular);
-EpdFont opendyslexic14BoldFont(&opendyslexic_14_bold);
-EpdFont opendyslexic14ItalicFont(&opendyslexic_14_italic);
-EpdFont opendyslexic14BoldItalicFont(&opendyslexic_14_bolditalic);
+READER_FONT(opendyslexic14BoldFont, opendyslexic_14, bold, EpdFont::SYNTH_BOLD);
+READER_FONT(opendyslexic14ItalicFont, opendyslexic_14, italic, EpdFont::SYNTH_ITALIC);
+READER_FONT(opendyslexic14BoldItalicFont, opendyslexic_14, bolditalic, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
 EpdFontFamily opendyslexic14FontFamily(&opendyslexic14RegularFont, &opendyslexic14BoldFont, &opendyslexic14ItalicFont,
                                        &opendyslexic14BoldItalicFont);
 #endif  // OMIT_FONTS
@@ -134,6 +141,16 @@ EpdFont ui12RegularFont(&ubuntu_12_regular);
 EpdFont ui12BoldFont(&ubuntu_12_bold);
 EpdFontFamily ui12FontFamily(&ui12RegularFont, &ui12BoldFont);
 
+// Reader font from the SD card (fontconvert.py --binary), bold and italic are synthesized from it
+constexpr char SD_READER_FONT_PATH[] = "/fonts/reader.epdfont";
+EpdSdFont sdReaderFont;
+EpdFont sdReaderRegularFont(sdReaderFont.getData(), &sdReaderFont);
+EpdFont sdReaderBoldFont(sdReaderFont.getData(), &sdReaderFont, EpdFont::SYNTH_BOLD);
+EpdFont sdReaderItalicFont(sdReaderFont.getData(), &sdReaderFont, EpdFont::SYNTH_ITALIC);
+EpdFont sdReaderBoldItalicFont(sdReaderFont.getData(), &sdReaderFont, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
+EpdFontFamily sdReaderFontFamily(&sdReaderRegularFont, &sdReaderBoldFont, &sdReaderItalicFont,
+                                 &sdReaderBoldItalicFont);
+
 // measurement of power button press duration calibration value
 unsigned long t1 = 0;
 unsigned long t2 = 0;
@@ -273,6 +290,10 @@ void setupDisplayAndFonts() {
   renderer.insertFont(UI_10_FONT_ID, ui10FontFamily);
   renderer.insertFont(UI_12_FONT_ID, ui12FontFamily);
   renderer.insertFont(SMALL_FONT_ID, smallFontFamily);
+  if (SdMan.exists(SD_READER_FONT_PATH) && sdReaderFont.load(SD_READER_FONT_PATH)) {
+    SETTINGS.sdReaderFontId = sdReaderFont.getFontId();
+    renderer.insertFont(SETTINGS.sdReaderFontId, sdReaderFontFamily);
+  }
   Serial.printf("[%lu] [   ] Fonts setup\n", millis());
 }
 
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 
+#include "SleepImageIndex.h"
 #include "html/FilesPageHtml.generated.h"
 #include "html/HomePageHtml.generated.h"
 #include "util/StringUtils.h"
@@ -39,6 +40,13 @@ void clearEpubCacheIfNeeded(const String& filePath) {
     Serial.printf("[%lu] [WEB] Cleared epub cache for: %s\n", millis(), filePath.c_str());
   }
 }
+
+// Files written or removed here leave the directory time alone, so the sleep image index is told directly
+void invalidateSleepIndexIfNeeded(const String& filePath) {
+  if (filePath.startsWith("/sleep/")) {
+    SleepImageIndex::invalidate();
+  }
+}
 }  // namespace
 
 // File listing page template - now using generated headers:
@@ -517,6 +525,7 @@ void CrossPointWebServer::handleUpload() const {
         if (!filePath.endsWith("/")) filePath += "/";
         filePath += uploadFileName;
         clearEpubCacheIfNeeded(filePath);
+        invalidateSleepIndexIfNeeded(filePath);
       }
     }
   } else if (upload.status == UPLOAD_FILE_ABORTED) {
@@ -667,6 +676,7 @@ void CrossPointWebServer::handleDelete() const {
   }
 
   if (success) {
+    invalidateSleepIndexIfNeeded(itemPath);
     Serial.printf("[%lu] [WEB] Successfully deleted: %s\n", millis(), itemPath.c_str());
     server->send(200, "text/plain", "Deleted successfully");
   } else {
@@ -809,6 +819,7 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
         if (!filePath.endsWith("/")) filePath += "/";
         filePath += wsUploadFileName;
         clearEpubCacheIfNeeded(filePath);
+        invalidateSleepIndexIfNeeded(filePath);
 
         wsServer->sendTXT(num, "DONE");
         lastProgressSent = 0;
@@ -0,0 +1,322 @@
+#include <BitmapHelpers.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Host benchmark for the cover ditherers: runs the error diffusion ditherers (Atkinson, Floyd-Steinberg), the plain
+// and noise quantizers and the ordered ditherers (Bayer, blue noise) over the same gray images, 2-bit and 1-bit.
+//
+// Reports the time per pixel including packing into BMP row bytes, and a perceived error: output levels and input are
+// both blurred with a Gaussian (sigma 1.5 px, roughly the eye at reading distance) and compared as RMSE, with the
+// mean tone shift alongside. Output PGMs of every method go to build/dither_bench for a look.
+
+namespace {
+
+constexpr int kWidth = 480;
+constexpr int kHeight = 800;
+constexpr int kIterations = 20;
+constexpr double kBlurSigma = 1.5;
+// 2-bit output levels as the ditherers model the display
+constexpr int kLevels2Bit[4] = {15, 30, 80, 210};
+
+using Clock = std::chrono::steady_clock;
+
+struct Image {
+  std::string name;
+  int width;
+  int height;
+  std::vector<uint8_t> gray;
+};
+
+// Smooth horizontal ramp, the hardest case for banding and texture
+Image makeRamp() {
+  Image image{"ramp", kWidth, kHeight, std::vector<uint8_t>(kWidth * kHeight)};
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      image.gray[y * kWidth + x] = static_cast<uint8_t>(x * 255 / (kWidth - 1));
+    }
+  }
+  return image;
+}
+
+// Photo-like: soft shapes, shading and a fine halftone-ish texture
+Image makePhoto() {
+  Image image{"photo", kWidth, kHeight, std::vector<uint8_t>(kWidth * kHeight)};
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      const double dx = x - kWidth * 0.4, dy = y - kHeight * 0.35;
+      double v = 140 + 90 * std::exp(-(dx * dx + dy * dy) / (2 * 110.0 * 110.0));
+      v -= 60 * std::sin(y * 0.012) * std::cos(x * 0.02);
+      v += 25 * std::sin(x * 0.9 + y * 0.7);
+      if (y > kHeight * 0.7) v *= 0.45 + 0.4 * x / kWidth;
+      image.gray[y * kWidth + x] = static_cast<uint8_t>(std::clamp(v, 0.0, 255.0));
+    }
+  }
+  return image;
+}
+
+// Title-like: hard black strokes on white over a mid gray band
+Image makeText() {
+  Image image{"text", kWidth, kHeight, std::vector<uint8_t>(kWidth * kHeight, 235)};
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      uint8_t& p = image.gray[y * kWidth + x];
+      if (y > 300 && y < 500) p = 128;
+      const bool stroke = ((x / 3) % 7 == 0 && (y / 40) % 2 == 0) || ((y / 3) % 11 == 0 && (x / 50) % 2 == 1);
+      if (stroke && y > 100) p = 10;
+    }
+  }
+  return image;
+}
+
+// Binary PGM (P5, 8-bit)
+bool readPgm(const std::string& path, Image* image) {
+  std::ifstream in(path, std::ios::binary);
+  std::string magic;
+  int maxValue = 0;
+  in >> magic >> image->width >> image->height >> maxValue;
+  in.get();
+  if (magic != "P5" || maxValue != 255 || image->width <= 0 || image->height <= 0) {
+    return false;
+  }
+  image->gray.resize(static_cast<size_t>(image->width) * image->height);
+  in.read(reinterpret_cast<char*>(image->gray.data()), static_cast<std::streamsize>(image->gray.size()));
+  const size_t slash = path.find_last_of('/');
+  image->name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+  return static_cast<bool>(in);
+}
+
+void writePgm(const std::string& path, const int width, const int height, const std::vector<uint8_t>& gray) {
+  std::ofstream out(path, std::ios::binary);
+  out << "P5\n" << width << " " << height << "\n255\n";
+  out.write(reinterpret_cast<const char*>(gray.data()), static_cast<std::streamsize>(gray.size()));
+}
+
+// Dithers the whole image into packed BMP rows (top row first)
+using Dither = std::function<void(const Image&, std::vector<uint8_t>*)>;
+
+struct Method {
+  const char* name;
+  bool oneBit;
+  Dither run;
+};
+
+int rowBytes(const int width, const bool oneBit) { return oneBit ? (width + 7) / 8 : (width + 3) / 4; }
+
+template <typename Ditherer>
+Dither diffusion2Bit() {
+  return [](const Image& image, std::vector<uint8_t>* out) {
+    const int stride = rowBytes(image.width, false);
+    Ditherer ditherer(image.width);
+    for (int y = 0; y < image.height; y++) {
+      uint8_t* row = out->data() + y * stride;
+      memset(row, 0, stride);
+      for (int x = 0; x < image.width; x++) {
+        row[x >> 2] |= ditherer.processPixel(adjustPixel(image.gray[y * image.width + x]), x) << (6 - (x & 3) * 2);
+      }
+      ditherer.nextRow();
+    }
+  };
+}
+
+Dither perPixel2Bit(uint8_t (*quantizer)(int, int, int)) {
+  return [quantizer](const Image& image, std::vector<uint8_t>* out) {
+    const int stride = rowBytes(image.width, false);
+    for (int y = 0; y < image.height; y++) {
+      uint8_t* row = out->data() + y * stride;
+      memset(row, 0, stride);
+      for (int x = 0; x < image.width; x++) {
+        row[x >> 2] |= quantizer(adjustPixel(image.gray[y * image.width + x]), x, y) << (6 - (x & 3) * 2);
+      }
+    }
+  };
+}
+
+Dither atkinson1Bit() {
+  return [](const Image& image, std::vector<uint8_t>* out) {
+    const int stride = rowBytes(image.width, true);
+    Atkinson1BitDitherer ditherer(image.width);
+    for (int y = 0; y < image.height; y++) {
+      uint8_t* row = out->data() + y * stride;
+      memset(row, 0, stride);
+      for (int x = 0; x < image.width; x++) {
+        row[x >> 3] |= ditherer.processPixel(image.gray[y * image.width + x], x) << (7 - (x & 7));
+      }
+      ditherer.nextRow();
+    }
+  };
+}
+
+Dither noise1Bit() {
+  return [](const Image& image, std::vector<uint8_t>* out) {
+    const int stride = rowBytes(image.width, true);
+    for (int y = 0; y < image.height; y++) {
+      uint8_t* row = out->data() + y * stride;
+      memset(row, 0, stride);
+      for (int x = 0; x < image.width; x++) {
+        row[x >> 3] |= quantize1bit(image.gray[y * image.width + x], x, y) << (7 - (x & 7));
+      }
+    }
+  };
+}
+
+// Same row preparation as ScaledBmpWriter: adjusted gray row, then the row ditherer
+Dither ordered(const DitherPattern pattern, const bool oneBit) {
+  return [pattern, oneBit](const Image& image, std::vector<uint8_t>* out) {
+    const int stride = rowBytes(image.width, oneBit);
+    std::vector<uint8_t> grayRow(image.width);
+    for (int y = 0; y < image.height; y++) {
+      for (int x = 0; x < image.width; x++) {
+        grayRow[x] = adjustPixel(image.gray[y * image.width + x]);
+      }
+      if (oneBit) {
+        orderedDitherRow1Bit(grayRow.data(), image.width, y, pattern, out->data() + y * stride);
+      } else {
+        orderedDitherRow2Bit(grayRow.data(), image.width, y, pattern, out->data() + y * stride);
+      }
+    }
+  };
+}
+
+uint8_t quantizeSimpleAt(const int gray, int, int) { return quantizeSimple(gray); }
+
+// Output levels as the intensities the ditherers aim for
+std::vector<double> unpack(const std::vector<uint8_t>& packed, const int width, const int height, const bool oneBit) {
+  std::vector<double> values(static_cast<size_t>(width) * height);
+  const int stride = rowBytes(width, oneBit);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const uint8_t byte = packed[y * stride + (oneBit ? x >> 3 : x >> 2)];
+      values[y * width + x] =
+          oneBit ? ((byte >> (7 - (x & 7))) & 1) * 255.0 : kLevels2Bit[(byte >> (6 - (x & 3) * 2)) & 3];
+    }
+  }
+  return values;
+}
+
+std::vector<double> blur(const std::vector<double>& in, const int width, const int height) {
+  const int radius = static_cast<int>(std::ceil(kBlurSigma * 3));
+  std::vector<double> kernel(radius * 2 + 1);
+  double sum = 0;
+  for (int i = -radius; i <= radius; i++) {
+    kernel[i + radius] = std::exp(-i * i / (2 * kBlurSigma * kBlurSigma));
+    sum += kernel[i + radius];
+  }
+  for (double& k : kernel) k /= sum;
+
+  std::vector<double> tmp(in.size()), out(in.size());
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      double v = 0;
+      for (int i = -radius; i <= radius; i++) {
+        v += kernel[i + radius] * in[y * width + std::clamp(x + i, 0, width - 1)];
+      }
+      tmp[y * width + x] = v;
+    }
+  }
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      double v = 0;
+      for (int i = -radius; i <= radius; i++) {
+        v += kernel[i + radius] * tmp[std::clamp(y + i, 0, height - 1) * width + x];
+      }
+      out[y * width + x] = v;
+    }
+  }
+  return out;
+}
+
+void benchmarkImage(const Image& image, const std::vector<Method>& methods, const std::string& outDir) {
+  const size_t pixels = static_cast<size_t>(image.width) * image.height;
+  // The reference is the input as far as the output levels can show it
+  std::vector<double> target2Bit(pixels), target1Bit(pixels);
+  for (size_t i = 0; i < pixels; i++) {
+    const int gray = adjustPixel(image.gray[i]);
+    target2Bit[i] = std::clamp(gray, kLevels2Bit[0], kLevels2Bit[3]);
+    target1Bit[i] = gray;
+  }
+  const std::vector<double> blurred2Bit = blur(target2Bit, image.width, image.height);
+  const std::vector<double> blurred1Bit = blur(target1Bit, image.width, image.height);
+
+  printf("%s (%dx%d)\n", image.name.c_str(), image.width, image.height);
+  for (const Method& method : methods) {
+    std::vector<uint8_t> packed(static_cast<size_t>(rowBytes(image.width, method.oneBit)) * image.height);
+    method.run(image, &packed);  // Warm up
+    const auto start = Clock::now();
+    for (int i = 0; i < kIterations; i++) {
+      method.run(image, &packed);
+    }
+    const double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    const double ns = elapsedNs / kIterations / static_cast<double>(pixels);
+
+    const std::vector<double> values = unpack(packed, image.width, image.height, method.oneBit);
+    const std::vector<double> blurred = blur(values, image.width, image.height);
+    const std::vector<double>& reference = method.oneBit ? blurred1Bit : blurred2Bit;
+    double squared = 0, shift = 0;
+    for (size_t i = 0; i < pixels; i++) {
+      const double diff = blurred[i] - reference[i];
+      squared += diff * diff;
+      shift += diff;
+    }
+    printf("  %-16s %s  %6.2f ns/px  blurred RMSE %6.2f  mean shift %+6.2f\n", method.name,
+           method.oneBit ? "1-bit" : "2-bit", ns, std::sqrt(squared / pixels), shift / pixels);
+
+    std::vector<uint8_t> preview(pixels);
+    for (size_t i = 0; i < pixels; i++) {
+      preview[i] = static_cast<uint8_t>(values[i]);
+    }
+    writePgm(outDir + "/" + image.name + "_" + method.name + (method.oneBit ? "_1bit" : "_2bit") + ".pgm",
+             image.width, image.height, preview);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string outDir = "build/dither_bench";
+  std::vector<Image> images;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (arg == "--image" && i + 1 < argc) {
+      Image image;
+      if (!readPgm(argv[++i], &image)) {
+        fprintf(stderr, "Not an 8-bit binary PGM: %s\n", argv[i]);
+        return 2;
+      }
+      images.push_back(image);
+    } else {
+      fprintf(stderr, "Usage: DitherBenchmark [--image FILE.pgm]... [--out DIR]\n");
+      return 2;
+    }
+  }
+  if (images.empty()) {
+    images = {makeRamp(), makePhoto(), makeText()};
+  }
+  std::filesystem::create_directories(outDir);
+
+  const std::vector<Method> methods = {
+      {"threshold", false, perPixel2Bit(quantizeSimpleAt)},
+      {"atkinson", false, diffusion2Bit<AtkinsonDitherer>()},
+      {"floyd-steinberg", false, diffusion2Bit<FloydSteinbergDitherer>()},
+      {"bayer", false, ordered(DitherPattern::Bayer, false)},
+      {"blue-noise", false, ordered(DitherPattern::BlueNoise, false)},
+      {"noise", true, noise1Bit()},
+      {"atkinson", true, atkinson1Bit()},
+      {"bayer", true, ordered(DitherPattern::Bayer, true)},
+      {"blue-noise", true, ordered(DitherPattern::BlueNoise, true)},
+  };
+  for (const Image& image : images) {
+    benchmarkImage(image, methods, outDir);
+  }
+  return 0;
+}
@@ -0,0 +1,259 @@
+#include <EpdFont.h>
+#include <EpdGlyphCache.h>
+#include <Utf8.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/notosans_14_regular.h>
+#include <builtinFonts/ubuntu_10_regular.h>
+#include <miniz.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Host benchmark for compressed font bitmaps: deflates built-in fonts into blocks the way fontconvert.py --compress
+// does, then fetches every glyph of a run of book pages through EpdFont's glyph cache. Reports flash saved, cache hit
+// rate and the per-page cost of inflating against reading the uncompressed bitmaps.
+//
+// Text defaults to words drawn by frequency from the books behind the hyphenation test data (English, French,
+// German, Russian). --text FILE pages through a plain UTF-8 file instead.
+
+namespace {
+
+constexpr int kWordsPerPage = 105;  // A 14pt page, see text_run_bench
+constexpr int kPages = 200;
+constexpr size_t kDefaultBlockSize = 2048;
+
+using Clock = std::chrono::steady_clock;
+
+struct Corpus {
+  std::string name;
+  std::vector<std::string> pages;
+};
+
+// Compressed copy of a built-in font, laid out like fontconvert.py --compress output
+struct CompressedFont {
+  std::vector<uint8_t> bitmap;
+  std::vector<EpdGlyph> glyphs;
+  std::vector<EpdGlyphGroup> groups;
+  EpdFontData data;
+};
+
+uint32_t glyphCount(const EpdFontData& data) {
+  const EpdUnicodeInterval& last = data.intervals[data.intervalCount - 1];
+  return last.offset + (last.last - last.first + 1);
+}
+
+void deflateBlock(CompressedFont* font, const std::vector<uint8_t>& block, const uint32_t firstGlyph) {
+  const int flags = static_cast<int>(tdefl_create_comp_flags_from_zip_params(9, -15, MZ_DEFAULT_STRATEGY));
+  std::vector<uint8_t> out(block.size() + 128);
+  const size_t size = tdefl_compress_mem_to_mem(out.data(), out.size(), block.data(), block.size(), flags);
+  font->groups.push_back({static_cast<uint32_t>(font->bitmap.size()), static_cast<uint32_t>(size),
+                          static_cast<uint32_t>(block.size()), firstGlyph});
+  font->bitmap.insert(font->bitmap.end(), out.begin(), out.begin() + size);
+}
+
+void compressFont(const EpdFontData& source, const size_t blockSize, CompressedFont* font) {
+  const uint32_t count = glyphCount(source);
+  std::vector<uint8_t> block;
+  uint32_t firstGlyph = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    EpdGlyph glyph = source.glyph[i];
+    if (!block.empty() && block.size() + glyph.dataLength > blockSize) {
+      deflateBlock(font, block, firstGlyph);
+      block.clear();
+      firstGlyph = i;
+    }
+    const uint8_t* bitmap = &source.bitmap[glyph.dataOffset];
+    glyph.dataOffset = static_cast<uint32_t>(block.size());
+    block.insert(block.end(), bitmap, bitmap + glyph.dataLength);
+    font->glyphs.push_back(glyph);
+  }
+  if (!block.empty() || font->groups.empty()) {
+    deflateBlock(font, block, firstGlyph);
+  }
+
+  font->data = source;
+  font->data.bitmap = font->bitmap.data();
+  font->data.glyph = font->glyphs.data();
+  font->data.groups = font->groups.data();
+  font->data.groupCount = static_cast<uint32_t>(font->groups.size());
+}
+
+size_t uncompressedBitmapSize(const EpdFontData& data) {
+  const uint32_t count = glyphCount(data);
+  size_t size = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    size = std::max<size_t>(size, data.glyph[i].dataOffset + data.glyph[i].dataLength);
+  }
+  return size;
+}
+
+// Hyphenation test data lines are "word|hyphenated|frequency"
+Corpus wordListCorpus(const std::string& name, const std::string& path) {
+  Corpus corpus{name, {}};
+  std::ifstream in(path);
+  std::vector<std::string> words;
+  std::vector<uint64_t> cumulative;
+  uint64_t total = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const size_t first = line.find('|');
+    const size_t second = line.rfind('|');
+    if (first == std::string::npos || second == first) {
+      continue;
+    }
+    total += std::stoul(line.substr(second + 1));
+    words.push_back(line.substr(0, first));
+    cumulative.push_back(total);
+  }
+  if (words.empty()) {
+    return corpus;
+  }
+
+  // Deterministic frequency weighted draw so runs are comparable
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (int page = 0; page < kPages; page++) {
+    std::string text;
+    for (int w = 0; w < kWordsPerPage; w++) {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      const uint64_t pick = (state >> 33) % total;
+      const size_t index = std::upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin();
+      text += words[index];
+      text += ' ';
+    }
+    corpus.pages.push_back(std::move(text));
+  }
+  return corpus;
+}
+
+Corpus textFileCorpus(const std::string& path) {
+  Corpus corpus{path, {}};
+  std::ifstream in(path);
+  std::string word;
+  std::string text;
+  int words = 0;
+  while (in >> word) {
+    text += word;
+    text += ' ';
+    if (++words == kWordsPerPage) {
+      corpus.pages.push_back(std::move(text));
+      text.clear();
+      words = 0;
+    }
+  }
+  if (!text.empty()) {
+    corpus.pages.push_back(std::move(text));
+  }
+  return corpus;
+}
+
+// Fetches every glyph bitmap of the page, returns a checksum so the work is not optimized away
+uint32_t fetchPage(const EpdFont& font, const std::string& page) {
+  uint32_t checksum = 0;
+  const auto* text = reinterpret_cast<const unsigned char*>(page.c_str());
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(&text))) {
+    const EpdGlyph* glyph = font.getGlyph(cp);
+    if (!glyph) {
+      glyph = font.getGlyph(REPLACEMENT_GLYPH);
+    }
+    if (!glyph || glyph->dataLength == 0) {
+      continue;
+    }
+    const uint8_t* bitmap = font.getGlyphBitmap(glyph);
+    if (!bitmap) {
+      return 0;
+    }
+    checksum = checksum * 31 + bitmap[0] + bitmap[glyph->dataLength - 1];
+  }
+  return checksum;
+}
+
+double runPages(const EpdFont& font, const Corpus& corpus, uint32_t* checksum) {
+  *checksum = 0;
+  const auto start = Clock::now();
+  for (const auto& page : corpus.pages) {
+    *checksum ^= fetchPage(font, page);
+  }
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+bool benchmarkFont(const char* name, const EpdFontData& source, const size_t blockSize,
+                   const std::vector<Corpus>& corpora) {
+  CompressedFont compressed;
+  compressFont(source, blockSize, &compressed);
+  const size_t plainSize = uncompressedBitmapSize(source);
+  printf("%s (%s): bitmaps %zu bytes, compressed %zu bytes in %zu blocks (%.1f%%)\n", name,
+         source.is2Bit ? "2-bit" : "1-bit", plainSize, compressed.bitmap.size(), compressed.groups.size(),
+         100.0 * static_cast<double>(compressed.bitmap.size()) / static_cast<double>(plainSize));
+
+  bool ok = true;
+  for (const auto& corpus : corpora) {
+    if (corpus.pages.empty()) {
+      continue;
+    }
+    const EpdFont plainFont(&source);
+    const EpdFont compressedFont(&compressed.data);
+    uint32_t plainChecksum, compressedChecksum;
+    const double plainUs = runPages(plainFont, corpus, &plainChecksum);
+    const double compressedUs = runPages(compressedFont, corpus, &compressedChecksum);
+    const EpdGlyphCache* cache = compressedFont.getGlyphCache();
+    if (!cache || plainChecksum != compressedChecksum) {
+      printf("  %-10s MISMATCH: compressed glyphs differ from the uncompressed font\n", corpus.name.c_str());
+      ok = false;
+      continue;
+    }
+
+    const double pages = static_cast<double>(corpus.pages.size());
+    const double lookups = cache->hits + cache->misses;
+    printf("  %-10s %4zu pages  hit rate %5.1f%%  %6.2f inflates/page  %7.1f us/page (uncompressed %5.1f us/page)\n",
+           corpus.name.c_str(), corpus.pages.size(), 100.0 * cache->hits / lookups, cache->blockInflates / pages,
+           compressedUs / pages, plainUs / pages);
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string resources = "test/hyphenation_eval/resources";
+  std::string textPath;
+  size_t blockSize = kDefaultBlockSize;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--text" && i + 1 < argc) {
+      textPath = argv[++i];
+    } else if (arg == "--resources" && i + 1 < argc) {
+      resources = argv[++i];
+    } else if (arg == "--block-size" && i + 1 < argc) {
+      blockSize = std::stoul(argv[++i]);
+    } else {
+      fprintf(stderr, "Usage: FontCacheBenchmark [--text FILE] [--resources DIR] [--block-size BYTES]\n");
+      return 2;
+    }
+  }
+
+  std::vector<Corpus> corpora;
+  if (!textPath.empty()) {
+    corpora.push_back(textFileCorpus(textPath));
+  } else {
+    for (const char* language : {"english", "french", "german", "russian"}) {
+      corpora.push_back(wordListCorpus(language, resources + "/" + language + "_hyphenation_tests.txt"));
+    }
+  }
+
+  printf("glyph cache budget %zu bytes, block size %zu bytes, %d words per page\n", EpdFont::GLYPH_CACHE_BYTES,
+         blockSize, kWordsPerPage);
+  bool ok = true;
+  ok &= benchmarkFont("bookerly_14_regular", bookerly_14_regular, blockSize, corpora);
+  ok &= benchmarkFont("notosans_14_regular", notosans_14_regular, blockSize, corpora);
+  ok &= benchmarkFont("ubuntu_10_regular", ubuntu_10_regular, blockSize, corpora);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,246 @@
+#include <EpdFont.h>
+#include <Utf8.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/ubuntu_10_regular.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lib/GfxRenderer/GlyphAtlas.h"
+#include "lib/GfxRenderer/GlyphBlitter.h"
+
+// Host benchmark for GlyphBlitter and GlyphAtlas: lays out a page of text, checks the specialized blitters and the
+// pre-rotated atlas produce exactly the same framebuffer as the previous per-pixel drawPixel path, and reports glyphs
+// per second for each orientation. The atlas is timed warm, the way pages after the first one are drawn.
+
+namespace {
+
+constexpr int kBufferSize = GlyphBlitter::PANEL_WIDTH_BYTES * GlyphBlitter::PANEL_HEIGHT;
+constexpr int kIterations = 200;
+
+const char* kSampleText =
+    "It is a truth universally acknowledged, that a single man in possession of a good fortune, must be in want of a "
+    "wife. However little known the feelings or views of such a man may be on his first entering a neighbourhood, "
+    "this truth is so well fixed in the minds of the surrounding families, that he is considered the rightful "
+    "property of some one or other of their daughters. \"My dear Mr. Bennet,\" said his lady to him one day, \"have "
+    "you heard that Netherfield Park is let at last?\" Mr. Bennet replied that he had not. ";
+
+struct Placement {
+  const EpdGlyph* glyph;
+  int x;
+  int y;
+};
+
+struct OrientationCase {
+  const char* name;
+  GlyphBlitter::Mapping mapping;
+  int screenWidth;
+  int screenHeight;
+};
+
+const OrientationCase kOrientations[] = {
+    {"portrait", GlyphBlitter::PORTRAIT, 480, 800},
+    {"landscape-cw", GlyphBlitter::LANDSCAPE_CW, 800, 480},
+    {"portrait-inverted", GlyphBlitter::PORTRAIT_INVERTED, 480, 800},
+    {"landscape-ccw", GlyphBlitter::LANDSCAPE_CCW, 800, 480},
+};
+
+std::vector<Placement> layoutPage(const EpdFont& font, const int screenWidth, const int screenHeight) {
+  std::vector<Placement> placements;
+  constexpr int margin = 12;
+  const EpdFontData* data = font.data;
+  int x = margin;
+  int baseline = margin + data->ascender;
+
+  while (baseline - data->descender < screenHeight - margin) {
+    const auto* text = reinterpret_cast<const unsigned char*>(kSampleText);
+    uint32_t cp;
+    while ((cp = utf8NextCodepoint(&text))) {
+      const EpdGlyph* glyph = font.getGlyph(cp);
+      if (!glyph) {
+        continue;
+      }
+      if (x + glyph->advanceX > screenWidth - margin) {
+        x = margin;
+        baseline += data->advanceY;
+        if (baseline - data->descender >= screenHeight - margin) {
+          return placements;
+        }
+      }
+      placements.push_back({glyph, x + glyph->left, baseline - glyph->top});
+      x += glyph->advanceX;
+    }
+  }
+  return placements;
+}
+
+// The per-pixel path GfxRenderer used before the specialized blitters
+void referencePixel(uint8_t* frameBuffer, const GlyphBlitter::Mapping mapping, const int x, const int y,
+                    const bool state) {
+  int rotatedX = 0;
+  int rotatedY = 0;
+  switch (mapping) {
+    case GlyphBlitter::PORTRAIT:
+      rotatedX = y;
+      rotatedY = GlyphBlitter::PANEL_HEIGHT - 1 - x;
+      break;
+    case GlyphBlitter::LANDSCAPE_CW:
+      rotatedX = GlyphBlitter::PANEL_WIDTH - 1 - x;
+      rotatedY = GlyphBlitter::PANEL_HEIGHT - 1 - y;
+      break;
+    case GlyphBlitter::PORTRAIT_INVERTED:
+      rotatedX = GlyphBlitter::PANEL_WIDTH - 1 - y;
+      rotatedY = x;
+      break;
+    case GlyphBlitter::LANDSCAPE_CCW:
+      rotatedX = x;
+      rotatedY = y;
+      break;
+  }
+  if (rotatedX < 0 || rotatedX >= GlyphBlitter::PANEL_WIDTH || rotatedY < 0 ||
+      rotatedY >= GlyphBlitter::PANEL_HEIGHT) {
+    return;
+  }
+  const int byteIndex = rotatedY * GlyphBlitter::PANEL_WIDTH_BYTES + (rotatedX / 8);
+  const uint8_t bitPosition = 7 - (rotatedX % 8);
+  if (state) {
+    frameBuffer[byteIndex] &= ~(1 << bitPosition);
+  } else {
+    frameBuffer[byteIndex] |= 1 << bitPosition;
+  }
+}
+
+void referenceGlyph(uint8_t* frameBuffer, const GlyphBlitter::Mapping mapping, const GlyphBlitter::Plane plane,
+                    const EpdFontData* data, const Placement& placement) {
+  const EpdGlyph* glyph = placement.glyph;
+  const uint8_t* bitmap = &data->bitmap[glyph->dataOffset];
+  for (int glyphY = 0; glyphY < glyph->height; glyphY++) {
+    for (int glyphX = 0; glyphX < glyph->width; glyphX++) {
+      const int pixelPosition = glyphY * glyph->width + glyphX;
+      const int screenX = placement.x + glyphX;
+      const int screenY = placement.y + glyphY;
+      if (data->is2Bit) {
+        const uint8_t byte = bitmap[pixelPosition / 4];
+        const uint8_t bitIndex = (3 - pixelPosition % 4) * 2;
+        const uint8_t bmpVal = (3 - (byte >> bitIndex)) & 0x3;
+        if (plane == GlyphBlitter::PLANE_BW && bmpVal < 3) {
+          referencePixel(frameBuffer, mapping, screenX, screenY, true);
+        } else if (plane == GlyphBlitter::PLANE_GRAY_MSB && (bmpVal == 1 || bmpVal == 2)) {
+          referencePixel(frameBuffer, mapping, screenX, screenY, false);
+        } else if (plane == GlyphBlitter::PLANE_GRAY_LSB && bmpVal == 1) {
+          referencePixel(frameBuffer, mapping, screenX, screenY, false);
+        }
+      } else {
+        const uint8_t byte = bitmap[pixelPosition / 8];
+        if ((byte >> (7 - (pixelPosition % 8))) & 1) {
+          referencePixel(frameBuffer, mapping, screenX, screenY, true);
+        }
+      }
+    }
+  }
+}
+
+template <typename Fn>
+double timeIterations(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; i++) {
+    fn();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+bool runFont(const char* fontName, const EpdFontData* data) {
+  const EpdFont font(data);
+  bool ok = true;
+  std::vector<uint8_t> reference(kBufferSize);
+  std::vector<uint8_t> blitted(kBufferSize);
+  std::vector<uint8_t> atlased(kBufferSize);
+  GlyphAtlas atlas;
+
+  const GlyphBlitter::Plane planes[] = {GlyphBlitter::PLANE_BW, GlyphBlitter::PLANE_GRAY_LSB,
+                                        GlyphBlitter::PLANE_GRAY_MSB};
+  const char* planeNames[] = {"bw", "lsb", "msb"};
+
+  for (const auto& orientation : kOrientations) {
+    // Shift the page a little past the edges so clipping is exercised as well
+    auto placements = layoutPage(font, orientation.screenWidth, orientation.screenHeight);
+    for (auto& placement : placements) {
+      placement.x -= 6;
+      placement.y -= 6;
+    }
+
+    for (int p = 0; p < 3; p++) {
+      const GlyphBlitter::Plane plane = planes[p];
+      const uint8_t clearValue = plane == GlyphBlitter::PLANE_BW ? 0xFF : 0x00;
+
+      const double referenceSeconds = timeIterations([&] {
+        memset(reference.data(), clearValue, kBufferSize);
+        for (const auto& placement : placements) {
+          referenceGlyph(reference.data(), orientation.mapping, plane, data, placement);
+        }
+      });
+
+      const double blitSeconds = timeIterations([&] {
+        memset(blitted.data(), clearValue, kBufferSize);
+        for (const auto& placement : placements) {
+          const EpdGlyph* glyph = placement.glyph;
+          GlyphBlitter::blitGlyph(blitted.data(), orientation.mapping, plane, data->is2Bit,
+                                  &data->bitmap[glyph->dataOffset], glyph->width, glyph->height, placement.x,
+                                  placement.y, true);
+        }
+      });
+
+      // Same fallback as GfxRenderer::drawGlyphBitmap for glyphs clipped by the panel edge
+      const GlyphBlitter::Plane atlasPlane = data->is2Bit ? plane : GlyphBlitter::PLANE_BW;
+      const double atlasSeconds = timeIterations([&] {
+        memset(atlased.data(), clearValue, kBufferSize);
+        for (const auto& placement : placements) {
+          const EpdGlyph* glyph = placement.glyph;
+          const uint8_t* bitmap = &data->bitmap[glyph->dataOffset];
+          if (glyph->width > 0 && glyph->height > 0 &&
+              GlyphAtlas::fitsPanel(orientation.mapping, glyph->width, glyph->height, placement.x, placement.y)) {
+            const GlyphAtlas::Entry* entry = atlas.find(data, glyph, orientation.mapping, atlasPlane);
+            if (!entry) {
+              entry = atlas.insert(data, glyph, orientation.mapping, atlasPlane, data->is2Bit, bitmap, glyph->width,
+                                   glyph->height);
+            }
+            if (entry) {
+              atlas.blit(atlased.data(), *entry, data->is2Bit, placement.x, placement.y, true);
+              continue;
+            }
+          }
+          GlyphBlitter::blitGlyph(atlased.data(), orientation.mapping, plane, data->is2Bit, bitmap, glyph->width,
+                                  glyph->height, placement.x, placement.y, true);
+        }
+      });
+
+      const bool match = reference == blitted && reference == atlased;
+      ok = ok && match;
+
+      const double glyphs = static_cast<double>(placements.size()) * kIterations;
+      std::cout << fontName << " " << orientation.name << " " << planeNames[p] << ": " << placements.size()
+                << " glyphs/page, per-pixel " << static_cast<long>(glyphs / referenceSeconds) << " glyphs/s, blitter "
+                << static_cast<long>(glyphs / blitSeconds) << " glyphs/s (" << referenceSeconds / blitSeconds
+                << "x), atlas " << static_cast<long>(glyphs / atlasSeconds) << " glyphs/s ("
+                << referenceSeconds / atlasSeconds << "x)" << (match ? "" : "  MISMATCH") << std::endl;
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  bool ok = runFont("bookerly_14_regular (2-bit)", &bookerly_14_regular);
+  ok = runFont("ubuntu_10_regular (1-bit)", &ubuntu_10_regular) && ok;
+
+  if (!ok) {
+    std::cerr << "Blitter or atlas output differs from the per-pixel reference" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,563 @@
+#include <EInkDisplay.h>
+#include <EpdFontFamily.h>
+#include <Epub.h>
+#include <Epub/Page.h>
+#include <Epub/Section.h>
+#include <GfxRenderer.h>
+#include <SDCardManager.h>
+#include <Txt.h>
+#include <Xtc.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <miniz.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Headless renderer: lays out EPUB, TXT and XTC pages with the firmware's own reader code and writes the frames the
+// panel would show to PGM or PNG files, together with the time spent in the BW and grayscale passes of every page.
+//
+// The panel is the host EInkDisplay stand-in, which keeps an 8-bit image of what each display call leaves on screen.
+// Frames are written in logical orientation.
+//
+// Firmware logs go to stderr, results to stdout.
+//
+// With --golden FILE every frame is hashed and compared against FILE (one "<frame> <hash>" line per frame), so layout
+// or rasterizer changes show up as a regression. --update rewrites FILE from the current output.
+
+namespace {
+
+constexpr int kReaderFontId = 1;
+// Synthesized styles lay out differently, a separate id keeps their section caches apart
+constexpr int kSynthesizedReaderFontId = 2;
+int readerFontId = kReaderFontId;
+// CrossPointSettings defaults
+constexpr int kScreenMargin = 5;
+constexpr int kStatusBarMargin = 19;
+constexpr float kLineCompression = 1.0f;
+constexpr bool kExtraParagraphSpacing = true;
+constexpr uint8_t kParagraphAlignment = 0;  // Justified
+
+struct Options {
+  std::string bookPath;
+  std::string outDir = "build/host_render/frames";
+  std::string goldenPath;
+  int maxPages = 3;
+  GfxRenderer::Orientation orientation = GfxRenderer::Portrait;
+  bool png = false;
+  bool antiAliasing = true;
+  bool update = false;
+  bool synthesizeStyles = false;
+};
+
+struct FrameTiming {
+  double bwMs = 0;
+  double grayMs = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(const Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint64_t fnv1a(const uint8_t* data, const size_t size) {
+  uint64_t hash = 1469598103934665603ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+class FrameWriter {
+ public:
+  FrameWriter(const Options& options, const EInkDisplay& display, const GfxRenderer& renderer)
+      : options(options), display(display), renderer(renderer) {}
+
+  // Converts the shown panel image to logical orientation, writes it and records its hash
+  bool write(const std::string& name, const FrameTiming& timing) {
+    const int width = renderer.getScreenWidth();
+    const int height = renderer.getScreenHeight();
+    std::vector<uint8_t> image(static_cast<size_t>(width) * height);
+    const uint8_t* shown = display.getShownFrame();
+
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        int panelX, panelY;
+        switch (renderer.getOrientation()) {
+          case GfxRenderer::Portrait:
+            panelX = y;
+            panelY = EInkDisplay::DISPLAY_HEIGHT - 1 - x;
+            break;
+          case GfxRenderer::LandscapeClockwise:
+            panelX = EInkDisplay::DISPLAY_WIDTH - 1 - x;
+            panelY = EInkDisplay::DISPLAY_HEIGHT - 1 - y;
+            break;
+          case GfxRenderer::PortraitInverted:
+            panelX = EInkDisplay::DISPLAY_WIDTH - 1 - y;
+            panelY = x;
+            break;
+          case GfxRenderer::LandscapeCounterClockwise:
+          default:
+            panelX = x;
+            panelY = y;
+            break;
+        }
+        image[static_cast<size_t>(y) * width + x] = shown[panelY * EInkDisplay::DISPLAY_WIDTH + panelX];
+      }
+    }
+
+    hashes[name] = fnv1a(image.data(), image.size());
+    printf("%-24s bw %7.2f ms  gray %7.2f ms  %016llx\n", name.c_str(), timing.bwMs, timing.grayMs,
+           static_cast<unsigned long long>(hashes[name]));
+    totalBwMs += timing.bwMs;
+    totalGrayMs += timing.grayMs;
+
+    const std::string path = options.outDir + "/" + name + (options.png ? ".png" : ".pgm");
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+      fprintf(stderr, "Could not write %s\n", path.c_str());
+      return false;
+    }
+    if (options.png) {
+      size_t pngSize = 0;
+      void* png = tdefl_write_image_to_png_file_in_memory(image.data(), width, height, 1, &pngSize);
+      if (!png) {
+        fprintf(stderr, "PNG encoding failed for %s\n", path.c_str());
+        return false;
+      }
+      out.write(static_cast<const char*>(png), static_cast<std::streamsize>(pngSize));
+      mz_free(png);
+    } else {
+      out << "P5\n" << width << " " << height << "\n255\n";
+      out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+    return true;
+  }
+
+  size_t frameCount() const { return hashes.size(); }
+  double averageBwMs() const { return hashes.empty() ? 0 : totalBwMs / hashes.size(); }
+  double averageGrayMs() const { return hashes.empty() ? 0 : totalGrayMs / hashes.size(); }
+
+  // Compares the frames of the book rendered in this run. Returns false on any mismatch, or if the golden file cannot
+  // be read
+  bool checkGolden(const std::string& path) const {
+    std::ifstream in(path);
+    if (!in) {
+      fprintf(stderr, "Could not read golden file %s (run with --update to create it)\n", path.c_str());
+      return false;
+    }
+
+    std::map<std::string, uint64_t> expected;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream fields(line);
+      std::string name, hash;
+      if (fields >> name >> hash && name.rfind(prefix, 0) == 0) {
+        expected[name] = std::stoull(hash, nullptr, 16);
+      }
+    }
+
+    bool ok = true;
+    for (const auto& [name, hash] : hashes) {
+      const auto it = expected.find(name);
+      if (it == expected.end()) {
+        printf("MISSING  %s has no golden hash\n", name.c_str());
+        ok = false;
+      } else if (it->second != hash) {
+        printf("MISMATCH %s: expected %016llx, got %016llx\n", name.c_str(),
+                static_cast<unsigned long long>(it->second), static_cast<unsigned long long>(hash));
+        ok = false;
+      }
+    }
+    for (const auto& [name, hash] : expected) {
+      if (!hashes.count(name)) {
+        printf("MISSING  %s was not rendered\n", name.c_str());
+        ok = false;
+      }
+    }
+    return ok;
+  }
+
+  // Replaces this book's hashes in the golden file, keeping the entries of other books
+  bool updateGolden(const std::string& path) const {
+    std::map<std::string, std::string> lines;
+    std::ifstream in(path);
+    std::string line;
+    while (in && std::getline(in, line)) {
+      if (line.empty() || line[0] == '#' || line.rfind(prefix, 0) == 0) continue;
+      lines[line.substr(0, line.find(' '))] = line;
+    }
+    in.close();
+
+    for (const auto& [name, hash] : hashes) {
+      char hex[17];
+      snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+      lines[name] = name + " " + hex;
+    }
+
+    std::ofstream out(path);
+    if (!out) {
+      fprintf(stderr, "Could not write golden file %s\n", path.c_str());
+      return false;
+    }
+    out << "# Frame hashes written by test/run_host_render.sh --update\n";
+    for (const auto& [name, entry] : lines) {
+      out << entry << "\n";
+    }
+    return true;
+  }
+
+  // Frame name prefix of the book being rendered
+  std::string prefix;
+
+ private:
+  const Options& options;
+  const EInkDisplay& display;
+  const GfxRenderer& renderer;
+  std::map<std::string, uint64_t> hashes;
+  double totalBwMs = 0;
+  double totalGrayMs = 0;
+};
+
+std::string frameName(const std::string& stem, const int page) {
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), "_p%03d", page);
+  return stem + suffix;
+}
+
+// BW pass straight to the panel, then the two grayscale planes - same sequence as the reader activities
+template <typename DrawFn>
+FrameTiming displayPage(GfxRenderer& renderer, const bool antiAliasing, DrawFn&& draw) {
+  FrameTiming timing;
+
+  auto start = Clock::now();
+  renderer.setRenderMode(GfxRenderer::BW);
+  renderer.clearScreen();
+  draw();
+  renderer.displayBuffer();
+  timing.bwMs = elapsedMs(start);
+
+  if (antiAliasing) {
+    start = Clock::now();
+    renderer.clearScreen(0x00);
+    renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
+    draw();
+    renderer.copyGrayscaleLsbBuffers();
+
+    renderer.clearScreen(0x00);
+    renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
+    draw();
+    renderer.copyGrayscaleMsbBuffers();
+
+    renderer.displayGrayBuffer();
+    renderer.setRenderMode(GfxRenderer::BW);
+    timing.grayMs = elapsedMs(start);
+  }
+  return timing;
+}
+
+void getContentMargins(const GfxRenderer& renderer, int* top, int* right, int* bottom, int* left) {
+  renderer.getOrientedViewableTRBL(top, right, bottom, left);
+  *top += kScreenMargin;
+  *left += kScreenMargin;
+  *right += kScreenMargin;
+  *bottom += kStatusBarMargin;
+}
+
+bool renderEpub(const Options& options, GfxRenderer& renderer, FrameWriter& writer, const std::string& sdPath,
+                const std::string& stem) {
+  auto epub = std::make_shared<Epub>(sdPath, "/.crosspoint");
+  if (!epub->load()) {
+    fprintf(stderr, "Failed to load EPUB %s\n", sdPath.c_str());
+    return false;
+  }
+
+  int marginTop, marginRight, marginBottom, marginLeft;
+  getContentMargins(renderer, &marginTop, &marginRight, &marginBottom, &marginLeft);
+  const uint16_t viewportWidth = renderer.getScreenWidth() - marginLeft - marginRight;
+  const uint16_t viewportHeight = renderer.getScreenHeight() - marginTop - marginBottom;
+
+  int rendered = 0;
+  for (int spineIndex = 0; spineIndex < epub->getSpineItemsCount() && rendered < options.maxPages; spineIndex++) {
+    Section section(epub, spineIndex, renderer);
+    if (!section.loadSectionFile(readerFontId, kLineCompression, kExtraParagraphSpacing, kParagraphAlignment,
+                                 viewportWidth, viewportHeight, false)) {
+      const auto start = Clock::now();
+      if (!section.createSectionFile(readerFontId, kLineCompression, kExtraParagraphSpacing, kParagraphAlignment,
+                                     viewportWidth, viewportHeight, false)) {
+        fprintf(stderr, "Failed to lay out spine item %d\n", spineIndex);
+        return false;
+      }
+      printf("laid out spine %d: %d pages in %.1f ms\n", spineIndex, section.pageCount, elapsedMs(start));
+    }
+
+    for (int pageIndex = 0; pageIndex < section.pageCount && rendered < options.maxPages; pageIndex++) {
+      section.currentPage = pageIndex;
+      const auto page = section.loadPageFromSectionFile();
+      if (!page) {
+        fprintf(stderr, "Failed to load page %d of spine item %d\n", pageIndex, spineIndex);
+        return false;
+      }
+
+      const FrameTiming timing = displayPage(renderer, options.antiAliasing,
+                                             [&] { page->render(renderer, readerFontId, marginLeft, marginTop); });
+      if (!writer.write(frameName(stem, rendered), timing)) {
+        return false;
+      }
+      rendered++;
+    }
+  }
+  return true;
+}
+
+struct PlacedWord {
+  std::string text;
+  int x;
+  int y;
+};
+
+// Greedy word wrap of the start of the file. This approximates TxtReaderActivity's layout, it does not reproduce it.
+bool renderTxt(const Options& options, GfxRenderer& renderer, FrameWriter& writer, const std::string& sdPath,
+               const std::string& stem) {
+  Txt txt(sdPath, "/.crosspoint");
+  if (!txt.load()) {
+    fprintf(stderr, "Failed to load TXT %s\n", sdPath.c_str());
+    return false;
+  }
+
+  std::string text(txt.getFileSize(), '\0');
+  if (!text.empty() && !txt.readContent(reinterpret_cast<uint8_t*>(text.data()), 0, text.size())) {
+    fprintf(stderr, "Failed to read TXT %s\n", sdPath.c_str());
+    return false;
+  }
+
+  int marginTop, marginRight, marginBottom, marginLeft;
+  getContentMargins(renderer, &marginTop, &marginRight, &marginBottom, &marginLeft);
+  const int right = renderer.getScreenWidth() - marginRight;
+  const int bottom = renderer.getScreenHeight() - marginBottom;
+  const int lineHeight = renderer.getLineHeight(readerFontId);
+  const int spaceWidth = renderer.getSpaceWidth(readerFontId);
+
+  size_t pos = 0;
+  int rendered = 0;
+  while (pos < text.size() && rendered < options.maxPages) {
+    // Laid out once, drawn for every plane
+    std::vector<PlacedWord> words;
+    int x = marginLeft;
+    int y = marginTop;
+    while (pos < text.size() && y + lineHeight <= bottom) {
+      if (text[pos] == '\n') {
+        x = marginLeft;
+        y += lineHeight;
+        pos++;
+        continue;
+      }
+      if (text[pos] == ' ' || text[pos] == '\r' || text[pos] == '\t') {
+        pos++;
+        continue;
+      }
+
+      const size_t end = text.find_first_of(" \t\r\n", pos);
+      const std::string word = text.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+      const int wordWidth = renderer.getTextWidth(readerFontId, word.c_str());
+      if (x > marginLeft && x + wordWidth > right) {
+        x = marginLeft;
+        y += lineHeight;
+        if (y + lineHeight > bottom) break;
+      }
+      words.push_back({word, x, y});
+      x += wordWidth + spaceWidth;
+      pos += word.size();
+    }
+
+    const FrameTiming timing = displayPage(renderer, options.antiAliasing, [&] {
+      for (const auto& placed : words) {
+        renderer.drawText(readerFontId, placed.x, placed.y, placed.text.c_str());
+      }
+    });
+    if (!writer.write(frameName(stem, rendered), timing)) {
+      return false;
+    }
+    rendered++;
+  }
+  return true;
+}
+
+bool renderXtc(const Options& options, GfxRenderer& renderer, FrameWriter& writer, const std::string& sdPath,
+               const std::string& stem) {
+  Xtc xtc(sdPath, "/.crosspoint");
+  if (!xtc.load()) {
+    fprintf(stderr, "Failed to load XTC %s\n", sdPath.c_str());
+    return false;
+  }
+
+  const uint16_t pageWidth = xtc.getPageWidth();
+  const uint16_t pageHeight = xtc.getPageHeight();
+  const uint8_t bitDepth = xtc.getBitDepth();
+  const size_t pageBufferSize = bitDepth == 2 ? ((static_cast<size_t>(pageWidth) * pageHeight + 7) / 8) * 2
+                                              : ((pageWidth + 7) / 8) * static_cast<size_t>(pageHeight);
+  std::vector<uint8_t> pageBuffer(pageBufferSize);
+
+  for (uint32_t pageIndex = 0; pageIndex < xtc.getPageCount() && static_cast<int>(pageIndex) < options.maxPages;
+       pageIndex++) {
+    if (xtc.loadPage(pageIndex, pageBuffer.data(), pageBuffer.size()) == 0) {
+      fprintf(stderr, "Failed to load XTC page %u\n", pageIndex);
+      return false;
+    }
+    // 1-bit pages have no grayscale pass
+    const FrameTiming timing = displayPage(renderer, options.antiAliasing && bitDepth == 2, [&] {
+      xtc::drawPage(renderer, pageBuffer.data(), pageWidth, pageHeight, bitDepth);
+    });
+    if (!writer.write(frameName(stem, static_cast<int>(pageIndex)), timing)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool parseOrientation(const std::string& value, GfxRenderer::Orientation* orientation) {
+  if (value == "portrait") {
+    *orientation = GfxRenderer::Portrait;
+  } else if (value == "cw") {
+    *orientation = GfxRenderer::LandscapeClockwise;
+  } else if (value == "inverted") {
+    *orientation = GfxRenderer::PortraitInverted;
+  } else if (value == "ccw") {
+    *orientation = GfxRenderer::LandscapeCounterClockwise;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+void printUsage() {
+  fprintf(stderr,
+          "Usage: HostRender [options] <book.epub|book.txt|book.xtc|book.xtch>\n"
+          "  --out DIR          frame output directory (default build/host_render/frames)\n"
+          "  --pages N          number of pages to render (default 3)\n"
+          "  --orientation O    portrait, cw, inverted or ccw (default portrait)\n"
+          "  --png              write PNG instead of PGM\n"
+          "  --no-aa            skip the grayscale passes\n"
+          "  --synthesize-styles  derive bold and italic from the regular face\n"
+          "  --golden FILE      compare frame hashes against FILE\n"
+          "  --update           rewrite the golden hashes instead of comparing\n");
+}
+
+bool parseArgs(const int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--out" && hasValue) {
+      options->outDir = argv[++i];
+    } else if (arg == "--pages" && hasValue) {
+      options->maxPages = std::atoi(argv[++i]);
+    } else if (arg == "--orientation" && hasValue) {
+      if (!parseOrientation(argv[++i], &options->orientation)) return false;
+    } else if (arg == "--golden" && hasValue) {
+      options->goldenPath = argv[++i];
+    } else if (arg == "--png") {
+      options->png = true;
+    } else if (arg == "--no-aa") {
+      options->antiAliasing = false;
+    } else if (arg == "--synthesize-styles") {
+      options->synthesizeStyles = true;
+    } else if (arg == "--update") {
+      options->update = true;
+    } else if (!arg.empty() && arg[0] != '-' && options->bookPath.empty()) {
+      options->bookPath = arg;
+    } else {
+      return false;
+    }
+  }
+  return !options->bookPath.empty() && options->maxPages > 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseArgs(argc, argv, &options)) {
+    printUsage();
+    return 2;
+  }
+
+  // The book's directory plays the SD card root, caches land in its .crosspoint folder like on the device
+  const std::filesystem::path bookPath = std::filesystem::absolute(options.bookPath);
+  if (!std::filesystem::exists(bookPath)) {
+    fprintf(stderr, "No such file: %s\n", options.bookPath.c_str());
+    return 1;
+  }
+  SdMan.setRoot(bookPath.parent_path().string());
+  std::filesystem::create_directories(options.outDir);
+
+  EpdFont regularFont(&bookerly_14_regular);
+  EpdFont boldFont(&bookerly_14_bold);
+  EpdFont italicFont(&bookerly_14_italic);
+  EpdFont boldItalicFont(&bookerly_14_bolditalic);
+  EpdFont synthesizedBoldFont(&bookerly_14_regular, EpdFont::SYNTH_BOLD);
+  EpdFont synthesizedItalicFont(&bookerly_14_regular, EpdFont::SYNTH_ITALIC);
+  EpdFont synthesizedBoldItalicFont(&bookerly_14_regular, EpdFont::SYNTH_BOLD | EpdFont::SYNTH_ITALIC);
+  EpdFontFamily fontFamily(&regularFont, &boldFont, &italicFont, &boldItalicFont);
+  if (options.synthesizeStyles) {
+    fontFamily = EpdFontFamily(&regularFont, &synthesizedBoldFont, &synthesizedItalicFont, &synthesizedBoldItalicFont);
+    readerFontId = kSynthesizedReaderFontId;
+  }
+
+  EInkDisplay display;
+  GfxRenderer renderer(display);
+  renderer.insertFont(readerFontId, fontFamily);
+  renderer.setOrientation(options.orientation);
+
+  FrameWriter writer(options, display, renderer);
+  const std::string sdPath = "/" + bookPath.filename().string();
+  std::string extension = bookPath.extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  const std::string stem = bookPath.stem().string() + "_" + extension.substr(1);
+  writer.prefix = stem + "_p";
+
+  bool ok;
+  if (extension == ".epub") {
+    ok = renderEpub(options, renderer, writer, sdPath, stem);
+  } else if (extension == ".txt") {
+    ok = renderTxt(options, renderer, writer, sdPath, stem);
+  } else if (extension == ".xtc" || extension == ".xtch") {
+    ok = renderXtc(options, renderer, writer, sdPath, stem);
+  } else {
+    fprintf(stderr, "Unsupported book type: %s\n", extension.c_str());
+    return 1;
+  }
+  if (!ok) {
+    return 1;
+  }
+
+  printf("%zu frames, average bw %.2f ms, gray %.2f ms, written to %s\n", writer.frameCount(), writer.averageBwMs(),
+         writer.averageGrayMs(), options.outDir.c_str());
+
+  if (options.goldenPath.empty()) {
+    return 0;
+  }
+  if (options.update) {
+    return writer.updateGolden(options.goldenPath) ? 0 : 1;
+  }
+  if (!writer.checkGolden(options.goldenPath)) {
+    printf("Golden image check FAILED for %s\n", options.bookPath.c_str());
+    return 1;
+  }
+  printf("Golden image check passed\n");
+  return 0;
+}
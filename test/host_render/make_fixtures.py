@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Writes the small books the host renderer's golden image check runs on.
+
+Usage: make_fixtures.py OUTPUT_DIR
+
+Creates sample.epub (two chapters with bold and italic runs), sample.txt, sample.xtc (1-bit pages) and sample.xtch
+(2-bit pages). Output is deterministic so the frame hashes in golden.txt stay stable.
+"""
+
+import os
+import struct
+import sys
+import zipfile
+
+PARAGRAPHS = [
+    "It is a truth universally acknowledged, that a single man in possession of a good fortune, must be in want of "
+    "a wife.",
+    "However little known the feelings or views of such a man may be on his first entering a neighbourhood, this "
+    "truth is so well fixed in the minds of the surrounding families, that he is considered the rightful property of "
+    "some one or other of their daughters.",
+    "“My dear Mr. Bennet,” said his lady to him one day, “have you heard that Netherfield Park is let "
+    "at last?”",
+    "Mr. Bennet replied that he had not.",
+    "“But it is,” returned she; “for Mrs. Long has just been here, and she told me all about it.”",
+    "Mr. Bennet made no answer.",
+]
+
+XTC_WIDTH = 480
+XTC_HEIGHT = 800
+
+
+def chapter_xhtml(title, paragraphs):
+    body = "\n".join(paragraphs)
+    return (
+        '<?xml version="1.0" encoding="utf-8"?>\n'
+        '<html xmlns="http://www.w3.org/1999/xhtml">\n'
+        f"<head><title>{title}</title></head>\n"
+        f"<body>\n<h1>{title}</h1>\n{body}\n</body>\n</html>\n"
+    )
+
+
+def write_epub(path):
+    first = [f"<p>{p}</p>" for p in PARAGRAPHS * 3]
+    first[1] = "<p><b>Bold run</b> followed by <i>an italic run</i> and <b><i>both at once</i></b>.</p>"
+    second = [f"<p>{p}</p>" for p in reversed(PARAGRAPHS * 2)]
+
+    files = {
+        "META-INF/container.xml": (
+            '<?xml version="1.0"?>\n'
+            '<container version="1.0" xmlns="urn:oasis:names:tc:opendocument:xmlns:container">\n'
+            '<rootfiles><rootfile full-path="OEBPS/content.opf" media-type="application/oebps-package+xml"/>'
+            "</rootfiles>\n</container>\n"
+        ),
+        "OEBPS/content.opf": (
+            '<?xml version="1.0" encoding="utf-8"?>\n'
+            '<package xmlns="http://www.idpf.org/2007/opf" version="2.0" unique-identifier="id">\n'
+            '<metadata xmlns:dc="http://purl.org/dc/elements/1.1/">\n'
+            "<dc:title>Host Render Sample</dc:title><dc:creator>CrossPoint</dc:creator>"
+            '<dc:language>en</dc:language><dc:identifier id="id">host-render-sample</dc:identifier>\n'
+            "</metadata>\n<manifest>\n"
+            '<item id="ncx" href="toc.ncx" media-type="application/x-dtbncx+xml"/>\n'
+            '<item id="ch1" href="chapter1.xhtml" media-type="application/xhtml+xml"/>\n'
+            '<item id="ch2" href="chapter2.xhtml" media-type="application/xhtml+xml"/>\n'
+            '</manifest>\n<spine toc="ncx"><itemref idref="ch1"/><itemref idref="ch2"/></spine>\n</package>\n'
+        ),
+        "OEBPS/toc.ncx": (
+            '<?xml version="1.0" encoding="utf-8"?>\n'
+            '<ncx xmlns="http://www.daisy.org/z3986/2005/ncx/" version="2005-1">\n<navMap>\n'
+            '<navPoint id="n1" playOrder="1"><navLabel><text>Chapter One</text></navLabel>'
+            '<content src="chapter1.xhtml"/></navPoint>\n'
+            '<navPoint id="n2" playOrder="2"><navLabel><text>Chapter Two</text></navLabel>'
+            '<content src="chapter2.xhtml"/></navPoint>\n'
+            "</navMap>\n</ncx>\n"
+        ),
+        "OEBPS/chapter1.xhtml": chapter_xhtml("Chapter One", first),
+        "OEBPS/chapter2.xhtml": chapter_xhtml("Chapter Two", second),
+    }
+
+    with zipfile.ZipFile(path, "w") as archive:
+        # mimetype has to be the first entry and stored uncompressed
+        info = zipfile.ZipInfo("mimetype", date_time=(2020, 1, 1, 0, 0, 0))
+        archive.writestr(info, "application/epub+zip", compress_type=zipfile.ZIP_STORED)
+        for name, content in files.items():
+            info = zipfile.ZipInfo(name, date_time=(2020, 1, 1, 0, 0, 0))
+            archive.writestr(info, content.encode("utf-8"), compress_type=zipfile.ZIP_DEFLATED)
+
+
+def write_txt(path):
+    with open(path, "w", encoding="utf-8", newline="\n") as out:
+        out.write("\n\n".join(PARAGRAPHS * 4) + "\n")
+
+
+def page_value(page, x, y):
+    """XTH gray level for a test pattern: 0 white, 1 dark grey, 2 light grey, 3 black."""
+    # Frame, gray bars and a diagonal so orientation mistakes are visible
+    if x < 8 or y < 8 or x >= XTC_WIDTH - 8 or y >= XTC_HEIGHT - 8:
+        return 3
+    if abs(x - y * XTC_WIDTH // XTC_HEIGHT) < 3:
+        return 3
+    band = (y // 100 + page) % 4
+    if 40 <= x < 440 and y % 100 < 60:
+        return (0, 2, 1, 3)[band]
+    return 0
+
+
+def xtg_page(page):
+    row_bytes = (XTC_WIDTH + 7) // 8
+    data = bytearray(b"\xff" * (row_bytes * XTC_HEIGHT))
+    for y in range(XTC_HEIGHT):
+        for x in range(XTC_WIDTH):
+            # 1-bit: anything darker than light grey is black, 0 bit = black
+            if page_value(page, x, y) in (1, 3):
+                data[y * row_bytes + x // 8] &= ~(0x80 >> (x % 8)) & 0xFF
+    return struct.pack("<IHHBBIQ", 0x00475458, XTC_WIDTH, XTC_HEIGHT, 0, 0, len(data), 0) + bytes(data)
+
+
+def xth_page(page):
+    col_bytes = (XTC_HEIGHT + 7) // 8
+    plane_size = (XTC_WIDTH * XTC_HEIGHT + 7) // 8
+    plane1 = bytearray(plane_size)
+    plane2 = bytearray(plane_size)
+    for x in range(XTC_WIDTH):
+        # Columns are stored right to left, 8 vertical pixels per byte
+        column = (XTC_WIDTH - 1 - x) * col_bytes
+        for y in range(XTC_HEIGHT):
+            value = page_value(page, x, y)
+            bit = 0x80 >> (y % 8)
+            if value & 2:
+                plane1[column + y // 8] |= bit
+            if value & 1:
+                plane2[column + y // 8] |= bit
+    data = bytes(plane1) + bytes(plane2)
+    return struct.pack("<IHHBBIQ", 0x00485458, XTC_WIDTH, XTC_HEIGHT, 0, 0, len(data), 0) + data
+
+
+def write_xtc(path, two_bit, page_count=2):
+    header_size = 56
+    title = b"Host Render Sample\0"
+    title_offset = header_size
+    page_table_offset = title_offset + 128
+    data_offset = page_table_offset + 16 * page_count
+
+    pages = [(xth_page if two_bit else xtg_page)(page) for page in range(page_count)]
+    table = b""
+    offset = data_offset
+    for page in pages:
+        table += struct.pack("<QIHH", offset, len(page), XTC_WIDTH, XTC_HEIGHT)
+        offset += len(page)
+
+    magic = 0x48435458 if two_bit else 0x00435458
+    header = struct.pack(
+        "<IBBHIIIIQQQII", magic, 1, 0, page_count, 0, header_size, 0, 0, page_table_offset, data_offset, 0,
+        title_offset, 0
+    )
+    with open(path, "wb") as out:
+        out.write(header)
+        out.write(title.ljust(128, b"\0"))
+        out.write(table)
+        for page in pages:
+            out.write(page)
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 2
+    out_dir = sys.argv[1]
+    os.makedirs(out_dir, exist_ok=True)
+    write_epub(os.path.join(out_dir, "sample.epub"))
+    write_txt(os.path.join(out_dir, "sample.txt"))
+    write_xtc(os.path.join(out_dir, "sample.xtc"), two_bit=False)
+    write_xtc(os.path.join(out_dir, "sample.xtch"), two_bit=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
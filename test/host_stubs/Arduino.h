@@ -0,0 +1,41 @@
+#pragma once
+
+// Minimal Arduino surface for building firmware libraries into host tools and benchmarks.
+// Like the Arduino core it is included ahead of every source file (-include), pulling in the usual C headers.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using std::max;
+using std::min;
+
+inline unsigned long millis() {
+  static const auto start = std::chrono::steady_clock::now();
+  return static_cast<unsigned long>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+inline void delay(const unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// Log output goes to stderr so tools can keep stdout for their own results
+class HardwareSerial {
+ public:
+  int printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const int written = vfprintf(stderr, format, args);
+    va_end(args);
+    return written;
+  }
+  void println(const char* text) { fprintf(stderr, "%s\n", text); }
+};
+
+inline HardwareSerial Serial;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host stand-in for the panel driver: owns a framebuffer and counts refreshes instead of driving hardware.
+// Every display call also updates an 8-bit panel space image of what the screen would show, so host tools can dump
+// frames to disk.
+class EInkDisplay {
+ public:
+  enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  // Gray levels shown for the two grayscale overlay states
+  static constexpr uint8_t DARK_GRAY = 85;
+  static constexpr uint8_t LIGHT_GRAY = 170;
+
+  EInkDisplay() {
+    clearScreen();
+    memset(shownFrame, 0xFF, sizeof(shownFrame));
+  }
+
+  uint8_t* getFrameBuffer() const { return const_cast<uint8_t*>(frameBuffer); }
+  void clearScreen(const uint8_t color = 0xFF) const { memset(const_cast<uint8_t*>(frameBuffer), color, BUFFER_SIZE); }
+
+  void displayBuffer(RefreshMode = FAST_REFRESH) {
+    showBw(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    refreshCount++;
+  }
+
+  void displayWindow(const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h) {
+    showBw(x, y, x + w, y + h);
+    windowCount++;
+  }
+
+  void drawImage(const uint8_t*, uint16_t, uint16_t, uint16_t, uint16_t, bool = false) const {}
+  void copyGrayscaleLsbBuffers(const uint8_t* lsb) { memcpy(lsbPlane, lsb, BUFFER_SIZE); }
+  void copyGrayscaleMsbBuffers(const uint8_t* msb) { memcpy(msbPlane, msb, BUFFER_SIZE); }
+  void copyGrayscaleBuffers(const uint8_t* lsb, const uint8_t* msb) {
+    copyGrayscaleLsbBuffers(lsb);
+    copyGrayscaleMsbBuffers(msb);
+  }
+
+  // Overlays the grays on the BW image already on screen: both planes marked is dark gray, MSB only is light gray
+  void displayGrayBuffer(bool = false) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(DISPLAY_WIDTH) * DISPLAY_HEIGHT; i++) {
+      const uint8_t bit = 0x80 >> (i & 7);
+      if (!(msbPlane[i >> 3] & bit)) {
+        continue;
+      }
+      shownFrame[i] = (lsbPlane[i >> 3] & bit) ? DARK_GRAY : LIGHT_GRAY;
+    }
+    refreshCount++;
+  }
+
+  void cleanupGrayscaleBuffers(const uint8_t*) {}
+  void grayscaleRevert() {}
+
+  // Panel space image of the screen, one byte per pixel (0 black ... 255 white), row-major 800x480
+  const uint8_t* getShownFrame() const { return shownFrame; }
+
+  int refreshCount = 0;
+  int windowCount = 0;
+
+ private:
+  void showBw(const uint16_t x0, const uint16_t y0, const uint16_t x1, const uint16_t y1) {
+    for (uint16_t y = y0; y < y1 && y < DISPLAY_HEIGHT; y++) {
+      for (uint16_t x = x0; x < x1 && x < DISPLAY_WIDTH; x++) {
+        const bool white = frameBuffer[y * DISPLAY_WIDTH_BYTES + x / 8] & (0x80 >> (x & 7));
+        shownFrame[y * DISPLAY_WIDTH + x] = white ? 0xFF : 0x00;
+      }
+    }
+  }
+
+  uint8_t frameBuffer[BUFFER_SIZE];
+  uint8_t lsbPlane[BUFFER_SIZE] = {};
+  uint8_t msbPlane[BUFFER_SIZE] = {};
+  uint8_t shownFrame[DISPLAY_WIDTH * DISPLAY_HEIGHT];
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SdFat.h>
+
+#include <filesystem>
+#include <string>
+
+// SD card stand-in rooted at a host directory: card path "/books/a.epub" is <root>/books/a.epub
+class SDCardManager {
+ public:
+  void setRoot(const std::string& hostRoot) { root = hostRoot; }
+  std::string hostPath(const char* path) const { return root + (path[0] == '/' ? "" : "/") + path; }
+
+  bool exists(const char* path) const { return std::filesystem::exists(hostPath(path)); }
+  bool mkdir(const char* path, bool = true) const {
+    std::error_code error;
+    std::filesystem::create_directories(hostPath(path), error);
+    return !error;
+  }
+  bool remove(const char* path) const {
+    std::error_code error;
+    return std::filesystem::remove(hostPath(path), error);
+  }
+  bool removeDir(const char* path) const {
+    std::error_code error;
+    std::filesystem::remove_all(hostPath(path), error);
+    return !error;
+  }
+  bool rename(const char* from, const char* to) const {
+    std::error_code error;
+    std::filesystem::rename(hostPath(from), hostPath(to), error);
+    return !error;
+  }
+
+  bool openFileForRead(const char* moduleName, const std::string& path, FsFile& file) const {
+    if (!file.openHost(hostPath(path.c_str()).c_str(), "rb")) {
+      Serial.printf("[%lu] [%s] File does not exist: %s\n", millis(), moduleName, path.c_str());
+      return false;
+    }
+    return true;
+  }
+  bool openFileForWrite(const char* moduleName, const std::string& path, FsFile& file) const {
+    if (!file.openHost(hostPath(path.c_str()).c_str(), "w+b")) {
+      Serial.printf("[%lu] [%s] Failed to open file for writing: %s\n", millis(), moduleName, path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  std::string root = ".";
+};
+
+inline SDCardManager SdMan;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Print.h>
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <ctime>
+
+// FsFile over stdio. Files are opened by the SDCardManager stand-in, which maps card paths onto a host directory.
+class FsFile : public Print {
+ public:
+  FsFile() = default;
+
+  bool openHost(const char* hostPath, const char* mode) {
+    close();
+    file = fopen(hostPath, mode);
+    return file != nullptr;
+  }
+  void close() {
+    if (file) {
+      fclose(file);
+      file = nullptr;
+    }
+  }
+  bool isOpen() const { return file != nullptr; }
+  explicit operator bool() const { return isOpen(); }
+
+  int read(void* buffer, const size_t count) {
+    if (!file) return -1;
+    switchDirection(false);
+    return static_cast<int>(fread(buffer, 1, count, file));
+  }
+  int read() {
+    uint8_t byte;
+    return read(&byte, 1) == 1 ? byte : -1;
+  }
+  size_t write(const uint8_t byte) override { return write(&byte, 1); }
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    if (!file) return 0;
+    switchDirection(true);
+    return fwrite(buffer, 1, size, file);
+  }
+  void flush() {
+    if (file) fflush(file);
+  }
+
+  bool seek(const uint64_t position) { return file && fseek(file, static_cast<long>(position), SEEK_SET) == 0; }
+  bool seekCur(const int64_t offset) { return file && fseek(file, static_cast<long>(offset), SEEK_CUR) == 0; }
+  uint64_t position() const { return file ? static_cast<uint64_t>(ftell(file)) : 0; }
+  uint64_t size() const {
+    if (!file) return 0;
+    const long current = ftell(file);
+    fseek(file, 0, SEEK_END);
+    const long end = ftell(file);
+    fseek(file, current, SEEK_SET);
+    return static_cast<uint64_t>(end);
+  }
+  int available() const { return static_cast<int>(size() - position()); }
+  // FAT encoded modification time, as SdFat reports it
+  bool getModifyDateTime(uint16_t* date, uint16_t* time) const {
+    struct stat info;
+    if (!file || fstat(fileno(file), &info) != 0) return false;
+    tm local;
+    localtime_r(&info.st_mtime, &local);
+    *date = static_cast<uint16_t>((local.tm_year - 80) << 9 | (local.tm_mon + 1) << 5 | local.tm_mday);
+    *time = static_cast<uint16_t>(local.tm_hour << 11 | local.tm_min << 5 | local.tm_sec / 2);
+    return true;
+  }
+
+ private:
+  // stdio needs a positioning call between reads and writes on the same stream, SdFat does not
+  void switchDirection(const bool writing) {
+    if (writing != lastWasWrite) {
+      fseek(file, 0, SEEK_CUR);
+      lastWasWrite = writing;
+    }
+  }
+
+  bool lastWasWrite = false;
+  // Copies share the handle, like SdFat handles referring to the same open file
+  FILE* file = nullptr;
+};
@@ -0,0 +1,999 @@
+#include <Bitmap.h>
+#include <BitmapHelpers.h>
+#include <JpegToBmpConverter.h>
+#include <PngToBmpConverter.h>
+#include <SDCardManager.h>
+#include <Xtc.h>
+#include <malloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Host benchmark for the image pipeline: JPEG and PNG cover conversion, Bitmap row decoding, the BitmapHelpers
+// ditherers and XTC cover and thumbnail generation, run over a corpus of generated inputs plus any sample files given
+// with --corpus.
+//
+// Every case reports its best and mean time, the peak heap it allocated and a checksum of its output. --save writes
+// these to a baseline file, --compare checks a run against one and fails on changed output, higher peak heap or a
+// case more than 20% slower, so decoder regressions show up before flashing. Heap is counted through malloc, so
+// picojpeg's static tables and SdFat's own buffers are not included, as on the device.
+//
+// Converter logs go to converter.log in the output directory.
+
+// ---- Heap accounting, linked with -Wl,--wrap for malloc, calloc, realloc and free ----
+
+namespace {
+size_t heapCurrent = 0;
+size_t heapPeak = 0;
+
+void heapAdd(void* pointer) {
+  if (pointer) {
+    heapCurrent += malloc_usable_size(pointer);
+    heapPeak = std::max(heapPeak, heapCurrent);
+  }
+}
+void heapRemove(void* pointer) {
+  if (pointer) {
+    heapCurrent -= std::min(heapCurrent, malloc_usable_size(pointer));
+  }
+}
+}  // namespace
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void __real_free(void* pointer);
+
+void* __wrap_malloc(const size_t size) {
+  void* pointer = __real_malloc(size);
+  heapAdd(pointer);
+  return pointer;
+}
+void* __wrap_calloc(const size_t count, const size_t size) {
+  void* pointer = __real_calloc(count, size);
+  heapAdd(pointer);
+  return pointer;
+}
+void* __wrap_realloc(void* pointer, const size_t size) {
+  const size_t before = pointer ? malloc_usable_size(pointer) : 0;
+  void* moved = __real_realloc(pointer, size);
+  if (moved) {
+    heapCurrent -= std::min(heapCurrent, before);
+    heapAdd(moved);
+  }
+  return moved;
+}
+void __wrap_free(void* pointer) {
+  heapRemove(pointer);
+  __real_free(pointer);
+}
+}
+
+// Replaced so C++ allocations are counted too, straight through the wrappers
+void* operator new(const size_t size) {
+  void* pointer = __wrap_malloc(size ? size : 1);
+  if (!pointer) throw std::bad_alloc();
+  return pointer;
+}
+void* operator new[](const size_t size) { return operator new(size); }
+void* operator new(const size_t size, const std::nothrow_t&) noexcept { return __wrap_malloc(size ? size : 1); }
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept { return __wrap_malloc(size ? size : 1); }
+void operator delete(void* pointer) noexcept { __wrap_free(pointer); }
+void operator delete[](void* pointer) noexcept { __wrap_free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { __wrap_free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { __wrap_free(pointer); }
+
+namespace {
+
+constexpr int kCoverWidth = 480;
+constexpr int kCoverHeight = 800;
+constexpr int kThumbWidth = 240;
+constexpr int kThumbHeight = 400;
+constexpr double kSlowerLimit = 1.20;
+constexpr double kMinSlowerMs = 0.5;
+
+using Clock = std::chrono::steady_clock;
+
+uint32_t fnv1a(const uint8_t* data, const size_t size, uint32_t hash = 2166136261u) {
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+// Print sink that keeps only a checksum, so the converters' output does not count as their heap
+class ChecksumPrint : public Print {
+ public:
+  size_t write(const uint8_t byte) override { return write(&byte, 1); }
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    hash = fnv1a(buffer, size, hash);
+    bytes += size;
+    return size;
+  }
+  uint32_t hash = 2166136261u;
+  size_t bytes = 0;
+};
+
+std::vector<uint8_t> readHostFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeHostFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+// ---- Synthetic images ----
+
+struct RgbImage {
+  int width;
+  int height;
+  std::vector<uint8_t> rgb;  // Top row first, R G B
+};
+
+// Cover-like content: tinted background gradient, a soft disc, a title band of hard strokes and fine texture
+RgbImage makeCover(const int width, const int height, const int seed) {
+  RgbImage image{width, height, std::vector<uint8_t>(static_cast<size_t>(width) * height * 3)};
+  uint32_t noise = 0x9E3779B9u * (seed + 1);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const double u = static_cast<double>(x) / width, v = static_cast<double>(y) / height;
+      double r = 40 + 170 * v, g = 70 + 120 * u, b = 150 - 90 * v + 60 * u;
+      const double dx = u - 0.5 - 0.1 * seed, dy = v - 0.4;
+      const double disc = std::exp(-(dx * dx + dy * dy) / 0.02);
+      r += 120 * disc;
+      g += 90 * disc;
+      b -= 60 * disc;
+      if (v > 0.7 && v < 0.85) {
+        const bool stroke = (x * 13 / width + y * 40 / height) % 3 == 0 && (x / std::max(1, width / 60)) % 4 != 3;
+        if (stroke) r = g = b = 15;
+      }
+      noise = noise * 1664525u + 1013904223u;
+      const double grain = static_cast<double>(noise >> 24) / 16 - 8;
+      uint8_t* p = &image.rgb[(static_cast<size_t>(y) * width + x) * 3];
+      p[0] = static_cast<uint8_t>(std::clamp(r + grain, 0.0, 255.0));
+      p[1] = static_cast<uint8_t>(std::clamp(g + grain, 0.0, 255.0));
+      p[2] = static_cast<uint8_t>(std::clamp(b + grain, 0.0, 255.0));
+    }
+  }
+  return image;
+}
+
+uint8_t luminance(const uint8_t* p) { return static_cast<uint8_t>((77u * p[0] + 150u * p[1] + 29u * p[2]) >> 8); }
+
+// ---- Baseline JPEG encoder (JFIF, Huffman tables from ITU T.81 Annex K) ----
+
+constexpr uint8_t kZigzag[64] = {0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,
+                                 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28,
+                                 35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+                                 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63};
+constexpr uint8_t kLumQuant[64] = {16, 11, 10, 16, 24,  40,  51,  61,  12, 12, 14, 19, 26,  58,  60,  55,
+                                   14, 13, 16, 24, 40,  57,  69,  56,  14, 17, 22, 29, 51,  87,  80,  62,
+                                   18, 22, 37, 56, 68,  109, 103, 77,  24, 35, 55, 64, 81,  104, 113, 92,
+                                   49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99};
+constexpr uint8_t kChromaQuant[64] = {17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99,
+                                      24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+                                      99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99,
+                                      99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99};
+constexpr uint8_t kDcLumBits[16] = {0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0};
+constexpr uint8_t kDcChromaBits[16] = {0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0};
+constexpr uint8_t kDcValues[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+constexpr uint8_t kAcLumBits[16] = {0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d};
+constexpr uint8_t kAcLumValues[162] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14,
+    0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09,
+    0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a,
+    0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65,
+    0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9,
+    0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca,
+    0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea,
+    0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+constexpr uint8_t kAcChromaBits[16] = {0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77};
+constexpr uint8_t kAcChromaValues[162] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32,
+    0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16,
+    0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39,
+    0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64,
+    0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86,
+    0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8,
+    0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9,
+    0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa};
+
+struct HuffmanTable {
+  const uint8_t* bits;
+  const uint8_t* values;
+  int valueCount;
+  uint16_t codes[256] = {};
+  uint8_t sizes[256] = {};
+
+  HuffmanTable(const uint8_t* bits, const uint8_t* values, const int valueCount)
+      : bits(bits), values(values), valueCount(valueCount) {
+    uint16_t code = 0;
+    int k = 0;
+    for (int length = 1; length <= 16; length++) {
+      for (int i = 0; i < bits[length - 1]; i++, k++) {
+        codes[values[k]] = code++;
+        sizes[values[k]] = static_cast<uint8_t>(length);
+      }
+      code <<= 1;
+    }
+  }
+};
+
+enum class Sampling { Gray, S444, S422, S420 };
+
+struct JpegSpec {
+  const char* name;
+  int width;
+  int height;
+  Sampling sampling;
+  int quality;
+  int restartInterval;  // MCUs, 0 for none
+};
+
+class JpegEncoder {
+ public:
+  std::vector<uint8_t> encode(const RgbImage& image, const JpegSpec& spec) {
+    out.clear();
+    const bool gray = spec.sampling == Sampling::Gray;
+    const int hMax = spec.sampling == Sampling::S422 || spec.sampling == Sampling::S420 ? 2 : 1;
+    const int vMax = spec.sampling == Sampling::S420 ? 2 : 1;
+    const int components = gray ? 1 : 3;
+    const int mcusX = (image.width + 8 * hMax - 1) / (8 * hMax);
+    const int mcusY = (image.height + 8 * vMax - 1) / (8 * vMax);
+
+    // Component planes padded to whole MCUs, chroma averaged over its sampling box
+    std::vector<std::vector<double>> planes(components);
+    std::vector<int> planeWidths(components), factorsH(components), factorsV(components);
+    for (int c = 0; c < components; c++) {
+      factorsH[c] = c == 0 ? hMax : 1;
+      factorsV[c] = c == 0 ? vMax : 1;
+      const int stepX = hMax / factorsH[c], stepY = vMax / factorsV[c];
+      const int planeWidth = mcusX * factorsH[c] * 8, planeHeight = mcusY * factorsV[c] * 8;
+      planeWidths[c] = planeWidth;
+      planes[c].resize(static_cast<size_t>(planeWidth) * planeHeight);
+      for (int py = 0; py < planeHeight; py++) {
+        for (int px = 0; px < planeWidth; px++) {
+          double sum = 0;
+          for (int sy = 0; sy < stepY; sy++) {
+            for (int sx = 0; sx < stepX; sx++) {
+              const int x = std::min(px * stepX + sx, image.width - 1), y = std::min(py * stepY + sy, image.height - 1);
+              const uint8_t* p = &image.rgb[(static_cast<size_t>(y) * image.width + x) * 3];
+              if (c == 0) {
+                sum += 0.299 * p[0] + 0.587 * p[1] + 0.114 * p[2];
+              } else if (c == 1) {
+                sum += -0.168736 * p[0] - 0.331264 * p[1] + 0.5 * p[2] + 128;
+              } else {
+                sum += 0.5 * p[0] - 0.418688 * p[1] - 0.081312 * p[2] + 128;
+              }
+            }
+          }
+          planes[c][static_cast<size_t>(py) * planeWidth + px] = sum / (stepX * stepY) - 128;
+        }
+      }
+    }
+
+    uint8_t quant[2][64];
+    const int scale = spec.quality < 50 ? 5000 / spec.quality : 200 - spec.quality * 2;
+    for (int i = 0; i < 64; i++) {
+      quant[0][i] = static_cast<uint8_t>(std::clamp((kLumQuant[i] * scale + 50) / 100, 1, 255));
+      quant[1][i] = static_cast<uint8_t>(std::clamp((kChromaQuant[i] * scale + 50) / 100, 1, 255));
+    }
+
+    // Headers
+    marker(0xD8);
+    marker(0xE0);
+    const uint8_t jfif[] = {0, 16, 'J', 'F', 'I', 'F', 0, 1, 1, 0, 0, 1, 0, 1, 0, 0};
+    bytes(jfif, sizeof(jfif));
+    for (int t = 0; t < (gray ? 1 : 2); t++) {
+      marker(0xDB);
+      word(2 + 65);
+      out.push_back(static_cast<uint8_t>(t));
+      for (int i = 0; i < 64; i++) out.push_back(quant[t][kZigzag[i]]);
+    }
+    marker(0xC0);
+    word(8 + 3 * components);
+    out.push_back(8);
+    word(image.height);
+    word(image.width);
+    out.push_back(static_cast<uint8_t>(components));
+    for (int c = 0; c < components; c++) {
+      out.push_back(static_cast<uint8_t>(c + 1));
+      out.push_back(static_cast<uint8_t>(factorsH[c] << 4 | factorsV[c]));
+      out.push_back(c == 0 ? 0 : 1);
+    }
+    huffmanSegment(0x00, dcLum);
+    huffmanSegment(0x10, acLum);
+    if (!gray) {
+      huffmanSegment(0x01, dcChroma);
+      huffmanSegment(0x11, acChroma);
+    }
+    if (spec.restartInterval > 0) {
+      marker(0xDD);
+      word(4);
+      word(spec.restartInterval);
+    }
+    marker(0xDA);
+    word(6 + 2 * components);
+    out.push_back(static_cast<uint8_t>(components));
+    for (int c = 0; c < components; c++) {
+      out.push_back(static_cast<uint8_t>(c + 1));
+      out.push_back(c == 0 ? 0x00 : 0x11);
+    }
+    out.push_back(0);
+    out.push_back(63);
+    out.push_back(0);
+
+    // Scan
+    bitBuffer = 0;
+    bitCount = 0;
+    int predictors[3] = {};
+    int mcu = 0, restarts = 0;
+    for (int mcuY = 0; mcuY < mcusY; mcuY++) {
+      for (int mcuX = 0; mcuX < mcusX; mcuX++, mcu++) {
+        if (spec.restartInterval > 0 && mcu > 0 && mcu % spec.restartInterval == 0) {
+          flushBits();
+          marker(static_cast<uint8_t>(0xD0 + (restarts++ & 7)));
+          std::fill(std::begin(predictors), std::end(predictors), 0);
+        }
+        for (int c = 0; c < components; c++) {
+          for (int by = 0; by < factorsV[c]; by++) {
+            for (int bx = 0; bx < factorsH[c]; bx++) {
+              const int x0 = (mcuX * factorsH[c] + bx) * 8, y0 = (mcuY * factorsV[c] + by) * 8;
+              encodeBlock(&planes[c][static_cast<size_t>(y0) * planeWidths[c] + x0], planeWidths[c],
+                          quant[c == 0 ? 0 : 1], c == 0 ? dcLum : dcChroma, c == 0 ? acLum : acChroma,
+                          &predictors[c]);
+            }
+          }
+        }
+      }
+    }
+    flushBits();
+    marker(0xD9);
+    return out;
+  }
+
+ private:
+  HuffmanTable dcLum{kDcLumBits, kDcValues, 12};
+  HuffmanTable acLum{kAcLumBits, kAcLumValues, 162};
+  HuffmanTable dcChroma{kDcChromaBits, kDcValues, 12};
+  HuffmanTable acChroma{kAcChromaBits, kAcChromaValues, 162};
+  std::vector<uint8_t> out;
+  uint32_t bitBuffer = 0;
+  int bitCount = 0;
+
+  void marker(const uint8_t code) {
+    out.push_back(0xFF);
+    out.push_back(code);
+  }
+  void word(const int value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+  }
+  void bytes(const uint8_t* data, const size_t size) { out.insert(out.end(), data, data + size); }
+
+  void huffmanSegment(const uint8_t classAndId, const HuffmanTable& table) {
+    marker(0xC4);
+    word(2 + 1 + 16 + table.valueCount);
+    out.push_back(classAndId);
+    bytes(table.bits, 16);
+    bytes(table.values, table.valueCount);
+  }
+
+  void putBits(const uint32_t value, const int count) {
+    bitBuffer = bitBuffer << count | (value & ((1u << count) - 1));
+    bitCount += count;
+    while (bitCount >= 8) {
+      const auto byte = static_cast<uint8_t>(bitBuffer >> (bitCount - 8));
+      out.push_back(byte);
+      if (byte == 0xFF) out.push_back(0);
+      bitCount -= 8;
+    }
+  }
+  void flushBits() {
+    if (bitCount > 0) putBits(0x7F, 8 - bitCount);  // Pad with ones
+    bitBuffer = 0;
+    bitCount = 0;
+  }
+
+  void putValue(const HuffmanTable& table, const int symbolLow, const int value) {
+    const int magnitude = std::abs(value);
+    int size = 0;
+    while (magnitude >> size) size++;
+    const int symbol = symbolLow | size;
+    putBits(table.codes[symbol], table.sizes[symbol]);
+    if (size > 0) putBits(static_cast<uint32_t>(value < 0 ? value - 1 : value), size);
+  }
+
+  void encodeBlock(const double* pixels, const int stride, const uint8_t* quant, const HuffmanTable& dc,
+                   const HuffmanTable& ac, int* predictor) {
+    static double cosines[8][8];
+    static bool ready = false;
+    if (!ready) {
+      for (int u = 0; u < 8; u++) {
+        for (int x = 0; x < 8; x++) {
+          cosines[u][x] = std::cos((2 * x + 1) * u * M_PI / 16) * (u == 0 ? std::sqrt(0.5) : 1.0);
+        }
+      }
+      ready = true;
+    }
+    double rows[8][8];
+    for (int y = 0; y < 8; y++) {
+      for (int u = 0; u < 8; u++) {
+        double sum = 0;
+        for (int x = 0; x < 8; x++) sum += cosines[u][x] * pixels[y * stride + x];
+        rows[y][u] = sum / 2;
+      }
+    }
+    int coefficients[64];
+    for (int u = 0; u < 8; u++) {
+      for (int v = 0; v < 8; v++) {
+        double sum = 0;
+        for (int y = 0; y < 8; y++) sum += cosines[v][y] * rows[y][u];
+        coefficients[v * 8 + u] = static_cast<int>(std::lround(sum / 2 / quant[v * 8 + u]));
+      }
+    }
+
+    putValue(dc, 0, coefficients[0] - *predictor);
+    *predictor = coefficients[0];
+    int run = 0;
+    for (int i = 1; i < 64; i++) {
+      const int value = coefficients[kZigzag[i]];
+      if (value == 0) {
+        run++;
+        continue;
+      }
+      for (; run >= 16; run -= 16) putBits(ac.codes[0xF0], ac.sizes[0xF0]);
+      putValue(ac, run << 4, value);
+      run = 0;
+    }
+    if (run > 0) putBits(ac.codes[0x00], ac.sizes[0x00]);
+  }
+};
+
+// ---- BMP and XTC writers ----
+
+void put16(std::vector<uint8_t>* out, const uint16_t value) {
+  out->push_back(static_cast<uint8_t>(value));
+  out->push_back(static_cast<uint8_t>(value >> 8));
+}
+void put32(std::vector<uint8_t>* out, const uint32_t value) {
+  put16(out, static_cast<uint16_t>(value));
+  put16(out, static_cast<uint16_t>(value >> 16));
+}
+void put64(std::vector<uint8_t>* out, const uint64_t value) {
+  put32(out, static_cast<uint32_t>(value));
+  put32(out, static_cast<uint32_t>(value >> 32));
+}
+
+struct BmpSpec {
+  const char* name;
+  int width;
+  int height;
+  int bpp;  // 1, 2 and 8 are gray palettes, 32 is BI_BITFIELDS BGRA
+  bool topDown;
+};
+
+std::vector<uint8_t> encodeBmp(const RgbImage& image, const BmpSpec& spec) {
+  const int paletteSize = spec.bpp <= 8 ? 1 << spec.bpp : 0;
+  const int maskBytes = spec.bpp == 32 ? 12 : 0;
+  const uint32_t rowBytes = (spec.width * spec.bpp + 31) / 32 * 4;
+  const uint32_t dataOffset = 14 + 40 + maskBytes + paletteSize * 4;
+  std::vector<uint8_t> out;
+  out.push_back('B');
+  out.push_back('M');
+  put32(&out, dataOffset + rowBytes * spec.height);
+  put32(&out, 0);
+  put32(&out, dataOffset);
+  put32(&out, 40);
+  put32(&out, spec.width);
+  put32(&out, static_cast<uint32_t>(spec.topDown ? -spec.height : spec.height));
+  put16(&out, 1);
+  put16(&out, static_cast<uint16_t>(spec.bpp));
+  put32(&out, spec.bpp == 32 ? 3 : 0);
+  put32(&out, rowBytes * spec.height);
+  put32(&out, 2835);
+  put32(&out, 2835);
+  put32(&out, paletteSize);
+  put32(&out, 0);
+  if (spec.bpp == 32) {
+    put32(&out, 0x00FF0000);
+    put32(&out, 0x0000FF00);
+    put32(&out, 0x000000FF);
+  }
+  for (int i = 0; i < paletteSize; i++) {
+    const auto level = static_cast<uint8_t>(i * 255 / (paletteSize - 1));
+    out.insert(out.end(), {level, level, level, 0});
+  }
+  for (int row = 0; row < spec.height; row++) {
+    const int y = spec.topDown ? row : spec.height - 1 - row;
+    std::vector<uint8_t> bytes(rowBytes, 0);
+    for (int x = 0; x < spec.width; x++) {
+      const uint8_t* p = &image.rgb[(static_cast<size_t>(y) * image.width + x) * 3];
+      const uint8_t gray = luminance(p);
+      switch (spec.bpp) {
+        case 1:
+          bytes[x >> 3] |= (gray >= 128) << (7 - (x & 7));
+          break;
+        case 2:
+          bytes[x >> 2] |= (gray >> 6) << (6 - (x & 3) * 2);
+          break;
+        case 8:
+          bytes[x] = gray;
+          break;
+        case 24:
+          bytes[x * 3] = p[2];
+          bytes[x * 3 + 1] = p[1];
+          bytes[x * 3 + 2] = p[0];
+          break;
+        default:
+          bytes[x * 4] = p[2];
+          bytes[x * 4 + 1] = p[1];
+          bytes[x * 4 + 2] = p[0];
+          bytes[x * 4 + 3] = 0xFF;
+          break;
+      }
+    }
+    out.insert(out.end(), bytes.begin(), bytes.end());
+  }
+  return out;
+}
+
+struct XtcSpec {
+  const char* name;
+  int bitDepth;
+  int pageCount;
+};
+
+// XTC/XTCH with full-screen pages: XTG rows (1 white) or XTH planes (column-major from the right, 3 black)
+std::vector<uint8_t> encodeXtc(const XtcSpec& spec) {
+  constexpr int width = xtc::DISPLAY_WIDTH, height = xtc::DISPLAY_HEIGHT;
+  constexpr uint32_t pageTableOffset = 0x100;
+  const uint32_t dataOffset = pageTableOffset + spec.pageCount * sizeof(xtc::PageTableEntry);
+  const size_t bitmapSize = spec.bitDepth == 2 ? (width * height + 7) / 8 * 2 : (width + 7) / 8 * height;
+  const size_t pageSize = sizeof(xtc::XtgPageHeader) + bitmapSize;
+
+  std::vector<uint8_t> out;
+  put32(&out, spec.bitDepth == 2 ? xtc::XTCH_MAGIC : xtc::XTC_MAGIC);
+  out.push_back(1);
+  out.push_back(0);
+  put16(&out, static_cast<uint16_t>(spec.pageCount));
+  put32(&out, 0);
+  put32(&out, 88);
+  put32(&out, 0);
+  put32(&out, 0);
+  put64(&out, pageTableOffset);
+  put64(&out, dataOffset);
+  put64(&out, 0);
+  put32(&out, 0x38);
+  put32(&out, 0);
+  const std::string title = std::string("Benchmark ") + spec.name;
+  out.insert(out.end(), title.begin(), title.end());
+  out.resize(pageTableOffset, 0);
+  for (int page = 0; page < spec.pageCount; page++) {
+    put64(&out, dataOffset + page * pageSize);
+    put32(&out, static_cast<uint32_t>(bitmapSize));
+    put16(&out, width);
+    put16(&out, height);
+  }
+
+  for (int page = 0; page < spec.pageCount; page++) {
+    const RgbImage image = makeCover(width, height, page);
+    put32(&out, spec.bitDepth == 2 ? xtc::XTH_MAGIC : xtc::XTG_MAGIC);
+    put16(&out, width);
+    put16(&out, height);
+    out.push_back(0);
+    out.push_back(0);
+    put32(&out, static_cast<uint32_t>(bitmapSize));
+    put64(&out, 0);
+    std::vector<uint8_t> bitmap(bitmapSize, 0);
+    const size_t planeSize = bitmapSize / 2, colBytes = (height + 7) / 8;
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        const uint8_t gray = luminance(&image.rgb[(static_cast<size_t>(y) * width + x) * 3]);
+        if (spec.bitDepth == 2) {
+          const int value = 3 - gray / 64;
+          const size_t byte = (width - 1 - x) * colBytes + y / 8;
+          bitmap[byte] |= (value >> 1) << (7 - (y & 7));
+          bitmap[planeSize + byte] |= (value & 1) << (7 - (y & 7));
+        } else {
+          bitmap[y * ((width + 7) / 8) + x / 8] |= (gray >= 128) << (7 - (x & 7));
+        }
+      }
+    }
+    out.insert(out.end(), bitmap.begin(), bitmap.end());
+  }
+  return out;
+}
+
+// ---- Cases ----
+
+struct Result {
+  bool ok = false;
+  uint32_t checksum = 0;
+};
+
+struct Case {
+  std::string name;
+  std::function<Result()> run;
+  std::function<void()> reset;  // Before every iteration, outside the timing
+};
+
+struct Measurement {
+  std::string name;
+  bool ok;
+  double bestMs;
+  double meanMs;
+  size_t peakBytes;
+  uint32_t checksum;
+};
+
+Result convertImage(const std::string& cardPath, const bool png, const bool thumb) {
+  FsFile file;
+  if (!SdMan.openFileForRead("BENCH", cardPath, file)) {
+    return {};
+  }
+  ChecksumPrint out;
+  bool ok;
+  if (png) {
+    ok = thumb ? PngToBmpConverter::pngFileTo1BitBmpStreamWithSize(file, out, kThumbWidth, kThumbHeight)
+               : PngToBmpConverter::pngFileToBmpStream(file, out);
+  } else {
+    ok = thumb ? JpegToBmpConverter::jpegFileTo1BitBmpStreamWithSize(file, out, kThumbWidth, kThumbHeight)
+               : JpegToBmpConverter::jpegFileToBmpStream(file, out);
+  }
+  file.close();
+  return {ok && out.bytes > 0, out.hash};
+}
+
+// Row decoding as GfxRenderer::drawBitmap does it, with the renderer's row buffers
+Result decodeBitmapRows(const std::string& cardPath, const bool dithering) {
+  FsFile file;
+  if (!SdMan.openFileForRead("BENCH", cardPath, file)) {
+    return {};
+  }
+  Result result;
+  {
+    Bitmap bitmap(file, dithering);
+    if (bitmap.parseHeaders() == BmpReaderError::Ok) {
+      const int outputBytes = (bitmap.getWidth() + 3) / 4;
+      auto* outputRow = static_cast<uint8_t*>(malloc(outputBytes));
+      auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+      uint32_t hash = 2166136261u;
+      result.ok = outputRow && rowBytes;
+      for (int y = 0; result.ok && y < bitmap.getHeight(); y++) {
+        result.ok = bitmap.readNextRow(outputRow, rowBytes) == BmpReaderError::Ok;
+        hash = fnv1a(outputRow, outputBytes, hash);
+      }
+      result.checksum = hash;
+      free(outputRow);
+      free(rowBytes);
+    }
+  }
+  file.close();
+  return result;
+}
+
+// Whole-image ditherers as the converters drive them: one pixel at a time into packed BMP rows
+Result runDitherer(const std::vector<uint8_t>& gray, const std::string& method) {
+  const int width = kCoverWidth, height = kCoverHeight;
+  const bool oneBit = method.find("1bit") != std::string::npos;
+  const int stride = oneBit ? (width + 7) / 8 : (width + 3) / 4;
+  auto* row = static_cast<uint8_t*>(malloc(stride));
+  auto* grayRow = static_cast<uint8_t*>(malloc(width));
+  AtkinsonDitherer* atkinson = method == "atkinson" ? new AtkinsonDitherer(width) : nullptr;
+  FloydSteinbergDitherer* floydSteinberg = method == "floyd-steinberg" ? new FloydSteinbergDitherer(width) : nullptr;
+  Atkinson1BitDitherer* atkinson1Bit = method == "atkinson-1bit" ? new Atkinson1BitDitherer(width) : nullptr;
+
+  uint32_t hash = 2166136261u;
+  for (int y = 0; y < height; y++) {
+    const uint8_t* src = &gray[static_cast<size_t>(y) * width];
+    memset(row, 0, stride);
+    if (method == "bayer" || method == "blue-noise" || method == "bayer-1bit" || method == "blue-noise-1bit") {
+      const DitherPattern pattern = method.rfind("bayer", 0) == 0 ? DitherPattern::Bayer : DitherPattern::BlueNoise;
+      for (int x = 0; x < width; x++) grayRow[x] = static_cast<uint8_t>(adjustPixel(src[x]));
+      if (oneBit) {
+        orderedDitherRow1Bit(grayRow, width, y, pattern, row);
+      } else {
+        orderedDitherRow2Bit(grayRow, width, y, pattern, row);
+      }
+    } else {
+      for (int x = 0; x < width; x++) {
+        if (oneBit) {
+          const uint8_t bit = atkinson1Bit ? atkinson1Bit->processPixel(src[x], x) : quantize1bit(src[x], x, y);
+          row[x >> 3] |= bit << (7 - (x & 7));
+        } else {
+          const int adjusted = adjustPixel(src[x]);
+          const uint8_t level = atkinson         ? atkinson->processPixel(adjusted, x)
+                                : floydSteinberg ? floydSteinberg->processPixel(adjusted, x)
+                                                 : quantize(adjusted, x, y);
+          row[x >> 2] |= level << (6 - (x & 3) * 2);
+        }
+      }
+      if (atkinson) atkinson->nextRow();
+      if (floydSteinberg) floydSteinberg->nextRow();
+      if (atkinson1Bit) atkinson1Bit->nextRow();
+    }
+    hash = fnv1a(row, stride, hash);
+  }
+
+  delete atkinson;
+  delete floydSteinberg;
+  delete atkinson1Bit;
+  free(row);
+  free(grayRow);
+  return {true, hash};
+}
+
+Result hashCardFile(const std::string& cardPath) {
+  const std::vector<uint8_t> data = readHostFile(SdMan.hostPath(cardPath.c_str()));
+  return {!data.empty(), fnv1a(data.data(), data.size())};
+}
+
+Result runXtc(const std::string& cardPath, const std::string& step) {
+  Result result;
+  {
+    Xtc book(cardPath, "/.crosspoint");
+    if (book.load()) {
+      if (step == "load") {
+        result = {book.getPageCount() > 0, book.getPageCount()};
+      } else if (step == "cover") {
+        result = book.generateCoverBmp() ? hashCardFile(book.getCoverBmpPath()) : Result{};
+      } else {
+        result = book.generateThumbBmp() ? hashCardFile(book.getThumbBmpPath()) : Result{};
+      }
+    }
+  }
+  return result;
+}
+
+void clearXtcCache(const std::string& cardPath) {
+  const Xtc book(cardPath, "/.crosspoint");
+  SdMan.removeDir(book.getCachePath().c_str());
+}
+
+Measurement measure(const Case& testCase, const int iterations) {
+  Measurement measurement{testCase.name, true, 1e30, 0, 0, 0};
+  for (int i = 0; i < iterations; i++) {
+    if (testCase.reset) testCase.reset();
+    const size_t heapBefore = heapCurrent;
+    heapPeak = heapCurrent;
+    const auto start = Clock::now();
+    const Result result = testCase.run();
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    measurement.ok = measurement.ok && result.ok;
+    measurement.checksum = result.checksum;
+    measurement.peakBytes = std::max(measurement.peakBytes, heapPeak - heapBefore);
+    measurement.bestMs = std::min(measurement.bestMs, ms);
+    measurement.meanMs += ms / iterations;
+  }
+  return measurement;
+}
+
+std::string extensionOf(const std::string& name) {
+  const size_t dot = name.rfind('.');
+  std::string extension = dot == std::string::npos ? "" : name.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+  return extension;
+}
+
+// Adds the cases for one image or book on the card
+void addFileCases(const std::string& label, const std::string& cardPath, std::vector<Case>* cases) {
+  const std::string extension = extensionOf(cardPath);
+  if (extension == "jpg" || extension == "jpeg" || extension == "png") {
+    const bool png = extension == "png";
+    cases->push_back({label + " cover", [=] { return convertImage(cardPath, png, false); }, nullptr});
+    cases->push_back({label + " thumb", [=] { return convertImage(cardPath, png, true); }, nullptr});
+  } else if (extension == "bmp") {
+    cases->push_back({label + " rows", [=] { return decodeBitmapRows(cardPath, false); }, nullptr});
+    cases->push_back({label + " rows dithered", [=] { return decodeBitmapRows(cardPath, true); }, nullptr});
+  } else if (extension == "xtc" || extension == "xtch") {
+    const auto reset = [=] { clearXtcCache(cardPath); };
+    cases->push_back({label + " load", [=] { return runXtc(cardPath, "load"); }, nullptr});
+    cases->push_back({label + " cover", [=] { return runXtc(cardPath, "cover"); }, reset});
+    cases->push_back({label + " thumb", [=] { return runXtc(cardPath, "thumb"); }, reset});
+  }
+}
+
+std::vector<Case> buildCorpus(const std::string& cardRoot, const std::vector<std::string>& sampleDirs,
+                              const bool synthetic, std::vector<uint8_t>* ditherGray) {
+  std::vector<Case> cases;
+  std::filesystem::create_directories(cardRoot + "/corpus");
+
+  if (synthetic) {
+    const JpegSpec jpegs[] = {
+        {"cover-1200x1800-420", 1200, 1800, Sampling::S420, 85, 0},
+        {"cover-600x900-gray", 600, 900, Sampling::Gray, 90, 0},
+        {"cover-480x800-444", 480, 800, Sampling::S444, 95, 0},
+        {"cover-1600x2400-422-rst", 1600, 2400, Sampling::S422, 80, 32},
+        {"cover-2000x3000-420", 2000, 3000, Sampling::S420, 75, 0},
+        {"wide-2048x1365-420", 2048, 1365, Sampling::S420, 85, 0},
+    };
+    JpegEncoder encoder;
+    for (const JpegSpec& spec : jpegs) {
+      const std::string cardPath = std::string("/corpus/") + spec.name + ".jpg";
+      writeHostFile(SdMan.hostPath(cardPath.c_str()), encoder.encode(makeCover(spec.width, spec.height, 0), spec));
+      addFileCases(std::string("jpeg ") + spec.name, cardPath, &cases);
+    }
+
+    const BmpSpec bmps[] = {
+        {"24bit-480x800", 480, 800, 24, false},     {"32bit-480x800-topdown", 480, 800, 32, true},
+        {"8bit-600x900", 600, 900, 8, false},       {"2bit-480x800-topdown", 480, 800, 2, true},
+        {"1bit-240x400-topdown", 240, 400, 1, true}};
+    for (const BmpSpec& spec : bmps) {
+      const std::string cardPath = std::string("/corpus/") + spec.name + ".bmp";
+      writeHostFile(SdMan.hostPath(cardPath.c_str()), encodeBmp(makeCover(spec.width, spec.height, 1), spec));
+      addFileCases(std::string("bmp ") + spec.name, cardPath, &cases);
+    }
+
+    const XtcSpec books[] = {{"1bit-4pages", 1, 4}, {"2bit-4pages", 2, 4}};
+    for (const XtcSpec& spec : books) {
+      const std::string cardPath = std::string("/corpus/") + spec.name + (spec.bitDepth == 2 ? ".xtch" : ".xtc");
+      writeHostFile(SdMan.hostPath(cardPath.c_str()), encodeXtc(spec));
+      addFileCases(std::string("xtc ") + spec.name, cardPath, &cases);
+    }
+
+    const RgbImage cover = makeCover(kCoverWidth, kCoverHeight, 2);
+    ditherGray->resize(static_cast<size_t>(kCoverWidth) * kCoverHeight);
+    for (size_t i = 0; i < ditherGray->size(); i++) (*ditherGray)[i] = luminance(&cover.rgb[i * 3]);
+    for (const char* method : {"quantize", "atkinson", "floyd-steinberg", "bayer", "blue-noise", "quantize-1bit",
+                               "atkinson-1bit", "bayer-1bit", "blue-noise-1bit"}) {
+      const std::string name = method;
+      cases.push_back({"dither " + name, [=] { return runDitherer(*ditherGray, name); }, nullptr});
+    }
+  }
+
+  for (const std::string& dir : sampleDirs) {
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+      if (entry.is_regular_file()) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto& path : files) {
+      const std::string cardPath = "/corpus/sample-" + path.filename().string();
+      std::filesystem::copy_file(path, SdMan.hostPath(cardPath.c_str()),
+                                 std::filesystem::copy_options::overwrite_existing);
+      addFileCases("sample " + path.filename().string(), cardPath, &cases);
+    }
+  }
+  return cases;
+}
+
+// Baseline lines: name, ok, best ms, peak bytes, checksum, tab separated
+void saveBaseline(const std::string& path, const std::vector<Measurement>& measurements) {
+  std::ofstream out(path);
+  for (const Measurement& m : measurements) {
+    char line[64];
+    snprintf(line, sizeof(line), "\t%d\t%.3f\t%zu\t%08x\n", m.ok ? 1 : 0, m.bestMs, m.peakBytes, m.checksum);
+    out << m.name << line;
+  }
+}
+
+int compareBaseline(const std::string& path, const std::vector<Measurement>& measurements) {
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "Cannot read baseline %s\n", path.c_str());
+    return 2;
+  }
+  std::map<std::string, Measurement> baseline;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    Measurement m{};
+    std::string ok, checksum;
+    if (std::getline(fields, m.name, '\t') && fields >> ok >> m.bestMs >> m.peakBytes >> checksum) {
+      m.ok = ok == "1";
+      m.checksum = static_cast<uint32_t>(std::stoul(checksum, nullptr, 16));
+      baseline[m.name] = m;
+    }
+  }
+
+  int regressions = 0;
+  printf("\nAgainst %s:\n", path.c_str());
+  for (const Measurement& m : measurements) {
+    const auto it = baseline.find(m.name);
+    if (it == baseline.end()) {
+      printf("  %-44s new case\n", m.name.c_str());
+      continue;
+    }
+    const Measurement& before = it->second;
+    if (m.ok != before.ok) {
+      printf("  %-44s %s\n", m.name.c_str(), m.ok ? "now succeeds" : "FAILS NOW");
+      regressions += !m.ok;
+    } else if (m.checksum != before.checksum) {
+      printf("  %-44s OUTPUT CHANGED %08x -> %08x\n", m.name.c_str(), before.checksum, m.checksum);
+      regressions++;
+    }
+    if (m.peakBytes > before.peakBytes) {
+      printf("  %-44s PEAK HEAP %zu -> %zu bytes\n", m.name.c_str(), before.peakBytes, m.peakBytes);
+      regressions++;
+    }
+    if (m.bestMs > before.bestMs * kSlowerLimit && m.bestMs - before.bestMs > kMinSlowerMs) {
+      printf("  %-44s SLOWER %.2f -> %.2f ms\n", m.name.c_str(), before.bestMs, m.bestMs);
+      regressions++;
+    }
+  }
+  printf("%d regression(s)\n", regressions);
+  return regressions > 0 ? 1 : 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string outDir = "build/image_pipeline_bench";
+  std::vector<std::string> sampleDirs;
+  std::string savePath, comparePath;
+  int iterations = 5;
+  bool synthetic = true;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else if (arg == "--corpus" && i + 1 < argc) {
+      sampleDirs.emplace_back(argv[++i]);
+    } else if (arg == "--samples-only") {
+      synthetic = false;
+    } else if (arg == "--iterations" && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--save" && i + 1 < argc) {
+      savePath = argv[++i];
+    } else if (arg == "--compare" && i + 1 < argc) {
+      comparePath = argv[++i];
+    } else {
+      fprintf(stderr,
+              "Usage: ImagePipelineBenchmark [--corpus DIR]... [--samples-only] [--iterations N] [--save FILE] "
+              "[--compare FILE] [--out DIR]\n");
+      return 2;
+    }
+  }
+
+  const std::string cardRoot = outDir + "/card";
+  std::filesystem::remove_all(cardRoot);
+  std::filesystem::create_directories(cardRoot);
+  SdMan.setRoot(cardRoot);
+  const std::string logPath = outDir + "/converter.log";
+  if (!freopen(logPath.c_str(), "w", stderr)) {
+    return 2;
+  }
+
+  std::vector<uint8_t> ditherGray;
+  const std::vector<Case> cases = buildCorpus(cardRoot, sampleDirs, synthetic, &ditherGray);
+
+  printf("%-44s %10s %10s %12s  %s\n", "case", "best ms", "mean ms", "peak heap", "checksum");
+  std::vector<Measurement> measurements;
+  for (const Case& testCase : cases) {
+    const Measurement m = measure(testCase, iterations);
+    measurements.push_back(m);
+    if (m.ok) {
+      printf("%-44s %10.2f %10.2f %12zu  %08x\n", m.name.c_str(), m.bestMs, m.meanMs, m.peakBytes, m.checksum);
+    } else {
+      printf("%-44s %10.2f %10.2f %12zu  FAILED\n", m.name.c_str(), m.bestMs, m.meanMs, m.peakBytes);
+    }
+    fflush(stdout);
+  }
+  printf("Converter log: %s\n", logPath.c_str());
+
+  if (!savePath.empty()) {
+    saveBaseline(savePath, measurements);
+    printf("Baseline written to %s\n", savePath.c_str());
+  }
+  if (!comparePath.empty()) {
+    return compareBaseline(comparePath, measurements);
+  }
+  return std::all_of(measurements.begin(), measurements.end(), [](const Measurement& m) { return m.ok; }) ? 0 : 1;
+}
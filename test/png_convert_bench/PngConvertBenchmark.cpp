@@ -0,0 +1,425 @@
+#include <PngToBmpConverter.h>
+#include <SDCardManager.h>
+#include <ScaledBmpWriter.h>
+#include <miniz.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Host benchmark for PNG cover conversion: encodes synthetic covers in every PNG color type and bit depth (all five
+// row filters, IDAT split over many chunks), converts them to the 2-bit cover and 1-bit thumbnail BMPs through
+// PngToBmpConverter and reports the time per conversion.
+//
+// Each BMP is checked against ScaledBmpWriter fed with gray rows computed here from the source samples, so the decoder
+// (inflate, unfiltering, sample unpacking, palette and transparency) is verified byte for byte.
+
+namespace {
+
+constexpr int kCoverWidth = 480;
+constexpr int kCoverHeight = 800;
+constexpr int kThumbWidth = 240;
+constexpr int kThumbHeight = 400;
+constexpr size_t kIdatChunkSize = 8192;
+
+using Clock = std::chrono::steady_clock;
+
+class MemoryPrint : public Print {
+ public:
+  size_t write(const uint8_t byte) override {
+    data.push_back(byte);
+    return 1;
+  }
+  size_t write(const uint8_t* buffer, const size_t size) override {
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+  std::vector<uint8_t> data;
+};
+
+struct Case {
+  const char* name;
+  int width;
+  int height;
+  uint8_t colorType;
+  uint8_t bitDepth;
+  int paletteSize = 0;        // PALETTE only
+  bool transparency = false;  // tRNS: palette alpha, or a color key for gray and RGB
+};
+
+int channelsOf(const uint8_t colorType) {
+  switch (colorType) {
+    case 2:
+      return 3;
+    case 4:
+      return 2;
+    case 6:
+      return 4;
+    default:
+      return 1;
+  }
+}
+
+// Same conversions as the decoder
+int luminance(const int r, const int g, const int b) { return (r * 25 + g * 50 + b * 25) / 100; }
+int onWhite(const int gray, const int alpha) { return (gray * alpha + 255 * (255 - alpha)) / 255; }
+
+// Cover-like content: a soft gradient, a dark title band and fine stripes standing in for text
+int coverValue(const int x, const int y, const int width, const int height, const int channel) {
+  int value = 40 + (x * 150 / width) + (y * 60 / height) + channel * 17;
+  if (y > height / 5 && y < height / 3 && x > width / 8 && x < width * 7 / 8) {
+    value = ((x / 6 + y / 9) % 4 == 0) ? 20 : 235 - channel * 30;
+  }
+  if (y > height * 3 / 4 && ((x / 3) % 5 == 0 || (y / 4) % 7 == 0)) {
+    value = 255 - value;
+  }
+  return value & 0xFF;
+}
+
+struct Image {
+  std::vector<std::vector<uint16_t>> samples;  // Per row, channels interleaved, at the PNG bit depth
+  std::vector<uint8_t> palette;                // RGB triplets
+  std::vector<uint8_t> paletteAlpha;
+  uint16_t colorKey[3] = {};
+};
+
+Image makeImage(const Case& c) {
+  Image image;
+  const int channels = channelsOf(c.colorType);
+  const int maxValue = (1 << c.bitDepth) - 1;
+  srand(1234);
+  if (c.colorType == 3) {
+    for (int i = 0; i < c.paletteSize; i++) {
+      image.palette.push_back(rand() & 0xFF);
+      image.palette.push_back(rand() & 0xFF);
+      image.palette.push_back(rand() & 0xFF);
+      if (c.transparency) {
+        image.paletteAlpha.push_back(i % 3 == 0 ? rand() & 0xFF : 255);
+      }
+    }
+  }
+  image.colorKey[0] = static_cast<uint16_t>(coverValue(0, 0, c.width, c.height, 0) * maxValue / 255);
+  image.colorKey[1] = static_cast<uint16_t>(coverValue(0, 0, c.width, c.height, 1) * maxValue / 255);
+  image.colorKey[2] = static_cast<uint16_t>(coverValue(0, 0, c.width, c.height, 2) * maxValue / 255);
+
+  image.samples.resize(c.height);
+  for (int y = 0; y < c.height; y++) {
+    auto& row = image.samples[y];
+    row.resize(static_cast<size_t>(c.width) * channels);
+    for (int x = 0; x < c.width; x++) {
+      for (int ch = 0; ch < channels; ch++) {
+        int value;
+        if (c.colorType == 3) {
+          value = (coverValue(x, y, c.width, c.height, 0) * c.paletteSize / 256) ^ ((x / 16) & 1);
+          value = value < c.paletteSize ? value : c.paletteSize - 1;
+        } else if ((c.colorType == 4 && ch == 1) || (c.colorType == 6 && ch == 3)) {
+          value = (x * 255 / c.width + y * 7) % 256 > 200 ? (x + y) & 0xFF : 255;  // Alpha
+          value = value * maxValue / 255;
+        } else if (c.bitDepth == 16) {
+          value = coverValue(x, y, c.width, c.height, ch) * 257 ^ ((x * 31 + y) & 0xFF);
+        } else {
+          value = coverValue(x, y, c.width, c.height, ch) * maxValue / 255;
+        }
+        row[static_cast<size_t>(x) * channels + ch] = static_cast<uint16_t>(value);
+      }
+    }
+  }
+  return image;
+}
+
+std::vector<uint8_t> referenceGrayRow(const Case& c, const Image& image, const int y) {
+  const int channels = channelsOf(c.colorType);
+  const int maxValue = (1 << c.bitDepth) - 1;
+  const auto to8Bit = [&](const int value) {
+    return c.bitDepth == 16 ? value >> 8 : c.bitDepth == 8 ? value : value * 255 / maxValue;
+  };
+  std::vector<uint8_t> gray(c.width);
+  for (int x = 0; x < c.width; x++) {
+    const uint16_t* s = &image.samples[y][static_cast<size_t>(x) * channels];
+    switch (c.colorType) {
+      case 0:
+        gray[x] = c.transparency && s[0] == image.colorKey[0] ? 255 : to8Bit(s[0]);
+        break;
+      case 2: {
+        const bool keyed =
+            c.transparency && s[0] == image.colorKey[0] && s[1] == image.colorKey[1] && s[2] == image.colorKey[2];
+        gray[x] = keyed ? 255 : luminance(to8Bit(s[0]), to8Bit(s[1]), to8Bit(s[2]));
+        break;
+      }
+      case 3: {
+        const int g = luminance(image.palette[s[0] * 3], image.palette[s[0] * 3 + 1], image.palette[s[0] * 3 + 2]);
+        gray[x] = c.transparency ? onWhite(g, image.paletteAlpha[s[0]]) : g;
+        break;
+      }
+      case 4:
+        gray[x] = onWhite(to8Bit(s[0]), to8Bit(s[1]));
+        break;
+      default:
+        gray[x] = onWhite(luminance(to8Bit(s[0]), to8Bit(s[1]), to8Bit(s[2])), to8Bit(s[3]));
+        break;
+    }
+  }
+  return gray;
+}
+
+void put32(std::vector<uint8_t>* out, const uint32_t value) {
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out->push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void putChunk(std::vector<uint8_t>* out, const char* type, const uint8_t* data, const size_t length) {
+  put32(out, static_cast<uint32_t>(length));
+  const size_t start = out->size();
+  out->insert(out->end(), type, type + 4);
+  if (length > 0) {
+    out->insert(out->end(), data, data + length);
+  }
+  put32(out, static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, out->data() + start, length + 4)));
+}
+
+uint8_t paeth(const int a, const int b, const int c) {
+  const int p = a + b - c;
+  const int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+}
+
+// Packs the samples and filters each row with filter type y % 5
+std::vector<uint8_t> encodePng(const Case& c, const Image& image, const bool interlaced = false) {
+  const int channels = channelsOf(c.colorType);
+  const size_t bitsPerPixel = static_cast<size_t>(channels) * c.bitDepth;
+  const size_t rowBytes = (c.width * bitsPerPixel + 7) / 8;
+  const size_t stride = bitsPerPixel < 8 ? 1 : bitsPerPixel / 8;
+
+  std::vector<uint8_t> raw;
+  raw.reserve((rowBytes + 1) * c.height);
+  std::vector<uint8_t> previous(rowBytes, 0), current(rowBytes);
+  for (int y = 0; y < c.height; y++) {
+    std::fill(current.begin(), current.end(), 0);
+    const auto& samples = image.samples[y];
+    for (size_t i = 0; i < samples.size(); i++) {
+      if (c.bitDepth == 16) {
+        current[i * 2] = samples[i] >> 8;
+        current[i * 2 + 1] = samples[i] & 0xFF;
+      } else if (c.bitDepth == 8) {
+        current[i] = static_cast<uint8_t>(samples[i]);
+      } else {
+        const size_t bit = i * c.bitDepth;
+        current[bit >> 3] |= samples[i] << (8 - c.bitDepth - (bit & 7));
+      }
+    }
+    const uint8_t filter = static_cast<uint8_t>(y % 5);
+    raw.push_back(filter);
+    for (size_t i = 0; i < rowBytes; i++) {
+      const int left = i >= stride ? current[i - stride] : 0;
+      const int upperLeft = i >= stride ? previous[i - stride] : 0;
+      int predicted = 0;
+      switch (filter) {
+        case 1:
+          predicted = left;
+          break;
+        case 2:
+          predicted = previous[i];
+          break;
+        case 3:
+          predicted = (left + previous[i]) >> 1;
+          break;
+        case 4:
+          predicted = paeth(left, previous[i], upperLeft);
+          break;
+        default:
+          break;
+      }
+      raw.push_back(static_cast<uint8_t>(current[i] - predicted));
+    }
+    std::swap(previous, current);
+  }
+
+  size_t compressedSize = 0;
+  void* compressed = tdefl_compress_mem_to_heap(raw.data(), raw.size(), &compressedSize,
+                                                tdefl_create_comp_flags_from_zip_params(3, 15, 0));
+
+  std::vector<uint8_t> png = {137, 80, 78, 71, 13, 10, 26, 10};
+  uint8_t ihdr[13] = {};
+  for (int i = 0; i < 4; i++) {
+    ihdr[i] = static_cast<uint8_t>(c.width >> (24 - i * 8));
+    ihdr[4 + i] = static_cast<uint8_t>(c.height >> (24 - i * 8));
+  }
+  ihdr[8] = c.bitDepth;
+  ihdr[9] = c.colorType;
+  ihdr[12] = interlaced ? 1 : 0;
+  putChunk(&png, "IHDR", ihdr, sizeof(ihdr));
+  const char text[] = "Comment\0synthetic cover";
+  putChunk(&png, "tEXt", reinterpret_cast<const uint8_t*>(text), sizeof(text) - 1);
+  if (c.colorType == 3) {
+    putChunk(&png, "PLTE", image.palette.data(), image.palette.size());
+  }
+  if (c.transparency) {
+    if (c.colorType == 3) {
+      putChunk(&png, "tRNS", image.paletteAlpha.data(), image.paletteAlpha.size());
+    } else {
+      uint8_t key[6];
+      for (int i = 0; i < 3; i++) {
+        key[i * 2] = image.colorKey[i] >> 8;
+        key[i * 2 + 1] = image.colorKey[i] & 0xFF;
+      }
+      putChunk(&png, "tRNS", key, c.colorType == 0 ? 2 : 6);
+    }
+  }
+  const auto* data = static_cast<const uint8_t*>(compressed);
+  for (size_t offset = 0; offset < compressedSize; offset += kIdatChunkSize) {
+    putChunk(&png, "IDAT", data + offset, std::min(kIdatChunkSize, compressedSize - offset));
+    if (offset == 0) {
+      putChunk(&png, "IDAT", nullptr, 0);  // Empty chunks are allowed between data chunks
+    }
+  }
+  putChunk(&png, "IEND", nullptr, 0);
+  mz_free(compressed);
+  return png;
+}
+
+std::vector<uint8_t> referenceBmp(const Case& c, const Image& image, const int targetWidth, const int targetHeight,
+                                  const bool oneBit) {
+  int outWidth, outHeight;
+  ScaledBmpWriter::fitToTarget(c.width, c.height, targetWidth, targetHeight, &outWidth, &outHeight);
+  MemoryPrint out;
+  ScaledBmpWriter writer(out, oneBit);
+  if (!writer.begin(c.width, c.height, outWidth, outHeight)) {
+    return {};
+  }
+  for (int y = 0; y < c.height; y++) {
+    writer.writeRow(referenceGrayRow(c, image, y).data());
+  }
+  return out.data;
+}
+
+bool convert(const std::string& cardPath, const int targetWidth, const int targetHeight, const bool oneBit,
+             std::vector<uint8_t>* bmp, double* ms) {
+  FsFile file;
+  if (!SdMan.openFileForRead("BENCH", cardPath, file)) {
+    return false;
+  }
+  MemoryPrint out;
+  const auto start = Clock::now();
+  const bool ok = oneBit ? PngToBmpConverter::pngFileTo1BitBmpStreamWithSize(file, out, targetWidth, targetHeight)
+                         : PngToBmpConverter::pngFileToBmpStreamWithSize(file, out, targetWidth, targetHeight);
+  *ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  file.close();
+  bmp->swap(out.data);
+  return ok;
+}
+
+bool writeFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+  return static_cast<bool>(out);
+}
+
+bool benchmarkCase(const Case& c, const std::string& outDir) {
+  const Image image = makeImage(c);
+  const std::vector<uint8_t> png = encodePng(c, image);
+  const std::string cardPath = std::string("/") + c.name + ".png";
+  if (!writeFile(outDir + cardPath, png)) {
+    fprintf(stderr, "Failed to write %s\n", cardPath.c_str());
+    return false;
+  }
+
+  bool ok = true;
+  double coverMs = 0, thumbMs = 0;
+  std::vector<uint8_t> cover, thumb;
+  if (!convert(cardPath, kCoverWidth, kCoverHeight, false, &cover, &coverMs) ||
+      !convert(cardPath, kThumbWidth, kThumbHeight, true, &thumb, &thumbMs)) {
+    printf("%-16s FAILED: conversion returned false\n", c.name);
+    return false;
+  }
+  if (cover != referenceBmp(c, image, kCoverWidth, kCoverHeight, false)) {
+    printf("%-16s MISMATCH: 2-bit cover differs from the reference\n", c.name);
+    ok = false;
+  }
+  if (thumb != referenceBmp(c, image, kThumbWidth, kThumbHeight, true)) {
+    printf("%-16s MISMATCH: 1-bit thumbnail differs from the reference\n", c.name);
+    ok = false;
+  }
+  writeFile(outDir + "/" + c.name + "_cover.bmp", cover);
+  writeFile(outDir + "/" + c.name + "_thumb.bmp", thumb);
+  printf("%-16s %4dx%-4d %7.1f KB  cover %7.2f ms (%5.1f MB/s raw)  thumb %7.2f ms\n", c.name, c.width, c.height,
+         png.size() / 1024.0, coverMs,
+         static_cast<double>(c.width) * c.height * channelsOf(c.colorType) * c.bitDepth / 8 / 1e3 / coverMs, thumbMs);
+  return ok;
+}
+
+// Files the converter has to refuse without crashing
+bool checkRejects(const std::string& outDir) {
+  const Case small = {"reject", 64, 64, 0, 8};
+  const Image image = makeImage(small);
+  const std::vector<uint8_t> valid = encodePng(small, image);
+  const std::vector<std::pair<const char*, std::vector<uint8_t>>> files = {
+      {"interlaced", encodePng(small, image, true)},
+      {"truncated", std::vector<uint8_t>(valid.begin(), valid.begin() + static_cast<long>(valid.size() / 2))},
+      {"signature", std::vector<uint8_t>(valid.begin() + 1, valid.end())},
+  };
+
+  bool ok = true;
+  for (const auto& [name, data] : files) {
+    const std::string cardPath = std::string("/reject_") + name + ".png";
+    writeFile(outDir + cardPath, data);
+    std::vector<uint8_t> bmp;
+    double ms;
+    if (convert(cardPath, kCoverWidth, kCoverHeight, false, &bmp, &ms)) {
+      printf("reject %-9s FAILED: conversion should have been refused\n", name);
+      ok = false;
+    }
+  }
+  printf("reject cases %s\n", ok ? "ok" : "FAILED");
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string outDir = "build/png_convert_bench";
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: PngConvertBenchmark [--out DIR]\n");
+      return 2;
+    }
+  }
+  std::filesystem::create_directories(outDir);
+  SdMan.setRoot(outDir);
+
+  const std::vector<Case> cases = {
+      {"gray1", 1600, 2560, 0, 1},
+      {"gray2", 1600, 2560, 0, 2},
+      {"gray4", 1600, 2560, 0, 4},
+      {"gray8", 1600, 2560, 0, 8},
+      {"gray8_key", 1600, 2560, 0, 8, 0, true},
+      {"gray16", 1600, 2560, 0, 16},
+      {"gray8_large", 4000, 6000, 0, 8},
+      {"rgb8", 1600, 2560, 2, 8},
+      {"rgb8_key", 1600, 2560, 2, 8, 0, true},
+      {"rgb16", 1600, 2560, 2, 16},
+      {"palette1", 1600, 2560, 3, 1, 2},
+      {"palette4_trns", 1600, 2560, 3, 4, 16, true},
+      {"palette8", 1600, 2560, 3, 8, 256},
+      {"gray_alpha8", 1600, 2560, 4, 8},
+      {"gray_alpha16", 1600, 2560, 4, 16},
+      {"rgba8", 1600, 2560, 6, 8},
+      {"rgba16", 1600, 2560, 6, 16},
+  };
+
+  bool ok = true;
+  for (const Case& c : cases) {
+    ok &= benchmarkCase(c, outDir);
+  }
+  ok &= checkRejects(outDir);
+  return ok ? 0 : 1;
+}
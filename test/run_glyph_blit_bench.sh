@@ -0,0 +1,36 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/glyph_blit_bench"
+BINARY="$BUILD_DIR/GlyphBlitBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/glyph_blit_bench/GlyphBlitBenchmark.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GlyphAtlas.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFont.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdGlyphCache.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -pedantic
+  -include "$ROOT_DIR/test/host_stubs/Arduino.h"
+  -I"$ROOT_DIR/test/host_stubs"
+  -I"$ROOT_DIR"
+  -I"$ROOT_DIR/lib"
+  -I"$ROOT_DIR/lib/EpdFont"
+  -I"$ROOT_DIR/lib/Utf8"
+  -I"$ROOT_DIR/lib/miniz"
+)
+
+cc -O2 -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1 -w -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" "$BUILD_DIR/miniz.o" -o "$BINARY"
+
+"$BINARY" "$@"
@@ -0,0 +1,101 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Usage:
+#   test/run_host_render.sh [HostRender options] <book>   render a book to build/host_render/frames
+#   test/run_host_render.sh --check                       golden image check on the generated fixture books
+#   test/run_host_render.sh --update                      rewrite test/host_render/golden.txt
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/host_render"
+BINARY="$BUILD_DIR/HostRender"
+FIXTURE_DIR="$BUILD_DIR/fixtures"
+GOLDEN="$ROOT_DIR/test/host_render/golden.txt"
+
+mkdir -p "$BUILD_DIR/obj"
+
+CXX_SOURCES=(
+  "$ROOT_DIR/test/host_render/HostRender.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GfxRenderer.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/DirtyRegion.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/GlyphAtlas.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/Bitmap.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/ScaledBmpWriter.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFont.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdFontFamily.cpp"
+  "$ROOT_DIR/lib/EpdFont/EpdGlyphCache.cpp"
+  "$ROOT_DIR/lib/Utf8/Utf8.cpp"
+  "$ROOT_DIR/lib/FsHelpers/FsHelpers.cpp"
+  "$ROOT_DIR/lib/ZipFile/ZipFile.cpp"
+  "$ROOT_DIR/lib/JpegToBmpConverter/JpegToBmpConverter.cpp"
+  "$ROOT_DIR/lib/PngToBmpConverter/PngToBmpConverter.cpp"
+  "$ROOT_DIR/lib/Txt/Txt.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcParser.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcPageRenderer.cpp"
+  "$ROOT_DIR/lib/Epub/Epub.cpp"
+)
+while IFS= read -r source; do
+  CXX_SOURCES+=("$source")
+done < <(find "$ROOT_DIR/lib/Epub/Epub" -name '*.cpp' | sort)
+
+C_SOURCES=(
+  "$ROOT_DIR/lib/miniz/miniz.c"
+  "$ROOT_DIR/lib/picojpeg/picojpeg.c"
+  "$ROOT_DIR/lib/expat/xmlparse.c"
+  "$ROOT_DIR/lib/expat/xmlrole.c"
+  "$ROOT_DIR/lib/expat/xmltok.c"
+)
+
+INCLUDES=(
+  -I"$ROOT_DIR/test/host_stubs"
+  -I"$ROOT_DIR/lib/GfxRenderer"
+  -I"$ROOT_DIR/lib/EpdFont"
+  -I"$ROOT_DIR/lib/Utf8"
+  -I"$ROOT_DIR/lib/Serialization"
+  -I"$ROOT_DIR/lib/FsHelpers"
+  -I"$ROOT_DIR/lib/ZipFile"
+  -I"$ROOT_DIR/lib/JpegToBmpConverter"
+  -I"$ROOT_DIR/lib/PngToBmpConverter"
+  -I"$ROOT_DIR/lib/Txt"
+  -I"$ROOT_DIR/lib/Xtc"
+  -I"$ROOT_DIR/lib/Epub"
+  -I"$ROOT_DIR/lib/miniz"
+  -I"$ROOT_DIR/lib/picojpeg"
+  -I"$ROOT_DIR/lib/expat"
+)
+
+# Same miniz and expat configuration as platformio.ini
+DEFINES=(-DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1 -DXML_GE=0 -DXML_CONTEXT_BYTES=1024)
+
+CXXFLAGS=(-std=c++20 -O2 -Wall -Wextra -Wno-bidi-chars -include "$ROOT_DIR/test/host_stubs/Arduino.h" "${DEFINES[@]}" "${INCLUDES[@]}")
+CFLAGS=(-O2 -w "${DEFINES[@]}" "${INCLUDES[@]}")
+
+OBJECTS=()
+for source in "${C_SOURCES[@]}"; do
+  object="$BUILD_DIR/obj/$(basename "$source").o"
+  if [[ ! -f "$object" || "$source" -nt "$object" ]]; then
+    cc "${CFLAGS[@]}" -c "$source" -o "$object"
+  fi
+  OBJECTS+=("$object")
+done
+
+c++ "${CXXFLAGS[@]}" "${CXX_SOURCES[@]}" "${OBJECTS[@]}" -o "$BINARY"
+
+if [[ $# -eq 1 && ( "$1" == "--check" || "$1" == "--update" ) ]]; then
+  rm -rf "$FIXTURE_DIR"
+  python3 "$ROOT_DIR/test/host_render/make_fixtures.py" "$FIXTURE_DIR"
+  args=(--out "$BUILD_DIR/frames" --golden "$GOLDEN")
+  if [[ "$1" == "--update" ]]; then
+    args+=(--update)
+  fi
+  status=0
+  for book in sample.epub sample.txt sample.xtc sample.xtch; do
+    # Firmware logs go to stderr, keep only the results
+    "$BINARY" "${args[@]}" "$FIXTURE_DIR/$book" 2>/dev/null || status=1
+  done
+  exit $status
+fi
+
+"$BINARY" "$@"
@@ -0,0 +1,51 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/image_pipeline_bench"
+BINARY="$BUILD_DIR/ImagePipelineBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/image_pipeline_bench/ImagePipelineBenchmark.cpp"
+  "$ROOT_DIR/lib/JpegToBmpConverter/JpegToBmpConverter.cpp"
+  "$ROOT_DIR/lib/PngToBmpConverter/PngToBmpConverter.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/ScaledBmpWriter.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/BitmapHelpers.cpp"
+  "$ROOT_DIR/lib/GfxRenderer/Bitmap.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcParser.cpp"
+  "$ROOT_DIR/lib/FsHelpers/FsHelpers.cpp"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -include "$ROOT_DIR/test/host_stubs/Arduino.h"
+  -I"$ROOT_DIR/test/host_stubs"
+  -I"$ROOT_DIR/lib/GfxRenderer"
+  -I"$ROOT_DIR/lib/JpegToBmpConverter"
+  -I"$ROOT_DIR/lib/PngToBmpConverter"
+  -I"$ROOT_DIR/lib/Xtc"
+  -I"$ROOT_DIR/lib/FsHelpers"
+  -I"$ROOT_DIR/lib/picojpeg"
+  -I"$ROOT_DIR/lib/miniz"
+)
+
+# Heap peaks are counted by wrapping the allocator for everything linked into the benchmark
+LDFLAGS=(
+  -Wl,--wrap=malloc
+  -Wl,--wrap=calloc
+  -Wl,--wrap=realloc
+  -Wl,--wrap=free
+)
+
+cc -O2 -w -c "$ROOT_DIR/lib/picojpeg/picojpeg.c" -o "$BUILD_DIR/picojpeg.o"
+cc -O2 -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1 -w -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" "$BUILD_DIR/picojpeg.o" "$BUILD_DIR/miniz.o" "${LDFLAGS[@]}" -o "$BINARY"
+
+cd "$ROOT_DIR"
+"$BINARY" "$@"
@@ -0,0 +1,57 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Usage:
+#   test/run_xtc_compress.sh [XtcCompress options] <input.xtc> <output.xtc>   compress a book
+#   test/run_xtc_compress.sh --check   compress the host render fixture books with every method and check that the
+#                                      reader draws them exactly like the uncompressed ones
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/xtc_compress"
+BINARY="$BUILD_DIR/XtcCompress"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/xtc_compress/XtcCompress.cpp"
+  "$ROOT_DIR/lib/Xtc/Xtc/XtcParser.cpp"
+  "$ROOT_DIR/lib/FsHelpers/FsHelpers.cpp"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1
+  -include "$ROOT_DIR/test/host_stubs/Arduino.h"
+  -I"$ROOT_DIR/test/host_stubs"
+  -I"$ROOT_DIR/lib/Xtc"
+  -I"$ROOT_DIR/lib/FsHelpers"
+  -I"$ROOT_DIR/lib/miniz"
+)
+
+cc -O2 -DMINIZ_NO_ZLIB_COMPATIBLE_NAMES=1 -w -c "$ROOT_DIR/lib/miniz/miniz.c" -o "$BUILD_DIR/miniz.o"
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" "$BUILD_DIR/miniz.o" -o "$BINARY"
+
+if [[ $# -eq 1 && "$1" == "--check" ]]; then
+  FIXTURE_DIR="$BUILD_DIR/fixtures"
+  rm -rf "$FIXTURE_DIR"
+  python3 "$ROOT_DIR/test/host_render/make_fixtures.py" "$FIXTURE_DIR"
+  # The first render builds HostRender, the rest reuse the binary
+  render=("$ROOT_DIR/test/run_host_render.sh")
+  for method in packbits deflate best; do
+    mkdir -p "$FIXTURE_DIR/$method"
+    for book in sample.xtc sample.xtch; do
+      # Parser logs go to stderr, keep only the results
+      "$BINARY" --method "$method" "$FIXTURE_DIR/$book" "$FIXTURE_DIR/$method/$book" 2>/dev/null
+      # Same file name as the uncompressed fixture, so the frames are checked against its golden hashes
+      "${render[@]}" --out "$BUILD_DIR/frames" --golden "$ROOT_DIR/test/host_render/golden.txt" \
+        "$FIXTURE_DIR/$method/$book" 2>/dev/null
+      render=("$ROOT_DIR/build/host_render/HostRender")
+    done
+  done
+  exit 0
+fi
+
+"$BINARY" "$@"
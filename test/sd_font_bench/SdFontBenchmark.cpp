@@ -0,0 +1,279 @@
+#include <EpdFontFamily.h>
+#include <EpdGlyphCache.h>
+#include <EpdSdFont.h>
+#include <GfxRenderer.h>
+#include <SDCardManager.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/notosans_14_regular.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Host benchmark for fonts loaded from the SD card: writes built-in fonts into the binary container
+// (fontconvert.py --binary layout), loads them back through EpdSdFont and renders the same pages with both. Checks the
+// frames are identical and reports render time per page plus page cache misses, the SD reads a page costs on device.
+//
+// Text is drawn by frequency from the books behind the hyphenation test data, or paged from --text FILE.
+
+namespace {
+
+constexpr int kBuiltinFontId = 1;
+constexpr int kSdFontId = 2;
+constexpr int kPages = 100;
+constexpr int kWordsPerPage = 400;  // More than fits, pages stop at the bottom margin
+constexpr int kMargin = 20;
+constexpr size_t kDefaultPageSize = 1024;
+
+using Clock = std::chrono::steady_clock;
+
+void put16(std::vector<uint8_t>* out, const uint16_t value) {
+  out->push_back(value & 0xFF);
+  out->push_back(value >> 8);
+}
+
+void put32(std::vector<uint8_t>* out, const uint32_t value) {
+  put16(out, value & 0xFFFF);
+  put16(out, value >> 16);
+}
+
+// Mirrors write_binary_container in fontconvert.py
+bool writeContainer(const EpdFontData& font, const size_t requestedPageSize, const std::string& path) {
+  const EpdUnicodeInterval& lastInterval = font.intervals[font.intervalCount - 1];
+  const uint32_t glyphCount = lastInterval.offset + (lastInterval.last - lastInterval.first + 1);
+
+  size_t pageSize = requestedPageSize;
+  for (uint32_t i = 0; i < glyphCount; i++) {
+    pageSize = std::max<size_t>(pageSize, font.glyph[i].dataLength);
+  }
+
+  std::vector<uint8_t> bitmaps;
+  std::vector<uint8_t> glyphs;
+  for (uint32_t i = 0; i < glyphCount; i++) {
+    const EpdGlyph& glyph = font.glyph[i];
+    const size_t length = std::max<size_t>(glyph.dataLength, 1);
+    if (bitmaps.size() / pageSize != (bitmaps.size() + length - 1) / pageSize) {
+      bitmaps.resize(bitmaps.size() + pageSize - bitmaps.size() % pageSize, 0);
+    }
+    glyphs.push_back(glyph.width);
+    glyphs.push_back(glyph.height);
+    glyphs.push_back(glyph.advanceX);
+    glyphs.push_back(0);
+    put16(&glyphs, static_cast<uint16_t>(glyph.left));
+    put16(&glyphs, static_cast<uint16_t>(glyph.top));
+    put16(&glyphs, glyph.dataLength);
+    put16(&glyphs, 0);
+    put32(&glyphs, static_cast<uint32_t>(bitmaps.size()));
+    bitmaps.insert(bitmaps.end(), &font.bitmap[glyph.dataOffset], &font.bitmap[glyph.dataOffset] + glyph.dataLength);
+  }
+  if (bitmaps.empty() || bitmaps.size() % pageSize != 0) {
+    bitmaps.resize(bitmaps.size() + pageSize - bitmaps.size() % pageSize, 0);
+  }
+
+  std::vector<uint8_t> intervals;
+  for (uint32_t i = 0; i < font.intervalCount; i++) {
+    put32(&intervals, font.intervals[i].first);
+    put32(&intervals, font.intervals[i].last);
+    put32(&intervals, font.intervals[i].offset);
+  }
+
+  std::vector<uint8_t> header = {'E', 'P', 'D', 'F', EpdSdFont::VERSION, font.is2Bit ? uint8_t{1} : uint8_t{0},
+                                 font.advanceY, 0};
+  put16(&header, static_cast<uint16_t>(font.ascender));
+  put16(&header, static_cast<uint16_t>(font.descender));
+  put32(&header, font.intervalCount);
+  put32(&header, glyphCount);
+  put32(&header, static_cast<uint32_t>(pageSize));
+  put32(&header, static_cast<uint32_t>(bitmaps.size() / pageSize));
+  put32(&header, static_cast<uint32_t>(EpdSdFont::HEADER_SIZE + intervals.size() + glyphs.size()));
+
+  std::ofstream out(path, std::ios::binary);
+  for (const auto* part : {&header, &intervals, &glyphs, &bitmaps}) {
+    out.write(reinterpret_cast<const char*>(part->data()), static_cast<std::streamsize>(part->size()));
+  }
+  return out.good();
+}
+
+// Hyphenation test data lines are "word|hyphenated|frequency"
+std::vector<std::string> wordListText(const std::string& path) {
+  std::ifstream in(path);
+  std::vector<std::string> words;
+  std::vector<uint64_t> cumulative;
+  uint64_t total = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t first = line.find('|');
+    const size_t second = line.rfind('|');
+    if (line.empty() || line[0] == '#' || first == std::string::npos || second == first) {
+      continue;
+    }
+    total += std::stoul(line.substr(second + 1));
+    words.push_back(line.substr(0, first));
+    cumulative.push_back(total);
+  }
+
+  std::vector<std::string> text;
+  uint64_t state = 0x9E3779B97F4A7C15ull;
+  for (int i = 0; total > 0 && i < kPages * kWordsPerPage; i++) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    const uint64_t pick = (state >> 33) % total;
+    text.push_back(words[std::upper_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin()]);
+  }
+  return text;
+}
+
+std::vector<std::string> textFileWords(const std::string& path) {
+  std::ifstream in(path);
+  std::vector<std::string> text;
+  std::string word;
+  while (in >> word) {
+    text.push_back(word);
+  }
+  return text;
+}
+
+// Greedy layout with drawText per word, returns the number of words placed
+size_t renderPage(const GfxRenderer& renderer, const int fontId, const std::vector<std::string>& words,
+                  const size_t first) {
+  const int lineHeight = renderer.getLineHeight(fontId);
+  const int spaceWidth = renderer.getSpaceWidth(fontId);
+  const int right = renderer.getScreenWidth() - kMargin;
+  int x = kMargin;
+  int y = kMargin;
+  size_t index = first;
+  while (index < words.size()) {
+    const int width = renderer.getTextWidth(fontId, words[index].c_str());
+    if (x > kMargin && x + width > right) {
+      x = kMargin;
+      y += lineHeight;
+    }
+    if (y + lineHeight > renderer.getScreenHeight() - kMargin) {
+      break;
+    }
+    renderer.drawText(fontId, x, y, words[index].c_str());
+    x += width + spaceWidth;
+    index++;
+  }
+  return index - first;
+}
+
+uint64_t frameHash(const GfxRenderer& renderer) {
+  uint64_t hash = 1469598103934665603ull;
+  const uint8_t* frame = renderer.getFrameBuffer();
+  for (size_t i = 0; i < GfxRenderer::getBufferSize(); i++) {
+    hash = (hash ^ frame[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Renders up to kPages pages, returns ms per page and the frame hashes
+double renderPages(const GfxRenderer& renderer, const int fontId, const std::vector<std::string>& words,
+                   std::vector<uint64_t>* hashes, int* pages) {
+  double totalMs = 0;
+  size_t next = 0;
+  *pages = 0;
+  hashes->clear();
+  while (next < words.size() && *pages < kPages) {
+    renderer.clearScreen();
+    const auto start = Clock::now();
+    const size_t placed = renderPage(renderer, fontId, words, next);
+    totalMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    if (placed == 0) {
+      break;
+    }
+    next += placed;
+    hashes->push_back(frameHash(renderer));
+    (*pages)++;
+  }
+  return *pages ? totalMs / *pages : 0;
+}
+
+bool benchmarkFont(const char* name, const EpdFontData& builtin, const std::string& dir, const size_t pageSize,
+                   const std::vector<std::pair<std::string, std::vector<std::string>>>& texts) {
+  const std::string fileName = std::string(name) + ".epdfont";
+  if (!writeContainer(builtin, pageSize, dir + "/" + fileName)) {
+    fprintf(stderr, "Failed to write %s\n", fileName.c_str());
+    return false;
+  }
+
+  bool ok = true;
+  for (const auto& [textName, words] : texts) {
+    if (words.empty()) {
+      continue;
+    }
+    // Fresh font per text so the page cache starts cold like after boot
+    EpdSdFont sdFont;
+    if (!sdFont.load("/" + fileName)) {
+      return false;
+    }
+    EpdFont builtinFont(&builtin);
+    EpdFont sdReaderFont(sdFont.getData(), &sdFont);
+    EInkDisplay display;
+    GfxRenderer renderer(display);
+    renderer.insertFont(kBuiltinFontId, EpdFontFamily(&builtinFont));
+    renderer.insertFont(kSdFontId, EpdFontFamily(&sdReaderFont));
+
+    std::vector<uint64_t> builtinHashes, sdHashes;
+    int builtinPages, sdPages;
+    const double builtinMs = renderPages(renderer, kBuiltinFontId, words, &builtinHashes, &builtinPages);
+    const double sdMs = renderPages(renderer, kSdFontId, words, &sdHashes, &sdPages);
+    const EpdGlyphCache* cache = sdFont.getPageCache();
+    const double lookups = cache->hits + cache->misses;
+    printf("%s %-8s %3d pages  built-in %6.3f ms/page  sd %6.3f ms/page (%+5.1f%%)  "
+           "hit rate %5.1f%%  %5.2f reads/page\n",
+           name, textName.c_str(), sdPages, builtinMs, sdMs, 100.0 * (sdMs - builtinMs) / builtinMs,
+           100.0 * cache->hits / lookups, static_cast<double>(cache->misses) / sdPages);
+    if (builtinHashes != sdHashes) {
+      printf("%s %-8s MISMATCH: SD font frames differ from the built-in font\n", name, textName.c_str());
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string resources = "test/hyphenation_eval/resources";
+  std::string textPath;
+  std::string outDir = "build/sd_font_bench";
+  size_t pageSize = kDefaultPageSize;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--text" && i + 1 < argc) {
+      textPath = argv[++i];
+    } else if (arg == "--resources" && i + 1 < argc) {
+      resources = argv[++i];
+    } else if (arg == "--page-size" && i + 1 < argc) {
+      pageSize = std::stoul(argv[++i]);
+    } else if (arg == "--out" && i + 1 < argc) {
+      outDir = argv[++i];
+    } else {
+      fprintf(stderr, "Usage: SdFontBenchmark [--text FILE] [--resources DIR] [--page-size BYTES] [--out DIR]\n");
+      return 2;
+    }
+  }
+
+  std::filesystem::create_directories(outDir);
+  SdMan.setRoot(outDir);
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> texts;
+  if (!textPath.empty()) {
+    texts.emplace_back("text", textFileWords(textPath));
+  } else {
+    for (const char* language : {"english", "russian"}) {
+      texts.emplace_back(language, wordListText(resources + "/" + language + "_hyphenation_tests.txt"));
+    }
+  }
+
+  printf("page cache %zu bytes, %zu byte pages\n", EpdSdFont::PAGE_CACHE_BYTES, pageSize);
+  bool ok = true;
+  ok &= benchmarkFont("bookerly_14_regular", bookerly_14_regular, outDir, pageSize, texts);
+  ok &= benchmarkFont("notosans_14_regular", notosans_14_regular, outDir, pageSize, texts);
+  return ok ? 0 : 1;
+}
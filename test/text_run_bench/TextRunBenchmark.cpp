@@ -0,0 +1,187 @@
+#include <EpdFontFamily.h>
+#include <GfxRenderer.h>
+#include <builtinFonts/bookerly_14_bold.h>
+#include <builtinFonts/bookerly_14_bolditalic.h>
+#include <builtinFonts/bookerly_14_italic.h>
+#include <builtinFonts/bookerly_14_regular.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Host micro-benchmark for GfxRenderer::drawRun: renders the same page once with a drawText call per word (the old
+// TextBlock::render path) and once with a drawRun per line, checks both produce the same framebuffer and reports
+// words per millisecond. Words of characters missing from the font are checked the same way.
+
+namespace {
+
+constexpr int kFontId = 1;
+constexpr int kIterations = 200;
+
+const char* kSampleText =
+    "It is a truth universally acknowledged, that a single man in possession of a good fortune, must be in want of a "
+    "wife. However little known the feelings or views of such a man may be on his first entering a neighbourhood, "
+    "this truth is so well fixed in the minds of the surrounding families, that he is considered the rightful "
+    "property of some one or other of their daughters. \"My dear Mr. Bennet,\" said his lady to him one day, \"have "
+    "you heard that Netherfield Park is let at last?\" Mr. Bennet replied that he had not.";
+
+struct Word {
+  std::string text;
+  int x;
+  EpdFontFamily::Style style;
+};
+
+struct Line {
+  int y;
+  std::vector<Word> words;
+};
+
+std::vector<Line> layoutPage(const GfxRenderer& renderer) {
+  constexpr int margin = 20;
+  const int lineHeight = renderer.getLineHeight(kFontId);
+  const int spaceWidth = renderer.getSpaceWidth(kFontId);
+  const int right = renderer.getScreenWidth() - margin;
+
+  std::vector<std::string> tokens;
+  const char* start = kSampleText;
+  while (*start) {
+    const char* end = strchr(start, ' ');
+    if (!end) end = start + strlen(start);
+    tokens.emplace_back(start, end);
+    start = *end ? end + 1 : end;
+  }
+
+  std::vector<Line> lines;
+  int y = margin;
+  int x = margin;
+  size_t tokenIndex = 0;
+  lines.push_back({y, {}});
+  while (y + lineHeight < renderer.getScreenHeight() - margin) {
+    const std::string& token = tokens[tokenIndex % tokens.size()];
+    // Mix in the other styles so the run has to switch fonts mid-line
+    const auto style = static_cast<EpdFontFamily::Style>(tokenIndex % 7 == 3 ? tokenIndex % 4 : 0);
+    tokenIndex++;
+
+    const int width = renderer.getTextWidth(kFontId, token.c_str(), style);
+    if (x + width > right) {
+      x = margin;
+      y += lineHeight;
+      lines.push_back({y, {}});
+    }
+    lines.back().words.push_back({token, x, style});
+    x += width + spaceWidth;
+  }
+  lines.pop_back();
+  return lines;
+}
+
+template <typename Fn>
+double timeIterations(Fn&& fn) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; i++) {
+    fn();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main() {
+  EpdFont regular(&bookerly_14_regular);
+  EpdFont bold(&bookerly_14_bold);
+  EpdFont italic(&bookerly_14_italic);
+  EpdFont boldItalic(&bookerly_14_bolditalic);
+
+  EInkDisplay display;
+  GfxRenderer renderer(display);
+  renderer.insertFont(kFontId, EpdFontFamily(&regular, &bold, &italic, &boldItalic));
+
+  const auto lines = layoutPage(renderer);
+  size_t wordCount = 0;
+  for (const auto& line : lines) {
+    wordCount += line.words.size();
+  }
+
+  std::vector<GfxRenderer::TextRunItem> items;
+  auto renderPerWord = [&] {
+    for (const auto& line : lines) {
+      for (const auto& word : line.words) {
+        renderer.drawText(kFontId, word.x, line.y, word.text.c_str(), true, word.style);
+      }
+    }
+  };
+  auto renderRuns = [&] {
+    const EpdFontFamily* font = renderer.getFontFamily(kFontId);
+    for (const auto& line : lines) {
+      items.clear();
+      for (const auto& word : line.words) {
+        items.push_back({word.x, word.text.c_str(), word.style});
+      }
+      renderer.drawRun(*font, line.y, items.data(), items.size());
+    }
+  };
+
+  const double perWordMs = timeIterations([&] {
+    renderer.clearScreen();
+    renderPerWord();
+  });
+  const uint8_t* frameBuffer = renderer.getFrameBuffer();
+  std::vector<uint8_t> perWordFrame(frameBuffer, frameBuffer + GfxRenderer::getBufferSize());
+
+  const double runMs = timeIterations([&] {
+    renderer.clearScreen();
+    renderRuns();
+  });
+  const bool match = memcmp(perWordFrame.data(), renderer.getFrameBuffer(), GfxRenderer::getBufferSize()) == 0;
+
+  // Words made only of characters the font lacks show replacement glyphs, whether drawRun resolves the word up front
+  // or streams it for being longer than it resolves
+  const std::string missingGlyph = "\u4E2D";
+  std::string missingShort;
+  std::string missingLong;
+  for (int i = 0; i < 2; i++) missingShort += missingGlyph;
+  for (int i = 0; i < 40; i++) missingLong += missingGlyph;
+  bool missingMatch = true;
+  for (const std::string* word : {&missingShort, &missingLong}) {
+    renderer.clearScreen();
+    renderer.drawText(kFontId, 20, 20, word->c_str());
+    const std::vector<uint8_t> expected(frameBuffer, frameBuffer + GfxRenderer::getBufferSize());
+    renderer.clearScreen();
+    const GfxRenderer::TextRunItem item = {20, word->c_str(), EpdFontFamily::REGULAR};
+    renderer.drawRun(*renderer.getFontFamily(kFontId), 20, &item, 1);
+    const bool drawn = std::any_of(expected.begin(), expected.end(), [](const uint8_t byte) { return byte != 0xFF; });
+    missingMatch = missingMatch && drawn && memcmp(expected.data(), frameBuffer, expected.size()) == 0;
+  }
+
+  // Truncation keeps the longest prefix that fits, but never drops below the caller's minimum length
+  const char* longTitle = "A very long chapter title";
+  const int fittedWidth = renderer.getTextWidth(kFontId, "A very long...");
+  const bool truncationMatch = renderer.truncatedText(kFontId, "Chapter", 1) == "Chapter" &&
+                               renderer.truncatedText(kFontId, longTitle, 1) == "A ver..." &&
+                               renderer.truncatedText(kFontId, longTitle, 1, EpdFontFamily::REGULAR, nullptr, 11) ==
+                                   "A very l..." &&
+                               renderer.truncatedText(kFontId, longTitle, fittedWidth) == "A very long...";
+
+  const double words = static_cast<double>(wordCount) * kIterations;
+  std::cout << lines.size() << " lines, " << wordCount << " words per page" << std::endl;
+  std::cout << "drawText per word: " << words / perWordMs << " words/ms" << std::endl;
+  std::cout << "drawRun per line:  " << words / runMs << " words/ms" << std::endl;
+
+  if (!match) {
+    std::cerr << "drawRun output differs from drawText" << std::endl;
+    return 1;
+  }
+  if (!missingMatch) {
+    std::cerr << "words without glyphs in the font are not drawn with the replacement glyph" << std::endl;
+    return 1;
+  }
+  if (!truncationMatch) {
+    std::cerr << "truncatedText does not keep the minimum length or the longest fitting prefix" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,330 @@
+#include <SDCardManager.h>
+#include <Xtc/XtcParser.h>
+#include <miniz.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Host tool that rewrites an XTC/XTCH book with compressed page payloads, using the XtgPageHeader compression field:
+// PackBits, raw deflate for the firmware's tinfl, or per page whichever of them is smallest.
+//
+// Pages are read through XtcParser, so the input may itself be compressed. Everything in front of the first page
+// (header, title, chapters, page table) is copied as is with the page table updated; the page table has to sit in front
+// of the page data, which is where generators put it. Afterwards every page of the output is read back with loadPage
+// and, unless it is deflated, loadPageStreaming and compared against the input, and the load times of both books are
+// reported.
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string method = "best";
+  int level = 9;
+  std::string input;
+  std::string output;
+};
+
+// Header byte n, then n+1 literal bytes (n < 128) or one byte repeated 257-n times (n > 128)
+std::vector<uint8_t> packBits(const uint8_t* data, const size_t size) {
+  std::vector<uint8_t> out;
+  size_t i = 0;
+  while (i < size) {
+    size_t run = 1;
+    while (i + run < size && run < 128 && data[i + run] == data[i]) {
+      run++;
+    }
+    if (run >= 2) {
+      out.push_back(static_cast<uint8_t>(257 - run));
+      out.push_back(data[i]);
+      i += run;
+      continue;
+    }
+
+    // Literals up to the next run of three or more, which is cheaper as a repeat
+    const size_t start = i;
+    while (i < size && i - start < 128) {
+      if (i + 2 < size && data[i] == data[i + 1] && data[i] == data[i + 2]) {
+        break;
+      }
+      i++;
+    }
+    out.push_back(static_cast<uint8_t>(i - start - 1));
+    out.insert(out.end(), data + start, data + i);
+  }
+  return out;
+}
+
+std::vector<uint8_t> deflate(const uint8_t* data, const size_t size, const int level) {
+  // Negative window bits: raw deflate without the zlib header, as the firmware inflates it
+  const int flags = static_cast<int>(tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, 0));
+  size_t outSize = 0;
+  void* compressed = tdefl_compress_mem_to_heap(data, size, &outSize, flags);
+  if (!compressed) {
+    return {};
+  }
+  std::vector<uint8_t> out(static_cast<uint8_t*>(compressed), static_cast<uint8_t*>(compressed) + outSize);
+  mz_free(compressed);
+  return out;
+}
+
+// Picks the payload for one page; compression is set to the method used
+std::vector<uint8_t> compressPage(const std::vector<uint8_t>& bitmap, const Options& options, uint8_t& compression) {
+  std::vector<uint8_t> best = bitmap;
+  compression = xtc::XTG_COMPRESSION_NONE;
+  if (options.method == "packbits" || options.method == "best") {
+    auto packed = packBits(bitmap.data(), bitmap.size());
+    if (options.method == "packbits" || packed.size() < best.size()) {
+      best = std::move(packed);
+      compression = xtc::XTG_COMPRESSION_PACKBITS;
+    }
+  }
+  if (options.method == "deflate" || options.method == "best") {
+    auto deflated = deflate(bitmap.data(), bitmap.size(), options.level);
+    if (!deflated.empty() && (options.method == "deflate" || deflated.size() < best.size())) {
+      best = std::move(deflated);
+      compression = xtc::XTG_COMPRESSION_DEFLATE;
+    }
+  }
+  return best;
+}
+
+const char* compressionName(const uint8_t compression) {
+  switch (compression) {
+    case xtc::XTG_COMPRESSION_NONE:
+      return "none";
+    case xtc::XTG_COMPRESSION_PACKBITS:
+      return "packbits";
+    case xtc::XTG_COMPRESSION_DEFLATE:
+      return "deflate";
+    default:
+      return "?";
+  }
+}
+
+size_t bufferSizeFor(const xtc::XtcParser& parser) {
+  const size_t width = parser.getWidth();
+  const size_t height = parser.getHeight();
+  return parser.getBitDepth() == 2 ? ((width * height + 7) / 8) * 2 : ((width + 7) / 8) * height;
+}
+
+// Loads every page of an open book, returns the mean milliseconds per page or a negative value on a failed load
+double timePageLoads(xtc::XtcParser& parser, std::vector<uint8_t>& buffer) {
+  const auto start = Clock::now();
+  for (uint32_t page = 0; page < parser.getPageCount(); page++) {
+    if (parser.loadPage(page, buffer.data(), buffer.size()) == 0) {
+      return -1;
+    }
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / parser.getPageCount();
+}
+
+// pageCompression holds the method each page of the output was stored with
+bool verify(const std::string& inputPath, const std::string& outputPath, const std::vector<uint8_t>& pageCompression) {
+  xtc::XtcParser original;
+  xtc::XtcParser rewritten;
+  if (original.open(inputPath.c_str()) != xtc::XtcError::OK ||
+      rewritten.open(outputPath.c_str()) != xtc::XtcError::OK) {
+    fprintf(stderr, "Could not open the books for verification\n");
+    return false;
+  }
+  if (rewritten.getPageCount() != original.getPageCount() || rewritten.getBitDepth() != original.getBitDepth()) {
+    fprintf(stderr, "Page count or bit depth changed\n");
+    return false;
+  }
+
+  const size_t bufferSize = bufferSizeFor(original);
+  std::vector<uint8_t> expected(bufferSize);
+  std::vector<uint8_t> loaded(bufferSize);
+  std::vector<uint8_t> streamed(bufferSize);
+  for (uint32_t page = 0; page < original.getPageCount(); page++) {
+    const size_t size = original.loadPage(page, expected.data(), bufferSize);
+    if (size == 0 || rewritten.loadPage(page, loaded.data(), bufferSize) != size ||
+        memcmp(expected.data(), loaded.data(), size) != 0) {
+      fprintf(stderr, "Page %u differs after loadPage (%s)\n", page, xtc::errorToString(rewritten.getLastError()));
+      return false;
+    }
+
+    // Asked between chunks, the reader's prefetch uses this to give up on a page the user has turned away from
+    std::fill(loaded.begin(), loaded.end(), 0);
+    if (rewritten.loadPage(page, loaded.data(), bufferSize, [] { return true; }) != size ||
+        memcmp(expected.data(), loaded.data(), size) != 0) {
+      fprintf(stderr, "Page %u differs after a stoppable loadPage\n", page);
+      return false;
+    }
+    // A page held in one chunk has nothing left to stop, anything longer has to report the cancel
+    if (rewritten.loadPage(page, loaded.data(), bufferSize, [] { return false; }) == 0
+            ? rewritten.getLastError() != xtc::XtcError::CANCELLED
+            : memcmp(expected.data(), loaded.data(), size) != 0) {
+      fprintf(stderr, "Page %u was not stopped cleanly (%s)\n", page, xtc::errorToString(rewritten.getLastError()));
+      return false;
+    }
+
+    // Streaming can't serve deflate back-references, those pages have to be refused without output
+    const bool deflated = pageCompression[page] == xtc::XTG_COMPRESSION_DEFLATE;
+    std::fill(streamed.begin(), streamed.end(), 0);
+    size_t streamedBytes = 0;
+    bool inOrder = true;
+    const xtc::XtcError err = rewritten.loadPageStreaming(
+        page,
+        [&](const uint8_t* data, const size_t chunkSize, const size_t offset) {
+          if (offset != streamedBytes || offset + chunkSize > size) {
+            inOrder = false;
+            return;
+          }
+          memcpy(streamed.data() + offset, data, chunkSize);
+          streamedBytes += chunkSize;
+        },
+        1024);
+    if (deflated ? err != xtc::XtcError::DECOMPRESSION_ERROR || streamedBytes != 0
+                 : err != xtc::XtcError::OK || !inOrder || streamedBytes != size ||
+                       memcmp(expected.data(), streamed.data(), size) != 0) {
+      fprintf(stderr, "Page %u differs after loadPageStreaming (%s)\n", page, xtc::errorToString(err));
+      return false;
+    }
+  }
+
+  const double originalMs = timePageLoads(original, loaded);
+  const double rewrittenMs = timePageLoads(rewritten, loaded);
+  printf("Verified %u pages, loadPage %.3f ms/page before, %.3f ms/page after\n", original.getPageCount(), originalMs,
+         rewrittenMs);
+  return originalMs >= 0 && rewrittenMs >= 0;
+}
+
+bool compressBook(const Options& options) {
+  std::ifstream in(options.input, std::ios::binary);
+  const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (file.size() < sizeof(xtc::XtcHeader)) {
+    fprintf(stderr, "%s is too small for an XTC book\n", options.input.c_str());
+    return false;
+  }
+  xtc::XtcHeader header;
+  memcpy(&header, file.data(), sizeof(header));
+
+  xtc::XtcParser parser;
+  if (parser.open(options.input.c_str()) != xtc::XtcError::OK) {
+    fprintf(stderr, "Could not open %s: %s\n", options.input.c_str(), xtc::errorToString(parser.getLastError()));
+    return false;
+  }
+
+  const uint64_t tableSize = static_cast<uint64_t>(header.pageCount) * sizeof(xtc::PageTableEntry);
+  const uint64_t tableEnd = header.pageTableOffset + tableSize;
+  std::vector<xtc::PageTableEntry> table(header.pageCount);
+  if (tableEnd > file.size()) {
+    fprintf(stderr, "Page table runs past the end of the file\n");
+    return false;
+  }
+  memcpy(table.data(), file.data() + header.pageTableOffset, tableEnd - header.pageTableOffset);
+
+  uint64_t dataStart = file.size();
+  uint64_t dataEnd = 0;
+  for (const auto& entry : table) {
+    dataStart = std::min(dataStart, entry.dataOffset);
+    dataEnd = std::max(dataEnd, entry.dataOffset + entry.dataSize);
+  }
+  if (tableEnd > dataStart) {
+    fprintf(stderr, "Page table after the page data is not supported\n");
+    return false;
+  }
+  if (dataEnd < file.size()) {
+    fprintf(stderr, "Warning: %llu bytes after the last page are dropped\n",
+            static_cast<unsigned long long>(file.size() - dataEnd));
+  }
+
+  std::vector<uint8_t> out(file.begin(), file.begin() + static_cast<long>(dataStart));
+  std::vector<uint8_t> bitmap(bufferSizeFor(parser));
+  size_t rawTotal = 0;
+  size_t storedTotal = 0;
+  int methodCounts[3] = {};
+  std::vector<uint8_t> pageCompression;
+  for (uint32_t page = 0; page < header.pageCount; page++) {
+    const size_t size = parser.loadPage(page, bitmap.data(), bitmap.size());
+    if (size == 0) {
+      fprintf(stderr, "Could not load page %u: %s\n", page, xtc::errorToString(parser.getLastError()));
+      return false;
+    }
+
+    xtc::XtgPageHeader pageHeader;
+    memcpy(&pageHeader, file.data() + table[page].dataOffset, sizeof(pageHeader));
+    const std::vector<uint8_t> raw(bitmap.begin(), bitmap.begin() + static_cast<long>(size));
+    const std::vector<uint8_t> payload = compressPage(raw, options, pageHeader.compression);
+    pageHeader.dataSize = static_cast<uint32_t>(payload.size());
+    methodCounts[pageHeader.compression]++;
+    pageCompression.push_back(pageHeader.compression);
+    rawTotal += size;
+    storedTotal += payload.size();
+
+    table[page].dataOffset = out.size();
+    table[page].dataSize = static_cast<uint32_t>(sizeof(pageHeader) + payload.size());
+    const auto* headerBytes = reinterpret_cast<const uint8_t*>(&pageHeader);
+    out.insert(out.end(), headerBytes, headerBytes + sizeof(pageHeader));
+    out.insert(out.end(), payload.begin(), payload.end());
+  }
+  parser.close();
+  memcpy(out.data() + header.pageTableOffset, table.data(), tableEnd - header.pageTableOffset);
+
+  std::ofstream outFile(options.output, std::ios::binary);
+  outFile.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+  if (!outFile) {
+    fprintf(stderr, "Could not write %s\n", options.output.c_str());
+    return false;
+  }
+  outFile.close();
+
+  printf("%s: %u pages, page data %zu -> %zu bytes (%.1f%%), file %zu -> %zu bytes\n", options.output.c_str(),
+         header.pageCount, rawTotal, storedTotal, 100.0 * storedTotal / rawTotal, file.size(), out.size());
+  printf("Pages by method: %s %d, %s %d, %s %d\n", compressionName(0), methodCounts[0], compressionName(1),
+         methodCounts[1], compressionName(2), methodCounts[2]);
+  return verify(options.input, options.output, pageCompression);
+}
+
+void usage() {
+  fprintf(stderr,
+          "Usage: XtcCompress [options] <input.xtc> <output.xtc>\n"
+          "  --method M   none, packbits, deflate or best (smallest per page, default)\n"
+          "  --level N    deflate level 0-10 (default 9)\n");
+}
+
+bool parseArgs(const int argc, char** argv, Options* options) {
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--method" && hasValue) {
+      options->method = argv[++i];
+      if (options->method != "none" && options->method != "packbits" && options->method != "deflate" &&
+          options->method != "best") {
+        return false;
+      }
+    } else if (arg == "--level" && hasValue) {
+      options->level = std::clamp(std::atoi(argv[++i]), 0, 10);
+    } else if (arg.rfind("--", 0) == 0) {
+      return false;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.size() != 2) {
+    return false;
+  }
+  // Card paths are host paths with the SD card stand-in rooted at /
+  options->input = std::filesystem::absolute(paths[0]).string();
+  options->output = std::filesystem::absolute(paths[1]).string();
+  return true;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parseArgs(argc, argv, &options)) {
+    usage();
+    return 2;
+  }
+  SdMan.setRoot("");
+  return compressBook(options) ? 0 : 1;
+}